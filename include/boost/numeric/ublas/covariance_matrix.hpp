@@ -14,43 +14,318 @@
 
 #ifndef _BOOST_UBLAS_COVARIANCE_MATRIX_
 #define _BOOST_UBLAS_COVARIANCE_MATRIX_
-#endif
+
+#include <algorithm>
+#include <vector>
 
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 #include <boost/numeric/ublas/symmetric.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
+// Number of variables and of observations per tile of the blocked
+// covariance kernel
+#ifndef BOOST_UBLAS_COVARIANCE_BLOCK
+#define BOOST_UBLAS_COVARIANCE_BLOCK 64
+#endif
+#ifndef BOOST_UBLAS_COVARIANCE_DEPTH
+#define BOOST_UBLAS_COVARIANCE_DEPTH 256
+#endif
+
 namespace boost { namespace numeric { namespace ublas {
 
+namespace detail {
+
+    // Copy the variables of m into the rows of x and subtract their means,
+    // which are stored in mean
+    template<class M, class T>
+    BOOST_UBLAS_INLINE
+    void center_variables (const M &m, bool rowvar, matrix<T> &x, vector<T> &mean) {
+        typedef typename matrix<T>::size_type size_type;
+        size_type nvars (x.size1 ());
+        size_type nobvs (x.size2 ());
+        if (rowvar)
+            for (size_type i = 0; i < nvars; ++ i)
+                for (size_type k = 0; k < nobvs; ++ k)
+                    x (i, k) = m (i, k);
+        else
+            for (size_type k = 0; k < nobvs; ++ k)
+                for (size_type i = 0; i < nvars; ++ i)
+                    x (i, k) = m (k, i);
+        for (size_type i = 0; i < nvars; ++ i) {
+            T *xi = &x.data () [i * nobvs];
+            T t = T (0);
+            for (size_type k = 0; k < nobvs; ++ k)
+                t += xi [k];
+            t /= T (nobvs);
+            for (size_type k = 0; k < nobvs; ++ k)
+                xi [k] -= t;
+            mean (i) = t;
+        }
+    }
+
+    // As center_variables with the weighted means sum_k w (k) m_ik / sum_k w (k),
+    // and every centered observation k scaled by sqrt (w (k)) so that
+    // x_i . x_j is the weighted sum of products. Returns sum_k w (k).
+    template<class M, class W, class T>
+    BOOST_UBLAS_INLINE
+    T center_weighted_variables (const M &m, const W &w, bool rowvar, matrix<T> &x, vector<T> &mean) {
+        typedef typename matrix<T>::size_type size_type;
+        size_type nvars (x.size1 ());
+        size_type nobvs (x.size2 ());
+        std::vector<T> weight (nobvs);
+        std::vector<T> root (nobvs);
+        T total = T (0);
+        for (size_type k = 0; k < nobvs; ++ k) {
+            weight [k] = w (k);
+            BOOST_UBLAS_CHECK (weight [k] >= T (0), bad_argument ());
+            total += weight [k];
+            root [k] = type_traits<T>::type_sqrt (weight [k]);
+        }
+        if (rowvar)
+            for (size_type i = 0; i < nvars; ++ i)
+                for (size_type k = 0; k < nobvs; ++ k)
+                    x (i, k) = m (i, k);
+        else
+            for (size_type k = 0; k < nobvs; ++ k)
+                for (size_type i = 0; i < nvars; ++ i)
+                    x (i, k) = m (k, i);
+        for (size_type i = 0; i < nvars; ++ i) {
+            T *xi = &x.data () [i * nobvs];
+            T t = T (0);
+            for (size_type k = 0; k < nobvs; ++ k)
+                t += weight [k] * xi [k];
+            t /= total;
+            for (size_type k = 0; k < nobvs; ++ k)
+                xi [k] = root [k] * (xi [k] - t);
+            mean (i) = t;
+        }
+        return total;
+    }
+
+    // Add x_i . x_j over the observations [k1, k2) to the lower tile entries
+    // t (i - i1, j - j1), j <= i, of the variable blocks [i1, i2) x [j1, j2).
+    // Four columns share every load of x_i.
+    template<class T, class S>
+    BOOST_UBLAS_INLINE
+    void syrk_tile (const matrix<T> &x, S i1, S i2, S j1, S j2, S k1, S k2, std::vector<T> &t) {
+        S nobvs (x.size2 ());
+        S width (j2 - j1);
+        const T *data = &x.data () [0];
+        for (S i = i1; i < i2; ++ i) {
+            const T *xi = data + i * nobvs;
+            T *ti = &t [(i - i1) * width];
+            S jl (std::min (j2, i + 1));
+            S j = j1;
+            for (; j + 4 <= jl; j += 4) {
+                const T *x0 = data + j * nobvs;
+                const T *x1 = x0 + nobvs;
+                const T *x2 = x1 + nobvs;
+                const T *x3 = x2 + nobvs;
+                T t0 = T (0), t1 = T (0), t2 = T (0), t3 = T (0);
+                for (S k = k1; k < k2; ++ k) {
+                    T u (xi [k]);
+                    t0 += u * x0 [k];
+                    t1 += u * x1 [k];
+                    t2 += u * x2 [k];
+                    t3 += u * x3 [k];
+                }
+                ti [j - j1] += t0;
+                ti [j - j1 + 1] += t1;
+                ti [j - j1 + 2] += t2;
+                ti [j - j1 + 3] += t3;
+            }
+            for (; j < jl; ++ j) {
+                const T *xj = data + j * nobvs;
+                T t0 = T (0);
+                for (S k = k1; k < k2; ++ k)
+                    t0 += xi [k] * xj [k];
+                ti [j - j1] += t0;
+            }
+        }
+    }
+
+    // Lower triangle of x x^T, formed block by block in a single
+    // SYRK-style sweep over the rows of x
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scatter_rows (const matrix<T> &x, symmetric_matrix<T, lower> &s) {
+        typedef typename matrix<T>::size_type size_type;
+        size_type nvars (x.size1 ());
+        size_type nobvs (x.size2 ());
+
+        const size_type block (BOOST_UBLAS_COVARIANCE_BLOCK);
+        const size_type depth (BOOST_UBLAS_COVARIANCE_DEPTH);
+        std::vector<T> tile (block * block);
+        for (size_type i1 = 0; i1 < nvars; i1 += block) {
+            size_type i2 (std::min (nvars, i1 + block));
+            for (size_type j1 = 0; j1 <= i1; j1 += block) {
+                size_type j2 (std::min (nvars, j1 + block));
+                std::fill (tile.begin (), tile.end (), T (0));
+                for (size_type k1 = 0; k1 < nobvs; k1 += depth)
+                    syrk_tile (x, i1, i2, j1, j2, k1, std::min (nobvs, k1 + depth), tile);
+                for (size_type i = i1; i < i2; ++ i)
+                    for (size_type j = j1; j < std::min (j2, i + 1); ++ j)
+                        s (i, j) = tile [(i - i1) * (j2 - j1) + j - j1];
+            }
+        }
+    }
+
+    // Sums of the products of the centered variables in the rows (rowvar) or
+    // columns of m, for every pair of variables. The variables are centered
+    // once into a dense copy, and the lower triangle is formed from it by
+    // scatter_rows. The means of the variables are stored in mean. Returns
+    // the number of observations.
+    template<class M>
+    BOOST_UBLAS_INLINE
+    typename M::size_type scatter_matrix (const M &m, bool rowvar, symmetric_matrix<typename M::value_type, lower> &s,
+                                          vector<typename M::value_type> &mean) {
+        typedef typename M::value_type value_type;
+        typedef typename M::size_type size_type;
+
+        size_type nvars (rowvar ? m.size1 () : m.size2 ());
+        size_type nobvs (rowvar ? m.size2 () : m.size1 ());
+
+        s.resize (nvars, false);
+        s.clear ();
+        mean.resize (nvars, false);
+        mean.clear ();
+        if (nobvs == 0)
+            return nobvs;
+
+        matrix<value_type> x (nvars, nobvs);
+        center_variables (m, rowvar, x, mean);
+        scatter_rows (x, s);
+        return nobvs;
+    }
+    template<class M>
     BOOST_UBLAS_INLINE
+    typename M::size_type scatter_matrix (const M &m, bool rowvar, symmetric_matrix<typename M::value_type, lower> &s) {
+        vector<typename M::value_type> mean;
+        return scatter_matrix (m, rowvar, s, mean);
+    }
+
+    // Divide s (i, j) by sqrt (s (i, i) s (j, j)), turning a scatter matrix
+    // into a correlation matrix
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void normalize_scatter (symmetric_matrix<T, lower> &s) {
+        typedef typename symmetric_matrix<T, lower>::size_type size_type;
+        size_type nvars (s.size1 ());
+        vector<T> scale (nvars);
+        for (size_type i = 0; i < nvars; ++ i)
+            scale (i) = type_traits<T>::type_sqrt (s (i, i));
+        for (size_type i = 0; i < nvars; ++ i)
+            for (size_type j = 0; j <= i; ++ j)
+                s (i, j) /= scale (i) * scale (j);
+    }
+
+}
+
+    // Covariance matrix of the variables in the rows (rowvar) or columns of m,
+    // normalized by the number of observations minus ddof (0 for the
+    // population, 1 for the sample covariance)
     template <class M>
-    symmetric_matrix<typename M::value_type, lower> covariance_matrix (const M &m, bool rowvar = true) {
+    BOOST_UBLAS_INLINE
+    symmetric_matrix<typename M::value_type, lower> covariance_matrix (const M &m, bool rowvar = true, typename M::size_type ddof = 0) {
         typedef typename M::value_type value_type;
         typedef typename M::size_type size_type;
 
-        size_type nvars = 0;
-        size_type nobvs = 0;
+        symmetric_matrix<value_type, lower> cov_matrix;
+        size_type nobvs (detail::scatter_matrix (m, rowvar, cov_matrix));
+        if (nobvs == 0)
+            return cov_matrix;
 
-        if (rowvar) {
-            nvars = m.size1 ();
-            nobvs = m.size2 ();
-        }
-        else {
-            nvars = m.size2 ();
-            nobvs = m.size1 ();
-        }
+        value_type norm (value_type (nobvs) - value_type (ddof));
+        size_type nvars (cov_matrix.size1 ());
+        for (size_type i = 0; i < nvars; ++ i)
+            for (size_type j = 0; j <= i; ++ j)
+                cov_matrix (i, j) /= norm;
+
+        return cov_matrix;
+    }
+
+    // Weighted covariance matrix of the variables in the rows (rowvar) or
+    // columns of m, with the non-negative weight w (k) of observation k,
+    // normalized by sum (w). The weights enter the centering copy of
+    // covariance_matrix (m, rowvar), so no weighted temporary of m is formed.
+    template <class M, class W>
+    BOOST_UBLAS_INLINE
+    symmetric_matrix<typename M::value_type, lower> covariance_matrix (const M &m, const vector_expression<W> &w, bool rowvar = true) {
+        typedef typename M::value_type value_type;
+        typedef typename M::size_type size_type;
+
+        size_type nvars (rowvar ? m.size1 () : m.size2 ());
+        size_type nobvs (BOOST_UBLAS_SAME (rowvar ? m.size2 () : m.size1 (), w ().size ()));
 
         symmetric_matrix<value_type, lower> cov_matrix (nvars);
+        cov_matrix.clear ();
+        if (nobvs == 0)
+            return cov_matrix;
 
+        matrix<value_type> x (nvars, nobvs);
+        vector<value_type> mean (nvars);
+        value_type total (detail::center_weighted_variables (m, w (), rowvar, x, mean));
+        detail::scatter_rows (x, cov_matrix);
         for (size_type i = 0; i < nvars; ++ i)
             for (size_type j = 0; j <= i; ++ j)
-                if (rowvar)
-                    cov_matrix (i, j) = covariance (row (m, i), row (m, j));
-                else
-                    cov_matrix (i, j) = covariance (column (m, i), column (m, j));
+                cov_matrix (i, j) /= total;
 
         return cov_matrix;
     }
 
-}}}
\ No newline at end of file
+    // Pearson correlation matrix of the variables in the rows (rowvar) or
+    // columns of m, normalized by the diagonal of the same scatter matrix.
+    // The normalization of the covariance cancels, so there is no ddof. A
+    // constant variable has undefined (NaN) correlations.
+    template <class M>
+    BOOST_UBLAS_INLINE
+    symmetric_matrix<typename M::value_type, lower> correlation_matrix (const M &m, bool rowvar = true) {
+        typedef typename M::value_type value_type;
+
+        symmetric_matrix<value_type, lower> corr_matrix;
+        detail::scatter_matrix (m, rowvar, corr_matrix);
+        detail::normalize_scatter (corr_matrix);
+        return corr_matrix;
+    }
+
+    // Spearman rank correlation matrix of the variables in the rows (rowvar)
+    // or columns of m. This is the Pearson correlation matrix of their ranks,
+    // with tied values sharing the average rank. Each variable is ranked
+    // once into the dense copy of the scatter kernel of correlation_matrix.
+    // Its ranks are centered there by their exact mean (nobvs + 1) / 2.
+    template <class M>
+    BOOST_UBLAS_INLINE
+    symmetric_matrix<typename rank_traits<typename M::value_type>::value_type, lower> spearman_matrix (const M &m, bool rowvar = true) {
+        typedef typename M::value_type value_type;
+        typedef typename M::size_type size_type;
+        typedef typename rank_traits<value_type>::value_type rank_type;
+
+        size_type nvars (rowvar ? m.size1 () : m.size2 ());
+        size_type nobvs (rowvar ? m.size2 () : m.size1 ());
+
+        symmetric_matrix<rank_type, lower> corr_matrix (nvars);
+        corr_matrix.clear ();
+        if (nobvs == 0)
+            return corr_matrix;
+
+        matrix<rank_type> x (nvars, nobvs);
+        std::vector<std::pair<value_type, size_type> > order;
+        rank_type center ((rank_type (nobvs) + rank_type (1)) / rank_type (2));
+        for (size_type i = 0; i < nvars; ++ i) {
+            rank_type *xi = &x.data () [i * nobvs];
+            if (rowvar)
+                vector_rank<M>::apply (matrix_row<const M> (m, i), order, xi);
+            else
+                vector_rank<M>::apply (matrix_column<const M> (m, i), order, xi);
+            for (size_type k = 0; k < nobvs; ++ k)
+                xi [k] -= center;
+        }
+        detail::scatter_rows (x, corr_matrix);
+        detail::normalize_scatter (corr_matrix);
+        return corr_matrix;
+    }
+
+}}}
+
+#endif
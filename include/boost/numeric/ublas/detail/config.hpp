@@ -271,6 +271,25 @@ bool disable_type_check<Dummy>::value = false;
 #endif
 // #define BOOST_UBLAS_ITERATOR_THRESHOLD 0
 
+// Split large dense stats reductions across std::thread workers (C++11 only)
+// #define BOOST_UBLAS_PARALLEL_REDUCTIONS
+#if defined (BOOST_UBLAS_PARALLEL_REDUCTIONS) && ! defined (BOOST_UBLAS_CPP_GE_2011)
+#undef BOOST_UBLAS_PARALLEL_REDUCTIONS
+#endif
+// Minimum number of elements per worker
+#ifndef BOOST_UBLAS_PARALLEL_THRESHOLD
+#define BOOST_UBLAS_PARALLEL_THRESHOLD 65536
+#endif
+// Maximum number of workers, 0 for the hardware concurrency
+#ifndef BOOST_UBLAS_PARALLEL_THREADS
+#define BOOST_UBLAS_PARALLEL_THREADS 0
+#endif
+
+// Largest number of counts a joint histogram may allocate
+#ifndef BOOST_UBLAS_HISTOGRAM_MAX_BINS
+#define BOOST_UBLAS_HISTOGRAM_MAX_BINS (std::size_t (1) << 27)
+#endif
+
 // Use indexed iterators - unsupported implementation experiment
 // #define BOOST_UBLAS_USE_INDEXED_ITERATOR
 
@@ -0,0 +1,111 @@
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_PARALLEL_REDUCE_
+#define _BOOST_UBLAS_PARALLEL_REDUCE_
+
+#include <vector>
+
+#include <boost/core/ignore_unused.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+#include <boost/numeric/ublas/traits.hpp>
+
+#ifdef BOOST_UBLAS_PARALLEL_REDUCTIONS
+#include <exception>
+#include <functional>
+#include <thread>
+#endif
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    // Number of chunks a reduction over size elements is split into. Always
+    // one unless BOOST_UBLAS_PARALLEL_REDUCTIONS is defined; then every chunk
+    // holds at least BOOST_UBLAS_PARALLEL_THRESHOLD elements.
+    template<class S>
+    BOOST_UBLAS_INLINE
+    S reduction_chunks (S size) {
+#ifdef BOOST_UBLAS_PARALLEL_REDUCTIONS
+        S threads (BOOST_UBLAS_PARALLEL_THREADS);
+        if (threads == S (0))
+            threads = S (std::thread::hardware_concurrency ());
+        S chunks (size / S (BOOST_UBLAS_PARALLEL_THRESHOLD));
+        if (chunks > threads)
+            chunks = threads;
+        return chunks > S (1) ? chunks : S (1);
+#else
+        boost::ignore_unused (size);
+        return S (1);
+#endif
+    }
+
+    // Whether the elements of E may be read from several threads at once.
+    // That holds for containers and proxies of dense or packed storage.
+    // Other expressions may compute or cache their elements on access, and
+    // sparse containers may sort their storage on lookup.
+    template<class E>
+    struct splittable_expression {
+        static const bool value = boost::is_base_of<packed_proxy_tag, typename E::storage_category>::value;
+    };
+
+    // reduction_chunks for a reduction over the elements of E, one unless
+    // E is a splittable_expression
+    template<class E, class S>
+    BOOST_UBLAS_INLINE
+    S expression_chunks (S size) {
+        return splittable_expression<E>::value ? reduction_chunks (size) : S (1);
+    }
+
+#ifdef BOOST_UBLAS_PARALLEL_REDUCTIONS
+    // Runs one part of reduce_chunks, keeping what it throws for the caller
+    template<class S, class K>
+    void run_chunk (K &kernel, S c, S first, S last, std::exception_ptr &error) {
+        try {
+            kernel (c, first, last);
+        }
+        catch (...) {
+            error = std::current_exception ();
+        }
+    }
+#endif
+
+    // Call kernel (c, first, last) for the chunks consecutive parts
+    // [first, last) of [0, size). The parts run on their own threads if
+    // there is more than one; the calling thread takes part 0. All threads
+    // are joined before the first exception any part threw is rethrown.
+    template<class S, class K>
+    BOOST_UBLAS_INLINE
+    void reduce_chunks (S size, S chunks, K &kernel) {
+#ifdef BOOST_UBLAS_PARALLEL_REDUCTIONS
+        if (chunks > S (1)) {
+            std::vector<std::exception_ptr> errors (chunks);
+            std::vector<std::thread> workers;
+            workers.reserve (chunks - 1);
+            try {
+                for (S c = 1; c < chunks; ++ c)
+                    workers.push_back (std::thread (run_chunk<S, K>, std::ref (kernel), c, size * c / chunks,
+                                                    size * (c + 1) / chunks, std::ref (errors [c])));
+            }
+            catch (...) {
+                errors [0] = std::current_exception ();
+            }
+            if (! errors [0])
+                run_chunk (kernel, S (0), S (0), size / chunks, errors [0]);
+            for (std::size_t w = 0; w < workers.size (); ++ w)
+                workers [w].join ();
+            for (S c = 0; c < chunks; ++ c)
+                if (errors [c])
+                    std::rethrow_exception (errors [c]);
+            return;
+        }
+#else
+        boost::ignore_unused (chunks);
+#endif
+        kernel (S (0), S (0), size);
+    }
+
+}}}}
+
+#endif
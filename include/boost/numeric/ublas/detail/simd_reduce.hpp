@@ -0,0 +1,496 @@
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_SIMD_REDUCE_
+#define _BOOST_UBLAS_SIMD_REDUCE_
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+
+// Kernels for reductions over contiguous float and double arrays. On x86
+// with GCC compatible compilers they come in SSE2, AVX2 and AVX-512
+// versions, chosen at run time from the CPU features; elsewhere, and for
+// other value types, scalar loops are used.
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__)) && ! defined (BOOST_UBLAS_NO_SIMD_DISPATCH)
+#define BOOST_UBLAS_SIMD_X86
+#include <immintrin.h>
+#endif
+
+// Highest instruction set the kernels may use: 0 scalar, 1 SSE2, 2 AVX2, 3 AVX-512
+#ifndef BOOST_UBLAS_SIMD_MAX_LEVEL
+#define BOOST_UBLAS_SIMD_MAX_LEVEL 3
+#endif
+
+namespace boost { namespace numeric { namespace ublas { namespace detail {
+
+    enum simd_level {
+        simd_level_scalar,
+        simd_level_sse2,
+        simd_level_avx2,
+        simd_level_avx512
+    };
+
+    inline
+    int simd_detected_level () {
+        int level = simd_level_scalar;
+#ifdef BOOST_UBLAS_SIMD_X86
+        __builtin_cpu_init ();
+        if (__builtin_cpu_supports ("avx512f"))
+            level = simd_level_avx512;
+        else if (__builtin_cpu_supports ("avx2"))
+            level = simd_level_avx2;
+        else if (__builtin_cpu_supports ("sse2"))
+            level = simd_level_sse2;
+#endif
+        return level < BOOST_UBLAS_SIMD_MAX_LEVEL ? level : BOOST_UBLAS_SIMD_MAX_LEVEL;
+    }
+
+    // Detected once per program
+    inline
+    int simd_current_level () {
+        static const int level = simd_detected_level ();
+        return level;
+    }
+
+    // Scalar kernels
+
+    template<class T>
+    BOOST_UBLAS_INLINE
+    T scalar_sum (const T *p, std::size_t n) {
+        T t (0);
+        for (std::size_t i = 0; i < n; ++ i)
+            t += p [i];
+        return t;
+    }
+
+    template<class T>
+    BOOST_UBLAS_INLINE
+    T scalar_dot (const T *p, const T *q, std::size_t n) {
+        T t (0);
+        for (std::size_t i = 0; i < n; ++ i)
+            t += p [i] * q [i];
+        return t;
+    }
+
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scalar_power_sums (const T *p, std::size_t n, T &sum, T &sumsq) {
+        sum = sumsq = T (0);
+        for (std::size_t i = 0; i < n; ++ i) {
+            sum += p [i];
+            sumsq += p [i] * p [i];
+        }
+    }
+
+    // Welford update of count, mean and m2 with p [i, n)
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scalar_moments (const T *p, std::size_t i, std::size_t n, std::size_t &count, T &mean, T &m2) {
+        for (; i < n; ++ i) {
+            ++ count;
+            T del = p [i] - mean;
+            mean += del / T (count);
+            m2 += del * (p [i] - mean);
+        }
+    }
+
+    // Smallest, largest and summed magnitudes and the sum of squares. NaNs
+    // are skipped by the smallest and largest magnitude; the vector kernels
+    // pass the new element first to min and max, which return their second
+    // operand when either is NaN, to do the same.
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scalar_abs_stats (const T *p, std::size_t n, T &amin, T &amax, T &asum, T &sumsq) {
+        amin = std::numeric_limits<T>::infinity ();
+        amax = asum = sumsq = T (0);
+        for (std::size_t i = 0; i < n; ++ i) {
+            T a = std::abs (p [i]);
+            if (a < amin)
+                amin = a;
+            if (a > amax)
+                amax = a;
+            asum += a;
+            sumsq += a * a;
+        }
+    }
+
+    // Smallest and largest element, NaNs skipped; +inf and -inf for none
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scalar_range (const T *p, std::size_t n, T &lo, T &hi) {
+        lo = std::numeric_limits<T>::infinity ();
+        hi = - std::numeric_limits<T>::infinity ();
+        for (std::size_t i = 0; i < n; ++ i) {
+            if (p [i] < lo)
+                lo = p [i];
+            if (p [i] > hi)
+                hi = p [i];
+        }
+    }
+
+    // Fractional bin positions (p [i] - lo) / width + tol, capped at top;
+    // NaNs stay NaN
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scalar_bin_positions (const T *p, std::size_t n, T lo, T width, T tol, T top, T *r) {
+        for (std::size_t i = 0; i < n; ++ i) {
+            T x = (p [i] - lo) / width + tol;
+            r [i] = x > top ? top : x;
+        }
+    }
+
+    // Welford update of count, mean and m2 with the elements of p [i, n)
+    // that are not NaN
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scalar_nan_moments (const T *p, std::size_t i, std::size_t n, std::size_t &count, T &mean, T &m2) {
+        for (; i < n; ++ i) {
+            if (p [i] != p [i])
+                continue;
+            ++ count;
+            T del = p [i] - mean;
+            mean += del / T (count);
+            m2 += del * (p [i] - mean);
+        }
+    }
+
+    // Welford update of the slots count [j], mean [j] and m2 [j] with p [j]
+    // unless it is NaN; the counts are held as T
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void scalar_nan_moments_update (const T *p, std::size_t n, T *count, T *mean, T *m2) {
+        for (std::size_t j = 0; j < n; ++ j) {
+            if (p [j] != p [j])
+                continue;
+            count [j] += T (1);
+            T del = p [j] - mean [j];
+            mean [j] += del / count [j];
+            m2 [j] += del * (p [j] - mean [j]);
+        }
+    }
+
+    // Combine w lanes of k elements each with Chan's update, then add the
+    // tail p [i, n) one by one
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void simd_finish_moments (const T *lane_mean, const T *lane_m2, std::size_t w, std::size_t k,
+                              const T *p, std::size_t i, std::size_t n, T &mean, T &m2) {
+        std::size_t count = 0;
+        mean = m2 = T (0);
+        for (std::size_t l = 0; k > 0 && l < w; ++ l) {
+            std::size_t m = count + k;
+            T del = lane_mean [l] - mean;
+            mean += del * T (k) / T (m);
+            m2 += lane_m2 [l] + del * del * T (count) * T (k) / T (m);
+            count = m;
+        }
+        scalar_moments (p, i, n, count, mean, m2);
+    }
+
+    // Combine w lanes of lane_count [l] elements with Chan's update, then
+    // add the elements of the tail p [i, n) that are not NaN
+    template<class T>
+    BOOST_UBLAS_INLINE
+    void simd_finish_nan_moments (const T *lane_count, const T *lane_mean, const T *lane_m2, std::size_t w,
+                                  const T *p, std::size_t i, std::size_t n, std::size_t &count, T &mean, T &m2) {
+        count = 0;
+        mean = m2 = T (0);
+        for (std::size_t l = 0; l < w; ++ l) {
+            std::size_t k = std::size_t (lane_count [l]);
+            if (k == 0)
+                continue;
+            std::size_t m = count + k;
+            T del = lane_mean [l] - mean;
+            mean += del * T (k) / T (m);
+            m2 += lane_m2 [l] + del * del * T (count) * T (k) / T (m);
+            count = m;
+        }
+        scalar_nan_moments (p, i, n, count, mean, m2);
+    }
+
+#ifdef BOOST_UBLAS_SIMD_X86
+
+#define BOOST_UBLAS_SIMD_ABS_ANDNOT(PRE, SUF, T, x) PRE ## _andnot_ ## SUF (PRE ## _set1_ ## SUF (T (-0.0)), x)
+#define BOOST_UBLAS_SIMD_ABS_AVX512(PRE, SUF, T, x) PRE ## _abs_ ## SUF (x)
+
+    // v in the lanes where x is not NaN and zero elsewhere, without branches
+#define BOOST_UBLAS_SIMD_KEEP_SSE(PRE, SUF, x, v) PRE ## _and_ ## SUF (PRE ## _cmpord_ ## SUF (x, x), v)
+#define BOOST_UBLAS_SIMD_KEEP_AVX(PRE, SUF, x, v) PRE ## _and_ ## SUF (PRE ## _cmp_ ## SUF (x, x, _CMP_ORD_Q), v)
+#define BOOST_UBLAS_SIMD_KEEP_AVX512(PRE, SUF, x, v) PRE ## _maskz_mov_ ## SUF (PRE ## _cmp_ ## SUF ## _mask (x, x, _CMP_ORD_Q), v)
+
+    // min and max with the lanes of y where x or y is NaN. The AVX-512 ones
+    // go through the masked forms with y as the source, since the plain ones
+    // pass an undefined register that GCC reports as maybe uninitialized.
+#define BOOST_UBLAS_SIMD_MIN(PRE, SUF, x, y) PRE ## _min_ ## SUF (x, y)
+#define BOOST_UBLAS_SIMD_MAX(PRE, SUF, x, y) PRE ## _max_ ## SUF (x, y)
+#define BOOST_UBLAS_SIMD_MIN_AVX512(PRE, SUF, x, y) PRE ## _mask_min_ ## SUF (y, -1, x, y)
+#define BOOST_UBLAS_SIMD_MAX_AVX512(PRE, SUF, x, y) PRE ## _mask_max_ ## SUF (y, -1, x, y)
+
+    // One set of kernels for the W lanes of register type REG holding T; the
+    // intrinsics are PRE_op_SUF
+#define BOOST_UBLAS_SIMD_KERNELS(ISA, TARGET, T, REG, W, PRE, SUF, ABS, KEEP, MIN, MAX) \
+    __attribute__ ((target (TARGET))) inline \
+    T ISA ## _sum (const T *p, std::size_t n) { \
+        REG s = PRE ## _setzero_ ## SUF (); \
+        std::size_t i = 0; \
+        for (; i + W <= n; i += W) \
+            s = PRE ## _add_ ## SUF (s, PRE ## _loadu_ ## SUF (p + i)); \
+        T lanes [W]; \
+        PRE ## _storeu_ ## SUF (lanes, s); \
+        return scalar_sum (lanes, W) + scalar_sum (p + i, n - i); \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    T ISA ## _dot (const T *p, const T *q, std::size_t n) { \
+        REG s = PRE ## _setzero_ ## SUF (); \
+        std::size_t i = 0; \
+        for (; i + W <= n; i += W) \
+            s = PRE ## _add_ ## SUF (s, PRE ## _mul_ ## SUF (PRE ## _loadu_ ## SUF (p + i), PRE ## _loadu_ ## SUF (q + i))); \
+        T lanes [W]; \
+        PRE ## _storeu_ ## SUF (lanes, s); \
+        return scalar_sum (lanes, W) + scalar_dot (p + i, q + i, n - i); \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    void ISA ## _power_sums (const T *p, std::size_t n, T &sum, T &sumsq) { \
+        REG s = PRE ## _setzero_ ## SUF (); \
+        REG sq = PRE ## _setzero_ ## SUF (); \
+        std::size_t i = 0; \
+        for (; i + W <= n; i += W) { \
+            REG x = PRE ## _loadu_ ## SUF (p + i); \
+            s = PRE ## _add_ ## SUF (s, x); \
+            sq = PRE ## _add_ ## SUF (sq, PRE ## _mul_ ## SUF (x, x)); \
+        } \
+        T lanes [W], lanes_sq [W]; \
+        PRE ## _storeu_ ## SUF (lanes, s); \
+        PRE ## _storeu_ ## SUF (lanes_sq, sq); \
+        scalar_power_sums (p + i, n - i, sum, sumsq); \
+        sum += scalar_sum (lanes, W); \
+        sumsq += scalar_sum (lanes_sq, W); \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    void ISA ## _moments (const T *p, std::size_t n, T &mean, T &m2) { \
+        REG mu = PRE ## _setzero_ ## SUF (); \
+        REG q = PRE ## _setzero_ ## SUF (); \
+        std::size_t i = 0, k = 0; \
+        for (; i + W <= n; i += W) { \
+            ++ k; \
+            REG x = PRE ## _loadu_ ## SUF (p + i); \
+            REG del = PRE ## _sub_ ## SUF (x, mu); \
+            mu = PRE ## _add_ ## SUF (mu, PRE ## _mul_ ## SUF (del, PRE ## _set1_ ## SUF (T (1) / T (k)))); \
+            q = PRE ## _add_ ## SUF (q, PRE ## _mul_ ## SUF (del, PRE ## _sub_ ## SUF (x, mu))); \
+        } \
+        T lane_mean [W], lane_m2 [W]; \
+        PRE ## _storeu_ ## SUF (lane_mean, mu); \
+        PRE ## _storeu_ ## SUF (lane_m2, q); \
+        simd_finish_moments (lane_mean, lane_m2, W, k, p, i, n, mean, m2); \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    void ISA ## _abs_stats (const T *p, std::size_t n, T &amin, T &amax, T &asum, T &sumsq) { \
+        REG lo = PRE ## _set1_ ## SUF (std::numeric_limits<T>::infinity ()); \
+        REG hi = PRE ## _setzero_ ## SUF (); \
+        REG s = PRE ## _setzero_ ## SUF (); \
+        REG sq = PRE ## _setzero_ ## SUF (); \
+        std::size_t i = 0; \
+        for (; i + W <= n; i += W) { \
+            REG a = ABS (PRE, SUF, T, PRE ## _loadu_ ## SUF (p + i)); \
+            lo = MIN (PRE, SUF, a, lo); \
+            hi = MAX (PRE, SUF, a, hi); \
+            s = PRE ## _add_ ## SUF (s, a); \
+            sq = PRE ## _add_ ## SUF (sq, PRE ## _mul_ ## SUF (a, a)); \
+        } \
+        T lanes_lo [W], lanes_hi [W], lanes [W], lanes_sq [W]; \
+        PRE ## _storeu_ ## SUF (lanes_lo, lo); \
+        PRE ## _storeu_ ## SUF (lanes_hi, hi); \
+        PRE ## _storeu_ ## SUF (lanes, s); \
+        PRE ## _storeu_ ## SUF (lanes_sq, sq); \
+        scalar_abs_stats (p + i, n - i, amin, amax, asum, sumsq); \
+        for (std::size_t l = 0; l < W; ++ l) { \
+            if (lanes_lo [l] < amin) \
+                amin = lanes_lo [l]; \
+            if (lanes_hi [l] > amax) \
+                amax = lanes_hi [l]; \
+        } \
+        asum += scalar_sum (lanes, W); \
+        sumsq += scalar_sum (lanes_sq, W); \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    void ISA ## _range (const T *p, std::size_t n, T &lo, T &hi) { \
+        REG l = PRE ## _set1_ ## SUF (std::numeric_limits<T>::infinity ()); \
+        REG h = PRE ## _set1_ ## SUF (- std::numeric_limits<T>::infinity ()); \
+        std::size_t i = 0; \
+        for (; i + W <= n; i += W) { \
+            REG x = PRE ## _loadu_ ## SUF (p + i); \
+            l = MIN (PRE, SUF, x, l); \
+            h = MAX (PRE, SUF, x, h); \
+        } \
+        T lanes_lo [W], lanes_hi [W]; \
+        PRE ## _storeu_ ## SUF (lanes_lo, l); \
+        PRE ## _storeu_ ## SUF (lanes_hi, h); \
+        scalar_range (p + i, n - i, lo, hi); \
+        for (std::size_t k = 0; k < W; ++ k) { \
+            if (lanes_lo [k] < lo) \
+                lo = lanes_lo [k]; \
+            if (lanes_hi [k] > hi) \
+                hi = lanes_hi [k]; \
+        } \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    void ISA ## _bin_positions (const T *p, std::size_t n, T lo, T width, T tol, T top, T *r) { \
+        REG l = PRE ## _set1_ ## SUF (lo); \
+        REG w = PRE ## _set1_ ## SUF (width); \
+        REG t = PRE ## _set1_ ## SUF (tol); \
+        REG c = PRE ## _set1_ ## SUF (top); \
+        std::size_t i = 0; \
+        for (; i + W <= n; i += W) { \
+            REG x = PRE ## _add_ ## SUF (PRE ## _div_ ## SUF (PRE ## _sub_ ## SUF (PRE ## _loadu_ ## SUF (p + i), l), w), t); \
+            PRE ## _storeu_ ## SUF (r + i, MIN (PRE, SUF, c, x)); \
+        } \
+        scalar_bin_positions (p + i, n - i, lo, width, tol, top, r + i); \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    void ISA ## _nan_moments (const T *p, std::size_t n, std::size_t &count, T &mean, T &m2) { \
+        REG one = PRE ## _set1_ ## SUF (T (1)); \
+        REG c = PRE ## _setzero_ ## SUF (); \
+        REG mu = PRE ## _setzero_ ## SUF (); \
+        REG q = PRE ## _setzero_ ## SUF (); \
+        std::size_t i = 0; \
+        for (; i + W <= n; i += W) { \
+            REG x = PRE ## _loadu_ ## SUF (p + i); \
+            c = PRE ## _add_ ## SUF (c, KEEP (PRE, SUF, x, one)); \
+            REG del = KEEP (PRE, SUF, x, PRE ## _sub_ ## SUF (x, mu)); \
+            mu = PRE ## _add_ ## SUF (mu, PRE ## _div_ ## SUF (del, MAX (PRE, SUF, c, one))); \
+            q = PRE ## _add_ ## SUF (q, PRE ## _mul_ ## SUF (del, KEEP (PRE, SUF, x, PRE ## _sub_ ## SUF (x, mu)))); \
+        } \
+        T lane_count [W], lane_mean [W], lane_m2 [W]; \
+        PRE ## _storeu_ ## SUF (lane_count, c); \
+        PRE ## _storeu_ ## SUF (lane_mean, mu); \
+        PRE ## _storeu_ ## SUF (lane_m2, q); \
+        simd_finish_nan_moments (lane_count, lane_mean, lane_m2, W, p, i, n, count, mean, m2); \
+    } \
+    __attribute__ ((target (TARGET))) inline \
+    void ISA ## _nan_moments_update (const T *p, std::size_t n, T *count, T *mean, T *m2) { \
+        REG one = PRE ## _set1_ ## SUF (T (1)); \
+        std::size_t j = 0; \
+        for (; j + W <= n; j += W) { \
+            REG x = PRE ## _loadu_ ## SUF (p + j); \
+            REG c = PRE ## _add_ ## SUF (PRE ## _loadu_ ## SUF (count + j), KEEP (PRE, SUF, x, one)); \
+            REG mu = PRE ## _loadu_ ## SUF (mean + j); \
+            REG del = KEEP (PRE, SUF, x, PRE ## _sub_ ## SUF (x, mu)); \
+            mu = PRE ## _add_ ## SUF (mu, PRE ## _div_ ## SUF (del, MAX (PRE, SUF, c, one))); \
+            REG q = PRE ## _mul_ ## SUF (del, KEEP (PRE, SUF, x, PRE ## _sub_ ## SUF (x, mu))); \
+            PRE ## _storeu_ ## SUF (m2 + j, PRE ## _add_ ## SUF (PRE ## _loadu_ ## SUF (m2 + j), q)); \
+            PRE ## _storeu_ ## SUF (count + j, c); \
+            PRE ## _storeu_ ## SUF (mean + j, mu); \
+        } \
+        scalar_nan_moments_update (p + j, n - j, count + j, mean + j, m2 + j); \
+    }
+
+    BOOST_UBLAS_SIMD_KERNELS (sse2, "sse2", double, __m128d, 2, _mm, pd, BOOST_UBLAS_SIMD_ABS_ANDNOT, BOOST_UBLAS_SIMD_KEEP_SSE, BOOST_UBLAS_SIMD_MIN, BOOST_UBLAS_SIMD_MAX)
+    BOOST_UBLAS_SIMD_KERNELS (sse2, "sse2", float, __m128, 4, _mm, ps, BOOST_UBLAS_SIMD_ABS_ANDNOT, BOOST_UBLAS_SIMD_KEEP_SSE, BOOST_UBLAS_SIMD_MIN, BOOST_UBLAS_SIMD_MAX)
+    BOOST_UBLAS_SIMD_KERNELS (avx2, "avx2", double, __m256d, 4, _mm256, pd, BOOST_UBLAS_SIMD_ABS_ANDNOT, BOOST_UBLAS_SIMD_KEEP_AVX, BOOST_UBLAS_SIMD_MIN, BOOST_UBLAS_SIMD_MAX)
+    BOOST_UBLAS_SIMD_KERNELS (avx2, "avx2", float, __m256, 8, _mm256, ps, BOOST_UBLAS_SIMD_ABS_ANDNOT, BOOST_UBLAS_SIMD_KEEP_AVX, BOOST_UBLAS_SIMD_MIN, BOOST_UBLAS_SIMD_MAX)
+    BOOST_UBLAS_SIMD_KERNELS (avx512, "avx512f", double, __m512d, 8, _mm512, pd, BOOST_UBLAS_SIMD_ABS_AVX512, BOOST_UBLAS_SIMD_KEEP_AVX512, BOOST_UBLAS_SIMD_MIN_AVX512, BOOST_UBLAS_SIMD_MAX_AVX512)
+    BOOST_UBLAS_SIMD_KERNELS (avx512, "avx512f", float, __m512, 16, _mm512, ps, BOOST_UBLAS_SIMD_ABS_AVX512, BOOST_UBLAS_SIMD_KEEP_AVX512, BOOST_UBLAS_SIMD_MIN_AVX512, BOOST_UBLAS_SIMD_MAX_AVX512)
+
+#undef BOOST_UBLAS_SIMD_KERNELS
+#undef BOOST_UBLAS_SIMD_MAX_AVX512
+#undef BOOST_UBLAS_SIMD_MIN_AVX512
+#undef BOOST_UBLAS_SIMD_MAX
+#undef BOOST_UBLAS_SIMD_MIN
+#undef BOOST_UBLAS_SIMD_KEEP_AVX512
+#undef BOOST_UBLAS_SIMD_KEEP_AVX
+#undef BOOST_UBLAS_SIMD_KEEP_SSE
+#undef BOOST_UBLAS_SIMD_ABS_AVX512
+#undef BOOST_UBLAS_SIMD_ABS_ANDNOT
+
+#define BOOST_UBLAS_SIMD_DISPATCH(call) \
+        switch (simd_current_level ()) { \
+        case simd_level_avx512: \
+            return avx512_ ## call; \
+        case simd_level_avx2: \
+            return avx2_ ## call; \
+        case simd_level_sse2: \
+            return sse2_ ## call; \
+        default: \
+            break; \
+        }
+#else
+#define BOOST_UBLAS_SIMD_DISPATCH(call)
+#endif
+
+    // Entry points for float and double
+
+#define BOOST_UBLAS_SIMD_CONTIGUOUS(T) \
+    inline \
+    T contiguous_sum (const T *p, std::size_t n) { \
+        BOOST_UBLAS_SIMD_DISPATCH (sum (p, n)) \
+        return scalar_sum (p, n); \
+    } \
+    inline \
+    T contiguous_dot (const T *p, const T *q, std::size_t n) { \
+        BOOST_UBLAS_SIMD_DISPATCH (dot (p, q, n)) \
+        return scalar_dot (p, q, n); \
+    } \
+    inline \
+    void contiguous_power_sums (const T *p, std::size_t n, T &sum, T &sumsq) { \
+        BOOST_UBLAS_SIMD_DISPATCH (power_sums (p, n, sum, sumsq)) \
+        scalar_power_sums (p, n, sum, sumsq); \
+    } \
+    inline \
+    void contiguous_moments (const T *p, std::size_t n, T &mean, T &m2) { \
+        BOOST_UBLAS_SIMD_DISPATCH (moments (p, n, mean, m2)) \
+        std::size_t count = 0; \
+        mean = m2 = T (0); \
+        scalar_moments (p, 0, n, count, mean, m2); \
+    } \
+    inline \
+    void contiguous_abs_stats (const T *p, std::size_t n, T &amin, T &amax, T &asum, T &sumsq) { \
+        BOOST_UBLAS_SIMD_DISPATCH (abs_stats (p, n, amin, amax, asum, sumsq)) \
+        scalar_abs_stats (p, n, amin, amax, asum, sumsq); \
+    } \
+    inline \
+    void contiguous_range (const T *p, std::size_t n, T &lo, T &hi) { \
+        BOOST_UBLAS_SIMD_DISPATCH (range (p, n, lo, hi)) \
+        scalar_range (p, n, lo, hi); \
+    } \
+    inline \
+    void contiguous_bin_positions (const T *p, std::size_t n, T lo, T width, T tol, T top, T *r) { \
+        BOOST_UBLAS_SIMD_DISPATCH (bin_positions (p, n, lo, width, tol, top, r)) \
+        scalar_bin_positions (p, n, lo, width, tol, top, r); \
+    } \
+    inline \
+    void contiguous_nan_moments (const T *p, std::size_t n, std::size_t &count, T &mean, T &m2) { \
+        BOOST_UBLAS_SIMD_DISPATCH (nan_moments (p, n, count, mean, m2)) \
+        count = 0; \
+        mean = m2 = T (0); \
+        scalar_nan_moments (p, 0, n, count, mean, m2); \
+    } \
+    inline \
+    void contiguous_nan_moments_update (const T *p, std::size_t n, T *count, T *mean, T *m2) { \
+        BOOST_UBLAS_SIMD_DISPATCH (nan_moments_update (p, n, count, mean, m2)) \
+        scalar_nan_moments_update (p, n, count, mean, m2); \
+    }
+
+    BOOST_UBLAS_SIMD_CONTIGUOUS (float)
+    BOOST_UBLAS_SIMD_CONTIGUOUS (double)
+
+    // Other value types
+    template<class T1, class T2>
+    BOOST_UBLAS_INLINE
+    typename promote_traits<T1, T2>::promote_type
+    contiguous_dot (const T1 *p, const T2 *q, std::size_t n) {
+        typename promote_traits<T1, T2>::promote_type t (0);
+        for (std::size_t i = 0; i < n; ++ i)
+            t += p [i] * q [i];
+        return t;
+    }
+
+#undef BOOST_UBLAS_SIMD_CONTIGUOUS
+#undef BOOST_UBLAS_SIMD_DISPATCH
+
+}}}}
+
+#endif
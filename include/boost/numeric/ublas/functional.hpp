@@ -13,18 +13,35 @@
 #ifndef _BOOST_UBLAS_FUNCTIONAL_
 #define _BOOST_UBLAS_FUNCTIONAL_
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
 #include <functional>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
 
 #include <boost/core/ignore_unused.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
+#include <boost/type_traits/is_floating_point.hpp>
+#include <boost/type_traits/is_integral.hpp>
 #include <boost/unordered_map.hpp>
 #include <boost/range/algorithm.hpp>
 
 #include <boost/numeric/ublas/traits.hpp>
+#include <boost/numeric/ublas/detail/parallel_reduce.hpp>
 #ifdef BOOST_UBLAS_USE_DUFF_DEVICE
 #include <boost/numeric/ublas/detail/duff.hpp>
 #endif
 #ifdef BOOST_UBLAS_USE_SIMD
 #include <boost/numeric/ublas/detail/raw.hpp>
+#include <boost/numeric/ublas/detail/simd_reduce.hpp>
+#include <boost/type_traits/remove_const.hpp>
 #else
 namespace boost { namespace numeric { namespace ublas { namespace raw {
 }}}}
@@ -330,1174 +347,4150 @@ namespace boost { namespace numeric { namespace ublas {
         };
     };
 
-    // Vector functors
+    // Order statistics by selection
 
-    // Unary returning scalar
-    template<class V>
-    struct vector_scalar_unary_functor {
-        typedef typename V::value_type value_type;
-        typedef typename V::value_type result_type;
+    // Magnitude ordering of the median, mode, min and max statistics, made
+    // total by ordering equal magnitudes by value (complex values by real,
+    // then imaginary part)
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool value_less (const T &a, const T &b, boost::true_type) {
+        return a < b;
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool value_less (const T &a, const T &b, boost::false_type) {
+        return type_traits<T>::real (a) < type_traits<T>::real (b) ||
+               (type_traits<T>::real (a) == type_traits<T>::real (b) && type_traits<T>::imag (a) < type_traits<T>::imag (b));
+    }
+    template<class T>
+    BOOST_UBLAS_INLINE
+    bool magnitude_less (const T &a, const T &b) {
+        typename type_traits<T>::real_type abs_a (type_traits<T>::type_abs (a));
+        typename type_traits<T>::real_type abs_b (type_traits<T>::type_abs (b));
+        return abs_a < abs_b || (abs_a == abs_b && value_less (a, b, boost::is_arithmetic<T> ()));
+    }
+
+    // Median of [first, last) under the ordering comp, in O(n) average
+    // time. nth_element places the upper middle element; for an even
+    // count the lower middle one is the largest of the partition below
+    // it, so no second selection is needed. Reorders the range.
+    template<class I, class C>
+    BOOST_UBLAS_INLINE
+    typename std::iterator_traits<I>::value_type
+    select_median (I first, I last, C comp) {
+        typedef typename std::iterator_traits<I>::difference_type difference_type;
+        difference_type size (last - first);
+        I middle (first + size / 2);
+        std::nth_element (first, middle, last, comp);
+        if (size % 2)
+            return *middle;
+        else
+            return (*middle + *std::max_element (first, middle, comp)) / 2;
+    }
+
+    // Interpolation between the two order statistics around a quantile
+    enum quantile_interpolation {
+        quantile_linear,
+        quantile_lower,
+        quantile_higher,
+        quantile_nearest,
+        quantile_midpoint
     };
 
-    template<class V>
-    struct vector_min: 
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+    // Place the order statistics with the sorted, unique ranks
+    // [r_first, r_last), counted from offset, at their final positions in
+    // [first, last). The middle rank splits the range and the ranks on
+    // either side only search their own part.
+    template<class I, class R, class C>
+    BOOST_UBLAS_INLINE
+    void multi_select (I first, I last, R r_first, R r_last, typename std::iterator_traits<R>::value_type offset, C comp) {
+        if (r_first == r_last)
+            return;
+        R r_middle (r_first + (r_last - r_first) / 2);
+        I nth (first + (*r_middle - offset));
+        std::nth_element (first, nth, last, comp);
+        multi_select (first, nth, r_first, r_middle, offset, comp);
+        multi_select (nth + 1, last, r_middle + 1, r_last, *r_middle + 1, comp);
+    }
 
-        template<class E>
-        static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) { 
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            result_type min_val = result_type (e () (vector_size_type (0)));
-            for (vector_size_type i = 0; i < size; ++ i)
-                if ( type_traits<value_type>::type_abs(min_val) > type_traits<value_type>::type_abs(e () (i)) )
-                    min_val = e () (i);
-            return min_val;
-        }
-        // Dense case
-        template<class D, class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            result_type min_val = *it;
-            while (-- size >= 0) {
-                if ( type_traits<value_type>::type_abs(min_val) > type_traits<value_type>::type_abs(*it) )
-                    min_val = *it;
-                ++ it;
+    // Quantiles q [k] in [0, 1] of [first, last) extended by zeros elements
+    // equal to zero, under the ordering comp, which must put zero first. The
+    // zeros stand for the elements a sparse container does not store.
+    // The rank h = (n - 1) q falls between the order statistics floor (h)
+    // and floor (h) + 1, which are combined according to method. All the
+    // needed order statistics come from one multi_select. Reorders the range.
+    template<class I, class QI, class OI, class C>
+    BOOST_UBLAS_INLINE
+    void select_quantiles (I first, I last, typename std::iterator_traits<I>::difference_type zeros,
+                           QI q_first, QI q_last, OI out, quantile_interpolation method, C comp) {
+        typedef typename std::iterator_traits<I>::difference_type difference_type;
+        typedef typename std::iterator_traits<I>::value_type value_type;
+        difference_type size ((last - first) + zeros);
+        BOOST_UBLAS_CHECK (size > 0, bad_size ());
+
+        std::vector<difference_type> ranks;
+        for (QI q = q_first; q != q_last; ++ q) {
+            BOOST_UBLAS_CHECK (*q >= 0 && *q <= 1, bad_argument ());
+            difference_type lower = difference_type (double (size - 1) * *q);
+            if (lower >= zeros)
+                ranks.push_back (lower - zeros);
+            if (lower + 1 < size && lower + 1 >= zeros)
+                ranks.push_back (lower + 1 - zeros);
+        }
+        std::sort (ranks.begin (), ranks.end ());
+        ranks.erase (std::unique (ranks.begin (), ranks.end ()), ranks.end ());
+        multi_select (first, last, ranks.begin (), ranks.end (), difference_type (0), comp);
+
+        const value_type zero = value_type (0);
+        for (QI q = q_first; q != q_last; ++ q, ++ out) {
+            double h = double (size - 1) * *q;
+            difference_type lower = difference_type (h);
+            difference_type upper = lower + 1 < size ? lower + 1 : lower;
+            double frac = h - double (lower);
+            const value_type &x_lower = lower < zeros ? zero : first [lower - zeros];
+            const value_type &x_upper = upper < zeros ? zero : first [upper - zeros];
+            switch (method) {
+            case quantile_lower:
+                *out = x_lower;
+                break;
+            case quantile_higher:
+                *out = frac > 0 ? x_upper : x_lower;
+                break;
+            case quantile_nearest:
+                // Ties go to the even rank
+                *out = (frac > 0.5 || (frac == 0.5 && lower % 2)) ? x_upper : x_lower;
+                break;
+            case quantile_midpoint:
+                *out = frac > 0 ? value_type ((x_lower + x_upper) / 2) : x_lower;
+                break;
+            default:
+                *out = value_type ((1 - frac) * x_lower + frac * x_upper);
             }
-            return min_val;
         }
-        // Sparse case
+    }
+
+    template<class I, class QI, class OI, class C>
+    BOOST_UBLAS_INLINE
+    void select_quantiles (I first, I last, QI q_first, QI q_last, OI out, quantile_interpolation method, C comp) {
+        select_quantiles (first, last, typename std::iterator_traits<I>::difference_type (0), q_first, q_last, out, method, comp);
+    }
+
+    template<class I, class C>
+    BOOST_UBLAS_INLINE
+    typename std::iterator_traits<I>::value_type
+    select_quantile (I first, I last, typename std::iterator_traits<I>::difference_type zeros, double q, quantile_interpolation method, C comp) {
+        typename std::iterator_traits<I>::value_type t;
+        select_quantiles (first, last, zeros, &q, &q + 1, &t, method, comp);
+        return t;
+    }
+
+    template<class I, class C>
+    BOOST_UBLAS_INLINE
+    typename std::iterator_traits<I>::value_type
+    select_quantile (I first, I last, double q, quantile_interpolation method, C comp) {
+        return select_quantile (first, last, typename std::iterator_traits<I>::difference_type (0), q, method, comp);
+    }
+
+    // Robust statistics by selection. Unlike median and quantile they order
+    // by value, and the location of mad is the value ordered median. Each
+    // reorders [first, last) and needs at most two partitions of it.
+
+    // Median absolute deviation from the median, unscaled
+    template<class I>
+    BOOST_UBLAS_INLINE
+    typename std::iterator_traits<I>::value_type
+    select_mad (I first, I last) {
+        typedef typename std::iterator_traits<I>::value_type value_type;
+        BOOST_UBLAS_CHECK (first != last, bad_size ());
+        value_type center (select_median (first, last, std::less<value_type> ()));
+        for (I it = first; it != last; ++ it)
+            *it = type_traits<value_type>::type_abs (*it - center);
+        return select_median (first, last, std::less<value_type> ());
+    }
+
+    // Distance between the linear 0.75 and 0.25 quantiles
+    template<class I>
+    BOOST_UBLAS_INLINE
+    typename std::iterator_traits<I>::value_type
+    select_iqr (I first, I last) {
+        typedef typename std::iterator_traits<I>::value_type value_type;
+        const double q [2] = {0.25, 0.75};
+        value_type t [2];
+        select_quantiles (first, last, q, q + 2, t, quantile_linear, std::less<value_type> ());
+        return t [1] - t [0];
+    }
+
+    // Mean of the elements left after cutting floor (frac size) elements
+    // from each end, with 0 <= frac < 0.5. The two cut points are selected,
+    // and the elements between them are summed in place.
+    template<class I>
+    BOOST_UBLAS_INLINE
+    typename std::iterator_traits<I>::value_type
+    select_trimmed_mean (I first, I last, double frac) {
+        typedef typename std::iterator_traits<I>::difference_type difference_type;
+        typedef typename std::iterator_traits<I>::value_type value_type;
+        BOOST_UBLAS_CHECK (frac >= 0. && frac < 0.5, bad_argument ());
+        BOOST_UBLAS_CHECK (first != last, bad_size ());
+        difference_type size (last - first);
+        difference_type cut (difference_type (frac * double (size)));
+        if (cut > difference_type (0)) {
+            const difference_type ranks [2] = {cut, size - cut - 1};
+            multi_select (first, last, ranks, ranks + (ranks [0] < ranks [1] ? 2 : 1), difference_type (0), std::less<value_type> ());
+        }
+        value_type t = value_type (0);
+        for (I it = first + cut; it != last - cut; ++ it)
+            t += *it;
+        return t / value_type (size - 2 * cut);
+    }
+
+    // Limits of winsorize: the order statistics of ranks floor (lo size)
+    // and size - 1 - floor (hi size), with lo, hi >= 0 and lo + hi < 1
+    template<class I>
+    BOOST_UBLAS_INLINE
+    void select_winsor_limits (I first, I last, double lo, double hi,
+                               typename std::iterator_traits<I>::value_type &lower,
+                               typename std::iterator_traits<I>::value_type &upper) {
+        typedef typename std::iterator_traits<I>::difference_type difference_type;
+        typedef typename std::iterator_traits<I>::value_type value_type;
+        BOOST_UBLAS_CHECK (lo >= 0. && hi >= 0. && lo + hi < 1., bad_argument ());
+        BOOST_UBLAS_CHECK (first != last, bad_size ());
+        difference_type size (last - first);
+        const difference_type ranks [2] = {difference_type (lo * double (size)),
+                                           size - 1 - difference_type (hi * double (size))};
+        multi_select (first, last, ranks, ranks + (ranks [0] < ranks [1] ? 2 : 1), difference_type (0), std::less<value_type> ());
+        lower = first [ranks [0]];
+        upper = first [ranks [1]];
+    }
+
+    // The selections above as statistics of a scratch range, applied by
+    // vector_robust and matrix_robust_axis
+    struct mad_statistic {
         template<class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            result_type min_val = *it;
-            typedef typename I::difference_type vector_difference_type;
-            vector_difference_type size (0);
-            while (it != it_end) {
-                if ( type_traits<value_type>::type_abs(min_val) > type_traits<value_type>::type_abs(*it) )
-                    min_val = *it;
-                ++ it;
-                ++ size;
-            }
-            return min_val;
+        BOOST_UBLAS_INLINE
+        typename std::iterator_traits<I>::value_type operator () (I first, I last) const {
+            return select_mad (first, last);
         }
     };
 
-    template<class V>
-    struct vector_max:
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
-
-        template<class E>
-        static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) { 
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            result_type max_val = result_type (e () (vector_size_type (0)));
-            for (vector_size_type i = 0; i < size; ++ i)
-                if ( type_traits<value_type>::type_abs(max_val) < type_traits<value_type>::type_abs(e () (i)) )
-                    max_val = e () (i);
-            return max_val;
-        }
-        // Dense case
-        template<class D, class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            result_type max_val = *it;
-            while (-- size >= 0) {
-                if ( type_traits<value_type>::type_abs(max_val) < type_traits<value_type>::type_abs(*it) )
-                    max_val = *it;
-                ++ it;
-            }
-            return max_val;
+    struct iqr_statistic {
+        template<class I>
+        BOOST_UBLAS_INLINE
+        typename std::iterator_traits<I>::value_type operator () (I first, I last) const {
+            return select_iqr (first, last);
         }
-        // Sparse case
+    };
+
+    struct trimmed_mean_statistic {
+        BOOST_UBLAS_INLINE
+        explicit trimmed_mean_statistic (double frac):
+            frac (frac) {}
+
         template<class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            result_type max_val = *it;
-            typedef typename I::difference_type vector_difference_type;
-            vector_difference_type size (0);
-            while (it != it_end) {
-                if ( type_traits<value_type>::type_abs(max_val) < type_traits<value_type>::type_abs(*it) )
-                    max_val = *it;
-                ++ it;
-                ++ size;
-            }
-            return max_val;
+        BOOST_UBLAS_INLINE
+        typename std::iterator_traits<I>::value_type operator () (I first, I last) const {
+            return select_trimmed_mean (first, last, frac);
         }
+
+        double frac;
     };
 
-    template<class V>
-    struct vector_sum:
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+    // Expressions backed by one contiguous float or double unbounded_array.
+    // With BOOST_UBLAS_USE_SIMD the chunked reductions below hand their
+    // storage to the kernels of detail/simd_reduce.hpp.
+    template<class E>
+    struct contiguous_storage {
+        BOOST_STATIC_CONSTANT (bool, value = false);
+    };
 
-        template<class E>
+#ifdef BOOST_UBLAS_USE_SIMD
+    template<class T>
+    struct contiguous_value_type {
+        BOOST_STATIC_CONSTANT (bool, value = false);
+    };
+    template<>
+    struct contiguous_value_type<float> {
+        BOOST_STATIC_CONSTANT (bool, value = true);
+    };
+    template<>
+    struct contiguous_value_type<double> {
+        BOOST_STATIC_CONSTANT (bool, value = true);
+    };
+
+    template<class T, class A>
+    struct contiguous_storage<vector<T, unbounded_array<T, A> > > {
+        BOOST_STATIC_CONSTANT (bool, value = contiguous_value_type<T>::value);
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) { 
-            result_type t = result_type (0);
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            for (vector_size_type i = 0; i < size; ++ i)
-                t += e () (i);
-            return t;
+        const T *data (const vector<T, unbounded_array<T, A> > &v) {
+            return v.data ().begin ();
         }
-        // Dense case
-        template<class D, class I>
+    };
+    template<class T, class L, class A>
+    struct contiguous_storage<matrix<T, L, unbounded_array<T, A> > > {
+        BOOST_STATIC_CONSTANT (bool, value = contiguous_value_type<T>::value);
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            result_type t = result_type (0);
-            while (-- size >= 0) {
-                t += *it;
-                ++ it;
-            }
-            return t; 
+        const T *data (const matrix<T, L, unbounded_array<T, A> > &m) {
+            return m.data ().begin ();
         }
-        // Sparse case
-        template<class I>
+    };
+    template<class V>
+    struct contiguous_storage<vector_reference<V> > {
+        typedef typename boost::remove_const<V>::type referred_type;
+        BOOST_STATIC_CONSTANT (bool, value = contiguous_storage<referred_type>::value);
         static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            result_type t = result_type (0);
-            while (it != it_end) {
-                t += *it;
-                ++ it;
-            }
-            return t; 
+        const typename V::value_type *data (const vector_reference<V> &v) {
+            return contiguous_storage<referred_type>::data (v.expression ());
+        }
+    };
+    template<class M>
+    struct contiguous_storage<matrix_reference<M> > {
+        typedef typename boost::remove_const<M>::type referred_type;
+        BOOST_STATIC_CONSTANT (bool, value = contiguous_storage<referred_type>::value);
+        static BOOST_UBLAS_INLINE
+        const typename M::value_type *data (const matrix_reference<M> &m) {
+            return contiguous_storage<referred_type>::data (m.expression ());
         }
     };
+#endif
 
-    template<class V>
-    struct vector_mean: 
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
-        // typedef double result_type;
+    // Mergeable partial results of the chunked reductions below. Chunks are
+    // merged in order, so one chunk gives the plain sequential result.
+    template<class T>
+    struct sum_partial {
+        typedef T value_type;
 
-        template<class E>
-        static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) { 
-            result_type t = result_type (0);
-            // std::cout << t << std::endl;
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            for (vector_size_type i = 0; i < size; ++ i)
-                t += e () (i);
-            return t / size;
+        BOOST_UBLAS_INLINE
+        sum_partial ():
+            sum (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            sum += x;
         }
-        // Dense case
-        template<class D, class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            result_type t = result_type (0);
-            while (-- size >= 0) {
-                t += *it;
-                ++ it;
-            }
-            return t / size; 
+        BOOST_UBLAS_INLINE
+        void merge (const sum_partial &p) {
+            sum += p.sum;
         }
-        // Sparse case
-        template<class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            result_type t = result_type (0);
-            typedef typename I::difference_type vector_difference_type;
-            vector_difference_type size (0);
-            while (it != it_end) {
-                t += *it;
-                ++ it;
-                ++ size;
-            }
-            return t / size;
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            for (; first != last; ++ first)
+                sum += *first;
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            sum += detail::contiguous_sum (first, last - first);
+        }
+#endif
+        BOOST_UBLAS_INLINE
+        value_type result () const {
+            return sum;
         }
+
+        value_type sum;
     };
 
-    template<class V>
-    struct vector_mean_iterative: 
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
-        // typedef double result_type;
+#ifndef BOOST_UBLAS_PAIRWISE_BLOCK
+#define BOOST_UBLAS_PAIRWISE_BLOCK 128
+#endif
 
-        template<class E>
-        static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) { 
-            result_type t = result_type (0);
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            for (vector_size_type i = 0; i < size; ++ i)
-                t += (e () (i) - t) / (i + 1);
+    // Blocked pairwise summation: blocks of BOOST_UBLAS_PAIRWISE_BLOCK
+    // elements are summed left to right, and the block sums are added in a
+    // binary tree kept as one pending sum per level, like the carries of a
+    // binary counter. The error grows with log (n) instead of n at about the
+    // cost of the plain sum.
+    template<class T>
+    struct pairwise_sum_partial {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        pairwise_sum_partial ():
+            block (0), filled (0), levels (0) {
+            std::fill (pending, pending + 64, value_type (0));
+        }
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            block += x;
+            if (++ filled == BOOST_UBLAS_PAIRWISE_BLOCK)
+                flush ();
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const pairwise_sum_partial &p) {
+            carry (p.result ());
+        }
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            while (first != last) {
+                std::size_t n ((std::min) (std::size_t (last - first), std::size_t (BOOST_UBLAS_PAIRWISE_BLOCK) - filled));
+                block += block_sum (first, n);
+                first += n;
+                filled += n;
+                if (filled == BOOST_UBLAS_PAIRWISE_BLOCK)
+                    flush ();
+            }
+        }
+        BOOST_UBLAS_INLINE
+        value_type result () const {
+            value_type t (block);
+            for (std::size_t l = 0; l < 64; ++ l)
+                if (levels & (boost::uint64_t (1) << l))
+                    t += pending [l];
             return t;
         }
-        // Dense case
-        template<class D, class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            result_type t = result_type (0);
-            D i (0);
-            while (++i <= size) {
-                t += (*it - t) / i;
-                ++ it;
+
+    private:
+        BOOST_UBLAS_INLINE
+        void flush () {
+            carry (block);
+            block = value_type (0);
+            filled = 0;
+        }
+        BOOST_UBLAS_INLINE
+        void carry (value_type t) {
+            std::size_t l (0);
+            for (; levels & (boost::uint64_t (1) << l); ++ l) {
+                t += pending [l];
+                levels &= ~ (boost::uint64_t (1) << l);
             }
+            pending [l] = t;
+            levels |= boost::uint64_t (1) << l;
+        }
+
+        template<class U>
+        static BOOST_UBLAS_INLINE
+        value_type block_sum (const U *p, std::size_t n) {
+            value_type t (0);
+            for (std::size_t i = 0; i < n; ++ i)
+                t += p [i];
             return t;
         }
+#ifdef BOOST_UBLAS_USE_SIMD
+        static BOOST_UBLAS_INLINE
+        value_type block_sum (const value_type *p, std::size_t n) {
+            return detail::contiguous_sum (p, n);
+        }
+#endif
+
+        value_type block;
+        std::size_t filled;
+        boost::uint64_t levels;
+        value_type pending [64];
+    };
+
+    // Compensated summation: the rounding error of every addition is
+    // recovered exactly (Knuth's two-sum) and carried as a second word that
+    // is renormalized into the sum at each step, so neither long runs of
+    // small terms nor cancellation between large terms lose precision, as
+    // with Kahan and Neumaier's summation
+    template<class T>
+    struct compensated_sum_partial {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        compensated_sum_partial ():
+            sum (0), compensation (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            value_type error (two_sum (sum, x));
+            compensation += error;
+            compensation = two_sum (sum, compensation);
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const compensated_sum_partial &p) {
+            push (p.sum);
+            push (p.compensation);
+        }
+        // Four interleaved sums break the dependency chain of the updates
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            compensated_sum_partial lanes [4];
+            for (; last - first >= 4; first += 4) {
+                lanes [0].push (first [0]);
+                lanes [1].push (first [1]);
+                lanes [2].push (first [2]);
+                lanes [3].push (first [3]);
+            }
+            for (; first != last; ++ first)
+                push (*first);
+            for (std::size_t l = 0; l < 4; ++ l)
+                merge (lanes [l]);
+        }
+        BOOST_UBLAS_INLINE
+        value_type result () const {
+            return sum + compensation;
+        }
+
+        value_type sum;
+        value_type compensation;
+
+    private:
+        // s += x, returning the rounding error of the addition
+        static BOOST_UBLAS_INLINE
+        value_type two_sum (value_type &s, const value_type &x) {
+            value_type t = s + x;
+            value_type x_part = t - s;
+            value_type error = (s - (t - x_part)) + (x - x_part);
+            s = t;
+            return error;
+        }
+    };
+
+    // Summation policies for sum (e, policy) and mean (e, policy). A is the
+    // accumulator type, the value type of the expression when void, so float
+    // data can be summed in double without a converted copy.
+    template<class P>
+    struct summation_policy {};
+
+    template<class A, class T>
+    struct summation_accumulator {
+        typedef A type;
+    };
+    template<class T>
+    struct summation_accumulator<void, T> {
+        typedef T type;
+    };
+
+    template<class A = void>
+    struct naive_summation:
+        public summation_policy<naive_summation<A> > {
+        template<class T>
+        struct partial {
+            typedef sum_partial<typename summation_accumulator<A, T>::type> type;
+        };
+    };
+
+    template<class A = void>
+    struct pairwise_summation:
+        public summation_policy<pairwise_summation<A> > {
+        template<class T>
+        struct partial {
+            typedef pairwise_sum_partial<typename summation_accumulator<A, T>::type> type;
+        };
+    };
+
+    template<class A = void>
+    struct compensated_summation:
+        public summation_policy<compensated_summation<A> > {
+        template<class T>
+        struct partial {
+            typedef compensated_sum_partial<typename summation_accumulator<A, T>::type> type;
+        };
+    };
+
+    // Policy of sum (e) and mean (e)
+#ifdef BOOST_UBLAS_DEFAULT_SUMMATION
+    typedef BOOST_UBLAS_DEFAULT_SUMMATION default_summation;
+#else
+    typedef naive_summation<> default_summation;
+#endif
+
+    // Sums of the elements and of their squares
+    template<class T>
+    struct power_sums_partial {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        power_sums_partial ():
+            sum (0), sumsq (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            sum += x;
+            sumsq += x * x;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const power_sums_partial &p) {
+            sum += p.sum;
+            sumsq += p.sumsq;
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            power_sums_partial p;
+            detail::contiguous_power_sums (first, last - first, p.sum, p.sumsq);
+            merge (p);
+        }
+#endif
+
+        value_type sum;
+        value_type sumsq;
+    };
+
+    // Count, mean and sum of squared deviations: Welford update, and Chan's
+    // pairwise combine to merge
+    template<class T, class S>
+    struct moments_partial {
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        moments_partial ():
+            count (0), mean (0), m2 (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            ++ count;
+            value_type del = x - mean;
+            mean += del / value_type (count);
+            m2 += del * (x - mean);
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const moments_partial &p) {
+            if (p.count == size_type (0))
+                return;
+            size_type n = count + p.count;
+            value_type del = p.mean - mean;
+            mean += del * value_type (p.count) / value_type (n);
+            m2 += p.m2 + del * del * value_type (count) * value_type (p.count) / value_type (n);
+            count = n;
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            moments_partial p;
+            p.count = last - first;
+            detail::contiguous_moments (first, last - first, p.mean, p.m2);
+            merge (p);
+        }
+#endif
+
+        size_type count;
+        value_type mean;
+        value_type m2;
+    };
+
+    // Sum of the weights and of the weighted elements; push takes the
+    // element and its weight
+    template<class T>
+    struct weighted_sum_partial {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        weighted_sum_partial ():
+            weight (0), sum (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x, const value_type &w) {
+            weight += w;
+            sum += w * x;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const weighted_sum_partial &p) {
+            weight += p.weight;
+            sum += p.sum;
+        }
+
+        value_type weight;
+        value_type sum;
+    };
+
+    // Sum of the weights, weighted mean and weighted sum of squared
+    // deviations: West's weighted Welford update, and Chan's combine with
+    // weights in place of counts to merge. Zero weights are skipped.
+    template<class T>
+    struct weighted_moments_partial {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        weighted_moments_partial ():
+            weight (0), mean (0), m2 (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x, const value_type &w) {
+            if (w == value_type (0))
+                return;
+            weight += w;
+            value_type del = x - mean;
+            mean += del * (w / weight);
+            m2 += w * del * (x - mean);
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const weighted_moments_partial &p) {
+            if (p.weight == value_type (0))
+                return;
+            value_type total = weight + p.weight;
+            value_type del = p.mean - mean;
+            mean += del * (p.weight / total);
+            m2 += p.m2 + del * del * (weight * p.weight / total);
+            weight = total;
+        }
+
+        value_type weight;
+        value_type mean;
+        value_type m2;
+    };
+
+    // Count, mean and sums of the second to fourth powers of the deviations:
+    // Terriberry's one-pass update, and Pebay's pairwise combine to merge
+    template<class T, class S>
+    struct higher_moments_partial {
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        higher_moments_partial ():
+            count (0), mean (0), m2 (0), m3 (0), m4 (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            value_type n1 (count);
+            value_type n (++ count);
+            value_type del = x - mean;
+            value_type del_n = del / n;
+            value_type del_n2 = del_n * del_n;
+            value_type term = del * del_n * n1;
+            mean += del_n;
+            m4 += term * del_n2 * (n * n - 3 * n + 3) + 6 * del_n2 * m2 - 4 * del_n * m3;
+            m3 += term * del_n * (n - 2) - 3 * del_n * m2;
+            m2 += term;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const higher_moments_partial &p) {
+            if (p.count == size_type (0))
+                return;
+            value_type na (count);
+            value_type nb (p.count);
+            value_type n (na + nb);
+            value_type del = p.mean - mean;
+            value_type del2 = del * del;
+            m4 += p.m4 + del2 * del2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n) +
+                  6 * del2 * (na * na * p.m2 + nb * nb * m2) / (n * n) + 4 * del * (na * p.m3 - nb * m3) / n;
+            m3 += p.m3 + del2 * del * na * nb * (na - nb) / (n * n) + 3 * del * (na * p.m2 - nb * m2) / n;
+            m2 += p.m2 + del2 * na * nb / n;
+            mean += del * nb / n;
+            count += p.count;
+        }
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            for (; first != last; ++ first)
+                push (*first);
+        }
+
+        size_type count;
+        value_type mean;
+        value_type m2;
+        value_type m3;
+        value_type m4;
+    };
+
+    // Count, mean and sums of the powers 2, ..., order of the deviations, for
+    // an order fixed at construction: Pebay's update for arbitrary order,
+    // pushing a value being the merge of a single value
+    template<class T, class S>
+    struct central_moments_partial {
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit central_moments_partial (size_type order = 4):
+            count (0), mean (0), m (order + 1, value_type (0)) {}
+
+        BOOST_UBLAS_INLINE
+        size_type order () const {
+            return m.size () - 1;
+        }
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (count == size_type (0)) {
+                count = 1;
+                mean = x;
+                return;
+            }
+            value_type na (count);
+            value_type n (na + 1);
+            value_type del = x - mean;
+            // Descending orders, so m [p - k] still holds the old sums
+            for (size_type p = order (); p >= 2; -- p) {
+                value_type sum (0);
+                value_type binomial (1);
+                value_type power (1);
+                for (size_type k = 1; k + 2 <= p; ++ k) {
+                    binomial = binomial * value_type (p - k + 1) / value_type (k);
+                    power *= - del / n;
+                    sum += binomial * power * m [p - k];
+                }
+                m [p] += sum + power_of (na * del / n, p) * (value_type (1) - power_of (value_type (-1) / na, p - 1));
+            }
+            mean += del / n;
+            ++ count;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const central_moments_partial &q) {
+            if (q.count == size_type (0))
+                return;
+            if (count == size_type (0)) {
+                *this = q;
+                return;
+            }
+            BOOST_UBLAS_CHECK (order () == q.order (), bad_argument ());
+            value_type na (count);
+            value_type nb (q.count);
+            value_type n (na + nb);
+            value_type del = q.mean - mean;
+            for (size_type p = order (); p >= 2; -- p) {
+                value_type sum (0);
+                value_type binomial (1);
+                value_type power_a (1);
+                value_type power_b (1);
+                for (size_type k = 1; k + 2 <= p; ++ k) {
+                    binomial = binomial * value_type (p - k + 1) / value_type (k);
+                    power_a *= - nb * del / n;
+                    power_b *= na * del / n;
+                    sum += binomial * (power_a * m [p - k] + power_b * q.m [p - k]);
+                }
+                m [p] += q.m [p] + sum + power_of (na * nb * del / n, p) *
+                         (value_type (1) / power_of (nb, p - 1) - power_of (value_type (-1) / na, p - 1));
+            }
+            mean += del * nb / n;
+            count += q.count;
+        }
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            for (; first != last; ++ first)
+                push (*first);
+        }
+
+        size_type count;
+        value_type mean;
+        std::vector<value_type> m;
+
+    private:
+        static BOOST_UBLAS_INLINE
+        value_type power_of (value_type x, size_type k) {
+            value_type r (1);
+            for (; k > size_type (0); -- k)
+                r *= x;
+            return r;
+        }
+    };
+
+    // Magnitude ordered extremum as in vector_min (Compare is std::greater)
+    // and vector_max (Compare is std::less); ties keep the first element.
+    // As in the element loop of vector_min, a leading NaN is the value and
+    // later NaNs are skipped. best holds the extremum of the other elements,
+    // so that a chunk starting with a NaN still merges its elements.
+    template<class T, class Compare>
+    struct extremum_partial {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        extremum_partial ():
+            empty (true), found (false), value (0), best (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (x != x) {
+                if (empty)
+                    value = x;
+                empty = false;
+                return;
+            }
+            if (! found || Compare () (type_traits<value_type>::type_abs (best), type_traits<value_type>::type_abs (x))) {
+                best = x;
+                found = true;
+            }
+            if (empty || value == value)
+                value = best;
+            empty = false;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const extremum_partial &p) {
+            if (p.empty)
+                return;
+            if (p.value != p.value)
+                push (p.value);
+            if (p.found)
+                push (p.best);
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        // The kernel skips NaNs and finds the extreme magnitude, then the
+        // first element that has it
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            if (first == last)
+                return;
+            push (*first);
+            value_type amin, amax, asum, sumsq;
+            detail::contiguous_abs_stats (first, last - first, amin, amax, asum, sumsq);
+            value_type a (Compare () (value_type (1), value_type (0)) ? amin : amax);
+            while (first != last - 1 && type_traits<value_type>::type_abs (*first) != a)
+                ++ first;
+            push (*first);
+        }
+#endif
+
+        bool empty;
+        bool found;
+        value_type value;
+        value_type best;
+    };
+
+    // NaN aware partials: the elements that are NaN are skipped and counted
+    // apart, so seen () is the number of elements pushed. The implicit
+    // zeros of a sparse slice are then the remaining ones, which push_zeros
+    // adds. With no valid element the value is NaN.
+    struct nan_mean_tag {};
+    struct nan_variance_tag {};
+
+    // Count, mean and sum of squared deviations of the valid elements, as
+    // moments_partial. The SIMD kernel masks the NaN lanes out of the
+    // update instead of branching on them.
+    template<class T, class S>
+    struct nan_moments_partial {
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        nan_moments_partial ():
+            count (0), nans (0), mean (0), m2 (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (x != x) {
+                ++ nans;
+                return;
+            }
+            ++ count;
+            value_type del = x - mean;
+            mean += del / value_type (count);
+            m2 += del * (x - mean);
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const nan_moments_partial &p) {
+            nans += p.nans;
+            if (p.count == size_type (0))
+                return;
+            size_type n = count + p.count;
+            value_type del = p.mean - mean;
+            mean += del * value_type (p.count) / value_type (n);
+            m2 += p.m2 + del * del * value_type (count) * value_type (p.count) / value_type (n);
+            count = n;
+        }
+        BOOST_UBLAS_INLINE
+        void push_zeros (size_type n) {
+            nan_moments_partial p;
+            p.count = n;
+            merge (p);
+        }
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            for (; first != last; ++ first)
+                push (*first);
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        // The kernel keeps its lane counts as value_type, so long ranges
+        // go in blocks that float counts hold exactly
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            while (first != last) {
+                std::size_t n ((std::min) (std::size_t (last - first), std::size_t (1) << 22));
+                nan_moments_partial p;
+                std::size_t c;
+                detail::contiguous_nan_moments (first, n, c, p.mean, p.m2);
+                p.count = c;
+                p.nans = n - c;
+                merge (p);
+                first += n;
+            }
+        }
+#endif
+
+        BOOST_UBLAS_INLINE
+        size_type seen () const {
+            return count + nans;
+        }
+        BOOST_UBLAS_INLINE
+        value_type value (nan_mean_tag) const {
+            return count > size_type (0) ? mean : std::numeric_limits<value_type>::quiet_NaN ();
+        }
+        BOOST_UBLAS_INLINE
+        value_type value (nan_variance_tag) const {
+            return count > size_type (0) ? m2 / value_type (count) : std::numeric_limits<value_type>::quiet_NaN ();
+        }
+
+        size_type count;
+        size_type nans;
+        value_type mean;
+        value_type m2;
+    };
+
+    // Magnitude ordered extremum of the valid elements, as extremum_partial
+    template<class T, class Compare, class S>
+    struct nan_extremum_partial {
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        nan_extremum_partial ():
+            count (0), nans (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (x != x) {
+                ++ nans;
+                return;
+            }
+            ++ count;
+            extremum.push (x);
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const nan_extremum_partial &p) {
+            count += p.count;
+            nans += p.nans;
+            extremum.merge (p.extremum);
+        }
+        BOOST_UBLAS_INLINE
+        void push_zeros (size_type n) {
+            if (n == size_type (0))
+                return;
+            count += n;
+            extremum.push (value_type (0));
+        }
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            for (; first != last; ++ first)
+                push (*first);
+        }
+
+        BOOST_UBLAS_INLINE
+        size_type seen () const {
+            return count + nans;
+        }
+        BOOST_UBLAS_INLINE
+        value_type value () const {
+            return count > size_type (0) ? extremum.value : std::numeric_limits<value_type>::quiet_NaN ();
+        }
+
+        size_type count;
+        size_type nans;
+        extremum_partial<value_type, Compare> extremum;
+    };
+
+    // Smallest and largest element by value, as needed for binning; NaNs
+    // are skipped
+    template<class T>
+    struct range_partial {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        range_partial ():
+            empty (true), lo (0), hi (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (empty) {
+                if (x == x) {
+                    lo = hi = x;
+                    empty = false;
+                }
+                return;
+            }
+            if (x < lo)
+                lo = x;
+            if (x > hi)
+                hi = x;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const range_partial &p) {
+            if (! p.empty) {
+                push (p.lo);
+                push (p.hi);
+            }
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            range_partial p;
+            detail::contiguous_range (first, last - first, p.lo, p.hi);
+            p.empty = ! (p.lo <= p.hi);
+            merge (p);
+        }
+#endif
+
+        bool empty;
+        value_type lo;
+        value_type hi;
+    };
+
+    // Sums of the element norms for vector_norm_1 and of their squares for
+    // vector_norm_2, and their maximum for vector_norm_inf
+    template<class T>
+    struct norm_1_partial {
+        typedef T value_type;
+        typedef typename type_traits<value_type>::real_type real_type;
+
+        BOOST_UBLAS_INLINE
+        norm_1_partial ():
+            t (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            t += type_traits<value_type>::type_abs (x);
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const norm_1_partial &p) {
+            t += p.t;
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            value_type amin, amax, asum, sumsq;
+            detail::contiguous_abs_stats (first, last - first, amin, amax, asum, sumsq);
+            t += asum;
+        }
+#endif
+
+        real_type t;
+    };
+
+    template<class T>
+    struct norm_2_partial {
+        typedef T value_type;
+        typedef typename type_traits<value_type>::real_type real_type;
+
+        BOOST_UBLAS_INLINE
+        norm_2_partial ():
+            t (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            real_type u (type_traits<value_type>::norm_2 (x));
+            t += u * u;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const norm_2_partial &p) {
+            t += p.t;
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            value_type sum, sumsq;
+            detail::contiguous_power_sums (first, last - first, sum, sumsq);
+            t += sumsq;
+        }
+#endif
+
+        real_type t;
+    };
+
+    template<class T>
+    struct norm_inf_partial {
+        typedef T value_type;
+        typedef typename type_traits<value_type>::real_type real_type;
+
+        BOOST_UBLAS_INLINE
+        norm_inf_partial ():
+            t (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            real_type u (type_traits<value_type>::norm_inf (x));
+            if (u > t)
+                t = u;
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const norm_inf_partial &p) {
+            if (p.t > t)
+                t = p.t;
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            value_type amin, amax, asum, sumsq;
+            detail::contiguous_abs_stats (first, last - first, amin, amax, asum, sumsq);
+            if (amax > t)
+                t = amax;
+        }
+#endif
+
+        real_type t;
+    };
+
+    // Pushes e (i) for the indices of chunk c into partial c
+    template<class E, class P>
+    class vector_reduce_kernel {
+    public:
+        typedef typename E::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        vector_reduce_kernel (const E &e, const P &init, std::vector<P> &partials):
+            e_ (e), init_ (init), partials_ (partials) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type c, size_type first, size_type last) const {
+            P p (init_);
+            sweep (p, first, last, boost::mpl::bool_<contiguous_storage<E>::value> ());
+            partials_ [c] = p;
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        void sweep (P &p, size_type first, size_type last, boost::mpl::false_) const {
+            for (size_type i = first; i < last; ++ i)
+                p.push (e_ (i));
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void sweep (P &p, size_type first, size_type last, boost::mpl::true_) const {
+            const typename E::value_type *data = contiguous_storage<E>::data (e_);
+            p.push_range (data + first, data + last);
+        }
+#endif
+
+        const E &e_;
+        const P &init_;
+        std::vector<P> &partials_;
+    };
+
+    // Reduce all elements of e into copies of the partial init, in parallel
+    // chunks when BOOST_UBLAS_PARALLEL_REDUCTIONS is defined and e is a
+    // splittable_expression
+    template<class P, class E>
+    BOOST_UBLAS_INLINE
+    P vector_reduce (const vector_expression<E> &e, const P &init) {
+        typedef typename E::size_type vector_size_type;
+        vector_size_type size (e ().size ());
+        vector_size_type chunks (detail::expression_chunks<E> (size));
+        std::vector<P> partials (chunks, init);
+        vector_reduce_kernel<E, P> kernel (e (), init, partials);
+        detail::reduce_chunks (size, chunks, kernel);
+        for (vector_size_type c = 1; c < chunks; ++ c)
+            partials [0].merge (partials [c]);
+        return partials [0];
+    }
+    template<class P, class E>
+    BOOST_UBLAS_INLINE
+    P vector_reduce (const vector_expression<E> &e) {
+        return vector_reduce (e, P ());
+    }
+
+    // Pushes (e (i), w (i)) for the indices of chunk c into partial c
+    template<class E, class W, class P>
+    class vector_weighted_reduce_kernel {
+    public:
+        typedef typename E::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        vector_weighted_reduce_kernel (const E &e, const W &w, std::vector<P> &partials):
+            e_ (e), w_ (w), partials_ (partials) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type c, size_type first, size_type last) const {
+            P p;
+            for (size_type i = first; i < last; ++ i)
+                p.push (e_ (i), w_ (i));
+            partials_ [c] = p;
+        }
+
+    private:
+        const E &e_;
+        const W &w_;
+        std::vector<P> &partials_;
+    };
+
+    // Reduce the elements of e with the weights w into a partial P in one
+    // traversal of both, in parallel chunks as vector_reduce
+    template<class P, class E, class W>
+    BOOST_UBLAS_INLINE
+    P vector_weighted_reduce (const vector_expression<E> &e, const vector_expression<W> &w) {
+        typedef typename E::size_type vector_size_type;
+        vector_size_type size (BOOST_UBLAS_SAME (e ().size (), w ().size ()));
+        vector_size_type chunks (detail::splittable_expression<W>::value ? detail::expression_chunks<E> (size) : vector_size_type (1));
+        std::vector<P> partials (chunks);
+        vector_weighted_reduce_kernel<E, W, P> kernel (e (), w (), partials);
+        detail::reduce_chunks (size, chunks, kernel);
+        for (vector_size_type c = 1; c < chunks; ++ c)
+            partials [0].merge (partials [c]);
+        return partials [0];
+    }
+
+    // Pushes the elements of the rows (row major) or columns (column major)
+    // of chunk c into partial c
+    template<class E, class P>
+    class matrix_reduce_kernel {
+    public:
+        typedef typename E::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        matrix_reduce_kernel (const E &e, const P &init, std::vector<P> &partials):
+            e_ (e), init_ (init), partials_ (partials) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type c, size_type first, size_type last) const {
+            P p (init_);
+            sweep (p, first, last, boost::mpl::bool_<contiguous_storage<E>::value> ());
+            partials_ [c] = p;
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        void sweep (P &p, size_type first, size_type last, boost::mpl::false_) const {
+            sweep (p, first, last, typename E::orientation_category ());
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        // Whole rows (row major) or columns (column major) are contiguous
+        BOOST_UBLAS_INLINE
+        void sweep (P &p, size_type first, size_type last, boost::mpl::true_) const {
+            size_type inner (boost::is_same<typename E::orientation_category, column_major_tag>::value ?
+                             e_.size1 () : e_.size2 ());
+            const typename E::value_type *data = contiguous_storage<E>::data (e_);
+            p.push_range (data + first * inner, data + last * inner);
+        }
+#endif
+        BOOST_UBLAS_INLINE
+        void sweep (P &p, size_type first, size_type last, row_major_tag) const {
+            size_type size2 (e_.size2 ());
+            for (size_type i = first; i < last; ++ i)
+                for (size_type j = 0; j < size2; ++ j)
+                    p.push (e_ (i, j));
+        }
+        BOOST_UBLAS_INLINE
+        void sweep (P &p, size_type first, size_type last, column_major_tag) const {
+            size_type size1 (e_.size1 ());
+            for (size_type j = first; j < last; ++ j)
+                for (size_type i = 0; i < size1; ++ i)
+                    p.push (e_ (i, j));
+        }
+        BOOST_UBLAS_INLINE
+        void sweep (P &p, size_type first, size_type last, unknown_orientation_tag) const {
+            sweep (p, first, last, row_major_tag ());
+        }
+
+        const E &e_;
+        const P &init_;
+        std::vector<P> &partials_;
+    };
+
+    template<class P, class E>
+    BOOST_UBLAS_INLINE
+    P matrix_reduce (const matrix_expression<E> &e, const P &init) {
+        typedef typename E::size_type matrix_size_type;
+        matrix_size_type outer (boost::is_same<typename E::orientation_category, column_major_tag>::value ?
+                                e ().size2 () : e ().size1 ());
+        matrix_size_type chunks (detail::expression_chunks<E> (e ().size1 () * e ().size2 ()));
+        if (chunks > outer)
+            chunks = outer > matrix_size_type (0) ? outer : matrix_size_type (1);
+        std::vector<P> partials (chunks, init);
+        matrix_reduce_kernel<E, P> kernel (e (), init, partials);
+        detail::reduce_chunks (outer, chunks, kernel);
+        for (matrix_size_type c = 1; c < chunks; ++ c)
+            partials [0].merge (partials [c]);
+        return partials [0];
+    }
+    template<class P, class E>
+    BOOST_UBLAS_INLINE
+    P matrix_reduce (const matrix_expression<E> &e) {
+        return matrix_reduce (e, P ());
+    }
+
+    // Most frequent value of a set of values and a number of implicit zeros;
+    // ties go to the smallest magnitude, then to the smallest value, so every
+    // strategy picks the same mode. Integral values of a small range
+    // are counted in an array. Other 32 and 64 bit arithmetic values are
+    // counted in a hash map while they take few distinct values, and
+    // otherwise grouped by a radix sort of their bits and counted run by
+    // run. Anything else is counted in the hash map. The scratch storage of
+    // every strategy is kept between calls, so one engine serves all the
+    // slices of an axis.
+    template<class T, class S>
+    class mode_engine {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        // Values for the next call of mode ()
+        BOOST_UBLAS_INLINE
+        std::vector<value_type> &values () {
+            return values_;
+        }
+
+        // Mode of values () and zeros implicit zeros; values () is emptied
+        BOOST_UBLAS_INLINE
+        value_type mode (size_type zeros = size_type (0)) {
+            best_ = value_type (0);
+            best_count_ = size_type (0);
+            count (zeros, strategy ());
+            values_.clear ();
+            return best_;
+        }
+
+    private:
+        struct counting_tag {};
+        struct radix_tag {};
+        struct hash_tag {};
+
+        typedef typename boost::mpl::if_c<boost::is_integral<value_type>::value,
+                                          counting_tag,
+                                          typename boost::mpl::if_c<boost::is_floating_point<value_type>::value &&
+                                                                    (sizeof (value_type) == 4 || sizeof (value_type) == 8),
+                                                                    radix_tag,
+                                                                    hash_tag>::type>::type strategy;
+
+        BOOST_UBLAS_INLINE
+        void consider (const value_type &x, size_type c) {
+            if (c > best_count_ || (c == best_count_ && magnitude_less (x, best_))) {
+                best_ = x;
+                best_count_ = c;
+            }
+        }
+
+        // Counting array over [lo, hi] when the range is at most a few times
+        // the number of values (always for 8 and 16 bit types), otherwise
+        // the radix path
+        BOOST_UBLAS_INLINE
+        void count (size_type zeros, counting_tag) {
+            if (values_.empty ()) {
+                consider (value_type (0), zeros);
+                return;
+            }
+            value_type lo (*std::min_element (values_.begin (), values_.end ()));
+            value_type hi (*std::max_element (values_.begin (), values_.end ()));
+            if (zeros > size_type (0)) {
+                lo = (std::min) (lo, value_type (0));
+                hi = (std::max) (hi, value_type (0));
+            }
+            boost::uintmax_t range (boost::uintmax_t (hi) - boost::uintmax_t (lo));
+            if (sizeof (value_type) >= 4 && sizeof (value_type) <= 8 &&
+                range >= (std::max) (boost::uintmax_t (4) * values_.size (), boost::uintmax_t (1024))) {
+                count (zeros, radix_tag ());
+                return;
+            }
+            counts_.assign (std::size_t (range) + 1, size_type (0));
+            for (std::size_t i = 0; i < values_.size (); ++ i)
+                ++ counts_ [std::size_t (boost::uintmax_t (values_ [i]) - boost::uintmax_t (lo))];
+            if (zeros > size_type (0))
+                counts_ [std::size_t (boost::uintmax_t (0) - boost::uintmax_t (lo))] += zeros;
+            for (std::size_t i = 0; i < counts_.size (); ++ i)
+                if (counts_ [i] > size_type (0))
+                    consider (value_type (boost::uintmax_t (lo) + i), counts_ [i]);
+        }
+
+        BOOST_UBLAS_INLINE
+        void count (size_type zeros, radix_tag) {
+            if (hash_count (zeros, std::size_t (1024)))
+                return;
+            if (sizeof (value_type) == 4)
+                radix_count<boost::uint32_t> (zeros);
+            else
+                radix_count<boost::uint64_t> (zeros);
+        }
+
+        // Sort the bit patterns of the values byte by byte, skipping bytes
+        // that all values share, then count runs of equal values. Equal bit
+        // patterns are equal values once negative zeros are folded into zero.
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void radix_count (size_type zeros) {
+            std::size_t n (values_.size ());
+            keys_.resize (n);
+            scratch_.resize (n);
+            U *keys = reinterpret_cast<U *> (keys_.empty () ? 0 : &keys_ [0]);
+            U *scratch = reinterpret_cast<U *> (scratch_.empty () ? 0 : &scratch_ [0]);
+            for (std::size_t i = 0; i < n; ++ i) {
+                value_type x (values_ [i] == value_type (0) ? value_type (0) : values_ [i]);
+                std::memcpy (keys + i, &x, sizeof (U));
+            }
+            // The histograms of all bytes are taken in one pass
+            std::size_t buckets [sizeof (U)] [256];
+            std::fill (&buckets [0] [0], &buckets [0] [0] + sizeof (U) * 256, std::size_t (0));
+            for (std::size_t i = 0; i < n; ++ i)
+                for (std::size_t byte = 0; byte < sizeof (U); ++ byte)
+                    ++ buckets [byte] [(keys [i] >> (8 * byte)) & 0xff];
+            for (std::size_t byte = 0; byte < sizeof (U); ++ byte) {
+                std::size_t shift (8 * byte);
+                if (n == 0 || buckets [byte] [(keys [0] >> shift) & 0xff] == n)
+                    continue;
+                std::size_t offset (0);
+                for (std::size_t b = 0; b < 256; ++ b) {
+                    std::size_t c (buckets [byte] [b]);
+                    buckets [byte] [b] = offset;
+                    offset += c;
+                }
+                for (std::size_t i = 0; i < n; ++ i)
+                    scratch [buckets [byte] [(keys [i] >> shift) & 0xff] ++] = keys [i];
+                std::swap (keys, scratch);
+            }
+            bool zero_seen (false);
+            for (std::size_t i = 0; i < n;) {
+                value_type x;
+                std::memcpy (&x, keys + i, sizeof (U));
+                std::size_t j (i + 1);
+                while (j < n && keys [j] == keys [i] && x == x)
+                    ++ j;
+                size_type c (j - i);
+                if (x == value_type (0)) {
+                    c += zeros;
+                    zero_seen = true;
+                }
+                consider (x, c);
+                i = j;
+            }
+            if (! zero_seen && zeros > size_type (0))
+                consider (value_type (0), zeros);
+        }
+
+        BOOST_UBLAS_INLINE
+        void count (size_type zeros, hash_tag) {
+            hash_count (zeros, values_.size () + 1);
+        }
+
+        // Count in the hash map unless more than limit distinct values show
+        // up, in which case nothing is counted and false is returned
+        BOOST_UBLAS_INLINE
+        bool hash_count (size_type zeros, std::size_t limit) {
+            map_.clear ();
+            for (std::size_t i = 0; i < values_.size (); ++ i) {
+                ++ map_ [values_ [i]];
+                if (map_.size () > limit)
+                    return false;
+            }
+            if (zeros > size_type (0))
+                map_ [value_type (0)] += zeros;
+            typename map_type::const_iterator p;
+            for (p = map_.begin (); p != map_.end (); ++ p)
+                consider (p->first, p->second);
+            return true;
+        }
+
+        typedef boost::unordered_map<value_type, size_type> map_type;
+
+        std::vector<value_type> values_;
+        std::vector<size_type> counts_;
+        std::vector<boost::uint64_t> keys_;
+        std::vector<boost::uint64_t> scratch_;
+        map_type map_;
+        value_type best_;
+        size_type best_count_;
+    };
+
+    // Dense group numbers for a vector of keys. Element i belongs to group
+    // group (i), the rank of its key among the distinct keys. keys () holds
+    // those keys in ascending order. Integral keys with a small range are
+    // numbered through a table over the range. Other keys go through a hash
+    // map, and then only the distinct keys are sorted. One index can serve
+    // any number of group_reduce calls over the same keys.
+    template<class K>
+    class group_index {
+    public:
+        typedef K key_type;
+        typedef std::size_t size_type;
+
+        template<class E>
+        BOOST_UBLAS_INLINE
+        explicit group_index (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            std::vector<key_type> keys (size);
+            for (vector_size_type i = 0; i < size; ++ i)
+                keys [i] = e () (i);
+            group_.resize (size);
+            build (keys, strategy ());
+        }
+
+        // Number of keyed elements
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return group_.size ();
+        }
+        // Number of groups
+        BOOST_UBLAS_INLINE
+        size_type groups () const {
+            return keys_.size ();
+        }
+        BOOST_UBLAS_INLINE
+        const std::vector<key_type> &keys () const {
+            return keys_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type group (size_type i) const {
+            return group_ [i];
+        }
+
+    private:
+        struct table_tag {};
+        struct hash_tag {};
+
+        typedef typename boost::mpl::if_c<boost::is_integral<key_type>::value, table_tag, hash_tag>::type strategy;
+
+        // Table over [lo, hi] when the range is at most a few times the number
+        // of keys, otherwise the hash map
+        BOOST_UBLAS_INLINE
+        void build (const std::vector<key_type> &keys, table_tag) {
+            if (keys.empty ())
+                return;
+            key_type lo (*std::min_element (keys.begin (), keys.end ()));
+            key_type hi (*std::max_element (keys.begin (), keys.end ()));
+            boost::uintmax_t range (boost::uintmax_t (hi) - boost::uintmax_t (lo));
+            if (range >= (std::max) (boost::uintmax_t (4) * keys.size (), boost::uintmax_t (1024))) {
+                build (keys, hash_tag ());
+                return;
+            }
+            const size_type none (size_type (-1));
+            std::vector<size_type> table (std::size_t (range) + 1, none);
+            for (std::size_t i = 0; i < keys.size (); ++ i)
+                table [std::size_t (boost::uintmax_t (keys [i]) - boost::uintmax_t (lo))] = size_type (0);
+            for (std::size_t k = 0; k < table.size (); ++ k)
+                if (table [k] != none) {
+                    table [k] = keys_.size ();
+                    keys_.push_back (key_type (boost::uintmax_t (lo) + k));
+                }
+            for (std::size_t i = 0; i < keys.size (); ++ i)
+                group_ [i] = table [std::size_t (boost::uintmax_t (keys [i]) - boost::uintmax_t (lo))];
+        }
+
+        // Number the keys by first appearance, then renumber by the sorted
+        // order of the distinct keys
+        BOOST_UBLAS_INLINE
+        void build (const std::vector<key_type> &keys, hash_tag) {
+            keys_.clear ();
+            boost::unordered_map<key_type, size_type> map;
+            for (std::size_t i = 0; i < keys.size (); ++ i) {
+                std::pair<typename boost::unordered_map<key_type, size_type>::iterator, bool> p (map.emplace (keys [i], keys_.size ()));
+                if (p.second)
+                    keys_.push_back (keys [i]);
+                group_ [i] = p.first->second;
+            }
+            std::vector<std::pair<key_type, size_type> > order (keys_.size ());
+            for (size_type k = 0; k < keys_.size (); ++ k)
+                order [k] = std::make_pair (keys_ [k], k);
+            std::sort (order.begin (), order.end ());
+            std::vector<size_type> rank (keys_.size ());
+            for (size_type k = 0; k < order.size (); ++ k) {
+                keys_ [k] = order [k].first;
+                rank [order [k].second] = k;
+            }
+            for (std::size_t i = 0; i < group_.size (); ++ i)
+                group_ [i] = rank [group_ [i]];
+        }
+
+        std::vector<size_type> group_;
+        std::vector<key_type> keys_;
+    };
+
+    // Operations of group_reduce. group_operation gives the partial each
+    // group accumulates into and how its value is read. Sums are plain
+    // running sums. min and max follow the magnitude ordering of
+    // vector_min and vector_max. The variance is the population variance.
+    struct group_sum_tag {};
+    struct group_mean_tag {};
+    struct group_variance_tag {};
+    struct group_min_tag {};
+    struct group_max_tag {};
+    struct group_count_tag {};
+
+    template<class T, class S, class Tag>
+    struct group_operation;
+
+    template<class T, class S>
+    struct group_operation<T, S, group_sum_tag> {
+        typedef sum_partial<T> partial_type;
+
+        static BOOST_UBLAS_INLINE
+        T value (const partial_type &p) {
+            return p.sum;
+        }
+    };
+
+    template<class T, class S>
+    struct group_operation<T, S, group_mean_tag> {
+        typedef moments_partial<T, S> partial_type;
+
+        static BOOST_UBLAS_INLINE
+        T value (const partial_type &p) {
+            return p.mean;
+        }
+    };
+
+    template<class T, class S>
+    struct group_operation<T, S, group_variance_tag> {
+        typedef moments_partial<T, S> partial_type;
+
+        static BOOST_UBLAS_INLINE
+        T value (const partial_type &p) {
+            return p.count > S (0) ? p.m2 / T (p.count) : T (0);
+        }
+    };
+
+    template<class T, class S>
+    struct group_operation<T, S, group_min_tag> {
+        typedef extremum_partial<T, std::greater<typename type_traits<T>::real_type> > partial_type;
+
+        static BOOST_UBLAS_INLINE
+        T value (const partial_type &p) {
+            return p.value;
+        }
+    };
+
+    template<class T, class S>
+    struct group_operation<T, S, group_max_tag> {
+        typedef extremum_partial<T, std::less<typename type_traits<T>::real_type> > partial_type;
+
+        static BOOST_UBLAS_INLINE
+        T value (const partial_type &p) {
+            return p.value;
+        }
+    };
+
+    template<class T, class S>
+    struct group_operation<T, S, group_count_tag> {
+        struct partial_type {
+            BOOST_UBLAS_INLINE
+            partial_type ():
+                count (0) {}
+
+            BOOST_UBLAS_INLINE
+            void push (const T &) {
+                ++ count;
+            }
+            BOOST_UBLAS_INLINE
+            void merge (const partial_type &p) {
+                count += p.count;
+            }
+
+            S count;
+        };
+
+        static BOOST_UBLAS_INLINE
+        T value (const partial_type &p) {
+            return T (p.count);
+        }
+    };
+
+    // Vector functors
+
+    // Unary returning scalar
+    template<class V>
+    struct vector_scalar_unary_functor {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+    };
+
+    template<class V>
+    struct vector_min: 
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) { 
+            return vector_reduce<extremum_partial<result_type, std::greater<typename type_traits<value_type>::real_type> > > (e).value;
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            result_type min_val = *it;
+            while (-- size >= 0) {
+                if ( type_traits<value_type>::type_abs(min_val) > type_traits<value_type>::type_abs(*it) )
+                    min_val = *it;
+                ++ it;
+            }
+            return min_val;
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            result_type min_val = *it;
+            typedef typename I::difference_type vector_difference_type;
+            vector_difference_type size (0);
+            while (it != it_end) {
+                if ( type_traits<value_type>::type_abs(min_val) > type_traits<value_type>::type_abs(*it) )
+                    min_val = *it;
+                ++ it;
+                ++ size;
+            }
+            return min_val;
+        }
+    };
+
+    template<class V>
+    struct vector_max:
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) { 
+            return vector_reduce<extremum_partial<result_type, std::less<typename type_traits<value_type>::real_type> > > (e).value;
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            result_type max_val = *it;
+            while (-- size >= 0) {
+                if ( type_traits<value_type>::type_abs(max_val) < type_traits<value_type>::type_abs(*it) )
+                    max_val = *it;
+                ++ it;
+            }
+            return max_val;
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            result_type max_val = *it;
+            typedef typename I::difference_type vector_difference_type;
+            vector_difference_type size (0);
+            while (it != it_end) {
+                if ( type_traits<value_type>::type_abs(max_val) < type_traits<value_type>::type_abs(*it) )
+                    max_val = *it;
+                ++ it;
+                ++ size;
+            }
+            return max_val;
+        }
+    };
+
+    template<class V>
+    struct vector_sum:
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) { 
+            typedef typename default_summation::template partial<result_type>::type partial_type;
+            return vector_reduce<partial_type> (e).result ();
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            typename default_summation::template partial<result_type>::type t;
+            while (-- size >= 0) {
+                t.push (*it);
+                ++ it;
+            }
+            return t.result (); 
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            typename default_summation::template partial<result_type>::type t;
+            while (it != it_end) {
+                t.push (*it);
+                ++ it;
+            }
+            return t.result (); 
+        }
+    };
+
+    // Sum of the elements under the summation policy P, in the accumulator
+    // type of P
+    template<class V, class P>
+    struct vector_summation {
+        typedef typename V::value_type value_type;
+        typedef typename P::template partial<value_type>::type partial_type;
+        typedef typename partial_type::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+            return vector_reduce<partial_type> (e).result ();
+        }
+    };
+
+    template<class V>
+    struct vector_mean: 
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+        // typedef double result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) { 
+            typedef typename default_summation::template partial<result_type>::type partial_type;
+            return vector_reduce<partial_type> (e).result () / e ().size ();
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            typename default_summation::template partial<result_type>::type t;
+            D n (size);
+            while (-- size >= 0) {
+                t.push (*it);
+                ++ it;
+            }
+            return t.result () / n; 
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            typename default_summation::template partial<result_type>::type t;
+            typedef typename I::difference_type vector_difference_type;
+            vector_difference_type size (0);
+            while (it != it_end) {
+                t.push (*it);
+                ++ it;
+                ++ size;
+            }
+            return t.result () / size;
+        }
+    };
+
+    template<class V>
+    struct vector_mean_iterative: 
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+        // typedef double result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) { 
+            result_type t = result_type (0);
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            for (vector_size_type i = 0; i < size; ++ i)
+                t += (e () (i) - t) / (i + 1);
+            return t;
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            result_type t = result_type (0);
+            D i (0);
+            while (++i <= size) {
+                t += (*it - t) / i;
+                ++ it;
+            }
+            return t;
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            result_type t = result_type (0);
+            typedef typename I::difference_type vector_difference_type;
+            vector_difference_type size (1);
+            while (it != it_end) {
+                t += (*it - t) / size;
+                ++ it;
+                ++ size;
+            }
+            return t;
+        }
+    };
+
+    template<class V>
+    struct vector_variance: 
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+        // typedef double result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) { 
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            power_sums_partial<result_type> p (vector_reduce<power_sums_partial<result_type> > (e));
+            return (p.sumsq - (p.sum * p.sum) / size) / size;
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            result_type sumsq = result_type (0);
+            result_type sum = result_type (0);
+            D i (0);
+            while (++i <= size) {
+                sumsq += *it * *it;
+                sum += *it;
+                ++ it;
+            }
+            return (sumsq - (sum * sum) / size) / size;
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            result_type sumsq = result_type (0);
+            result_type sum = result_type (0);
+            typedef typename I::difference_type vector_difference_type;
+            vector_difference_type size (0);
+            while (it != it_end) {
+                sumsq += *it * *it;
+                sum += *it;
+                ++ it;
+                ++ size;
+            }
+            return (sumsq - (sum * sum) / size) / size;
+        }
+    };
+
+    template<class V>
+    struct vector_variance_iterative: 
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+        // typedef double result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) { 
+            typedef typename E::size_type vector_size_type;
+            return vector_reduce<moments_partial<result_type, vector_size_type> > (e).m2 / e ().size ();
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            result_type mean = result_type (0);
+            result_type n = result_type (0);
+            result_type var = result_type (0);
+            result_type del;
+            while (++ n <= size){
+                del = *it - mean;
+                mean += del / n;
+                var += del * (*it - mean);
+                ++ it;
+            }
+            return var / size; 
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            typedef typename I::difference_type vector_difference_type;
+            result_type mean = result_type (0);
+            vector_difference_type n (0);
+            result_type var = result_type (0);
+            result_type del;
+            while (it != it_end)  {
+                ++ n;
+                del = *it - mean;
+                mean += del / n;
+                var += del * (*it - mean);
+                ++ it;
+            }
+            return var / n; 
+        }
+    };
+
+    // Statistics of higher_moments_partial and central_moments_partial
+    struct skewness_tag {};
+    struct kurtosis_tag {};
+
+    // m3 / m2^(3/2) of the central moments mk = sum ((x - mean)^k) / n
+    template<class T, class S>
+    BOOST_UBLAS_INLINE
+    T moment_statistic (const higher_moments_partial<T, S> &p, skewness_tag) {
+        return type_traits<T>::type_sqrt (T (p.count)) * p.m3 / (p.m2 * type_traits<T>::type_sqrt (p.m2));
+    }
+    // Excess kurtosis m4 / m2^2 - 3
+    template<class T, class S>
+    BOOST_UBLAS_INLINE
+    T moment_statistic (const higher_moments_partial<T, S> &p, kurtosis_tag) {
+        return T (p.count) * p.m4 / (p.m2 * p.m2) - T (3);
+    }
+    // Central moment of order k <= 4
+    template<class T, class S>
+    BOOST_UBLAS_INLINE
+    T central_moment (const higher_moments_partial<T, S> &p, S k) {
+        BOOST_UBLAS_CHECK (k <= S (4), bad_argument ());
+        const T sums [] = {T (p.count), T (0), p.m2, p.m3, p.m4};
+        return sums [k] / T (p.count);
+    }
+    template<class T, class S>
+    BOOST_UBLAS_INLINE
+    T central_moment (const central_moments_partial<T, S> &p, S k) {
+        if (k < S (2))
+            return k == S (0) ? T (1) : T (0);
+        return p.m [k] / T (p.count);
+    }
+
+    // Skewness (Tag is skewness_tag) or excess kurtosis (kurtosis_tag) of
+    // the elements, from a single pass
+    template<class V, class Tag>
+    struct vector_higher_moment {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            return moment_statistic (vector_reduce<higher_moments_partial<result_type, vector_size_type> > (e), Tag ());
+        }
+    };
+
+    // Central moment of order k: sum ((e (i) - mean)^k) / size
+    template<class V>
+    struct vector_moment {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e, typename E::size_type k) {
+            typedef typename E::size_type vector_size_type;
+            if (k <= vector_size_type (4))
+                return central_moment (vector_reduce<higher_moments_partial<result_type, vector_size_type> > (e), k);
+            return central_moment (vector_reduce (e, central_moments_partial<result_type, vector_size_type> (k)), k);
+        }
+    };
+
+    // Exponentially weighted mean and variance of a series, updated one
+    // value at a time: mean_t = (1 - alpha) mean_t-1 + alpha x_t from
+    // mean_0 = x_0, and the matching recursive (biased) variance, as
+    // pandas' ewm (alpha = alpha, adjust = False) with bias = True.
+    struct ewm_mean_tag {};
+    struct ewm_variance_tag {};
+
+    template<class T>
+    struct ewm_moments {
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        explicit ewm_moments (const value_type &alpha = value_type (1)):
+            alpha (alpha), empty (true), mean (0), var (0) {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (empty) {
+                mean = x;
+                var = value_type (0);
+                empty = false;
+                return;
+            }
+            value_type del = x - mean;
+            value_type incr = alpha * del;
+            mean += incr;
+            var = (value_type (1) - alpha) * (var + del * incr);
+        }
+
+        BOOST_UBLAS_INLINE
+        const value_type &value (ewm_mean_tag) const {
+            return mean;
+        }
+        BOOST_UBLAS_INLINE
+        const value_type &value (ewm_variance_tag) const {
+            return var;
+        }
+
+        value_type alpha;
+        bool empty;
+        value_type mean;
+        value_type var;
+    };
+
+    // r (i) is the exponentially weighted mean (Tag is ewm_mean_tag) or
+    // variance (ewm_variance_tag) of e (0), ..., e (i), in one pass
+    template<class V, class Tag>
+    struct vector_ewm {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const vector_expression<E> &e, const value_type &alpha, vector<result_type> &r) {
+            typedef typename E::size_type vector_size_type;
+            BOOST_UBLAS_CHECK (alpha > value_type (0) && alpha <= value_type (1), bad_argument ());
+            vector_size_type size (e ().size ());
+            r.resize (size, false);
+            ewm_moments<result_type> m (alpha);
+            for (vector_size_type i = 0; i < size; ++ i) {
+                m.push (e () (i));
+                r (i) = m.value (Tag ());
+            }
+        }
+    };
+
+    template<class V>
+    struct vector_mode: 
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+        
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            mode_engine<result_type, vector_size_type> engine;
+            vector_size_type size (e ().size ());
+            engine.values ().reserve (size);
+            for (vector_size_type i = 0; i < size; ++ i)
+                engine.values ().push_back (e () (i));
+            return engine.mode ();
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) { 
+            mode_engine<result_type, std::size_t> engine;
+            engine.values ().reserve (size);
+            while (-- size >= 0) {
+                engine.values ().push_back (*it);
+                ++ it;
+            }
+            return engine.mode ();
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            mode_engine<result_type, std::size_t> engine;
+            while (it != it_end) {
+                engine.values ().push_back (*it);
+                ++ it;
+            }
+            return engine.mode ();
+        }
+    };
+
+    template<class V>
+    struct vector_median:
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+        
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            vector<value_type> v (size);
+            for (int i = 0; i < size; ++ i)
+                v (i) = e () (i);
+            return select_median (v.begin (), v.end (), compareElement);
+        }
+
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) {
+            vector<value_type> v (size);
+            D size_temp = size;
+            D i = D (0);
+            while (-- size_temp >= 0) {
+                v (i) = *it;
+                ++ it;
+                ++  i;
+            }
+            return select_median (v.begin (), v.end (), compareElement);
+        }
+
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end) {
-            result_type t = result_type (0);
             typedef typename I::difference_type vector_difference_type;
-            vector_difference_type size (1);
+            vector_difference_type size = vector_difference_type (0);
+            I it1 = it;
+            while (it1 != it_end) {
+                ++ it1;
+                ++ size;
+            }
+            vector<value_type> v (size);
+            vector_difference_type i = vector_difference_type (0);
             while (it != it_end) {
-                t += (*it - t) / size;
+                v (i) = *it;
                 ++ it;
-                ++ size;
+                ++ i;
             }
-            return t;
+            
+            return select_median (v.begin (), v.end (), compareElement);
+        }
+
+        static BOOST_UBLAS_INLINE
+        bool compareElement (const value_type &A, const value_type &B) {
+            return magnitude_less (A, B);
         }
     };
 
+    // Quantiles under the magnitude ordering of vector_median, so that the
+    // linear 0.5 quantile is the median. One copy of the data serves all
+    // the requested quantiles.
     template<class V>
-    struct vector_variance: 
+    struct vector_quantile:
+        public vector_median<V> {
+        typedef typename vector_median<V>::value_type value_type;
+        typedef typename vector_median<V>::result_type result_type;
+        using vector_median<V>::compareElement;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e, double q, quantile_interpolation method) {
+            std::vector<value_type> v;
+            copy (e, v);
+            return select_quantile (v.begin (), v.end (), q, method, compareElement);
+        }
+
+        template<class E, class Q>
+        static BOOST_UBLAS_INLINE
+        void apply (const vector_expression<E> &e, const vector_expression<Q> &q, quantile_interpolation method, vector<result_type> &r) {
+            std::vector<value_type> v;
+            copy (e, v);
+            r.resize (q ().size (), false);
+            select_quantiles (v.begin (), v.end (), q ().begin (), q ().end (), r.begin (), method, compareElement);
+        }
+
+    private:
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void copy (const vector_expression<E> &e, std::vector<value_type> &v) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            v.reserve (size);
+            for (vector_size_type i = 0; i < size; ++ i)
+                v.push_back (e () (i));
+        }
+    };
+
+    // Weighted statistics: the weights w (i) multiply the elements e (i) in
+    // the same traversal, without forming element_prod (w, v) or a separate
+    // sum (w). Weights are non-negative and normalized by their sum, so the
+    // variance and covariance are the population (reliability weight) ones.
+    template<class V>
+    struct vector_weighted_mean:
         public vector_scalar_unary_functor<V> {
         typedef typename vector_scalar_unary_functor<V>::value_type value_type;
         typedef typename vector_scalar_unary_functor<V>::result_type result_type;
-        // typedef double result_type;
+
+        template<class E, class W>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e, const vector_expression<W> &w) {
+            weighted_sum_partial<result_type> p (vector_weighted_reduce<weighted_sum_partial<result_type> > (e, w));
+            return p.sum / p.weight;
+        }
+    };
+
+    template<class V>
+    struct vector_weighted_variance:
+        public vector_scalar_unary_functor<V> {
+        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+
+        template<class E, class W>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e, const vector_expression<W> &w) {
+            weighted_moments_partial<result_type> p (vector_weighted_reduce<weighted_moments_partial<result_type> > (e, w));
+            return p.m2 / p.weight;
+        }
+    };
+
+    // Weighted quantile under the magnitude ordering of vector_quantile: the
+    // first element whose cumulative weight reaches q times the total weight
+    // (the inverted CDF; with unit weights the element of rank
+    // ceil (q size) - 1, the lower median at q = 0.5). Elements of zero
+    // weight are never chosen. The element is found by a weighted
+    // quickselect in expected O(size).
+    template<class V>
+    struct vector_weighted_quantile:
+        public vector_median<V> {
+        typedef typename vector_median<V>::value_type value_type;
+        typedef typename vector_median<V>::result_type result_type;
+        using vector_median<V>::compareElement;
+
+        template<class E, class W>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e, const vector_expression<W> &w, double q) {
+            typedef typename E::size_type vector_size_type;
+            typedef typename std::vector<element>::iterator iterator;
+            BOOST_UBLAS_CHECK (q >= 0. && q <= 1., bad_argument ());
+            vector_size_type size (BOOST_UBLAS_SAME (e ().size (), w ().size ()));
+            std::vector<element> v;
+            v.reserve (size);
+            result_type total = result_type (0);
+            for (vector_size_type i = 0; i < size; ++ i) {
+                result_type wi (w () (i));
+                if (wi > result_type (0)) {
+                    v.push_back (element (e () (i), wi));
+                    total += wi;
+                }
+            }
+            BOOST_UBLAS_CHECK (! v.empty (), bad_size ());
+            if (v.empty ())
+                return result_type (0);
+            result_type target (result_type (q) * total);
+            result_type below = result_type (0);
+            iterator first (v.begin ());
+            iterator last (v.end ());
+            while (last - first > 1) {
+                iterator middle (first + (last - first) / 2);
+                std::nth_element (first, middle, last, compare);
+                result_type left (below);
+                for (iterator it = first; it != middle; ++ it)
+                    left += it->second;
+                if (left >= target)
+                    last = middle;
+                else if (left + middle->second >= target || middle + 1 == last)
+                    return middle->first;
+                else {
+                    below = left + middle->second;
+                    first = middle + 1;
+                }
+            }
+            return first->first;
+        }
+
+    private:
+        typedef std::pair<value_type, result_type> element;
+
+        static BOOST_UBLAS_INLINE
+        bool compare (const element &a, const element &b) {
+            return compareElement (a.first, b.first);
+        }
+    };
+
+    // Summary statistics returned by describe ()
+    template<class T, class S>
+    struct stats_summary {
+        typedef T value_type;
+        typedef S size_type;
+
+        size_type count;
+        value_type mean;
+        value_type variance;
+        value_type min;
+        value_type max;
+        value_type median;
+        value_type mode;
+    };
+
+    // Fused accumulator behind describe (). Each element is visited once:
+    // mean and variance use Welford's update, min, max and mode follow the
+    // magnitude ordering of vector_min, vector_max and vector_mode, and the
+    // values are buffered so the median needs no second traversal.
+    template<class T, class S>
+    class describe_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+        typedef stats_summary<T, S> result_type;
+
+        // Construction and destruction
+        BOOST_UBLAS_INLINE
+        explicit describe_accumulator (size_type capacity = 0):
+            n_ (0), mean_ (0), m2_ (0), min_ (0), max_ (0), buffer_ (), count_map_ () {
+            buffer_.reserve (capacity);
+        }
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            ++ n_;
+            value_type del = x - mean_;
+            mean_ += del / value_type (n_);
+            m2_ += del * (x - mean_);
+            if (n_ == 1) {
+                min_ = x;
+                max_ = x;
+            }
+            else {
+                if (type_traits<value_type>::type_abs (min_) > type_traits<value_type>::type_abs (x))
+                    min_ = x;
+                if (type_traits<value_type>::type_abs (max_) < type_traits<value_type>::type_abs (x))
+                    max_ = x;
+            }
+            typename boost::unordered_map<value_type, size_type>::iterator p = count_map_.find (x);
+            if (p != count_map_.end ())
+                p->second += size_type (1);
+            else
+                count_map_.emplace (x, size_type (1));
+            buffer_.push_back (x);
+        }
+
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return n_;
+        }
+
+        BOOST_UBLAS_INLINE
+        result_type result () {
+            result_type s;
+            s.count = n_;
+            s.mean = mean_;
+            s.variance = n_ > 0 ? m2_ / value_type (n_) : value_type (0);
+            s.min = min_;
+            s.max = max_;
+            s.median = value_type (0);
+            s.mode = value_type (0);
+            if (n_ == 0)
+                return s;
+
+            s.median = select_median (buffer_.begin (), buffer_.end (), compareElement);
+
+            size_type mode_val = size_type (0);
+            typename boost::unordered_map<value_type, size_type>::const_iterator p = count_map_.begin ();
+            while (p != count_map_.end ()) {
+                if (p->second > mode_val) {
+                    s.mode = p->first;
+                    mode_val = p->second;
+                }
+                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (s.mode))
+                    s.mode = p->first;
+                ++ p;
+            }
+            return s;
+        }
+
+        static BOOST_UBLAS_INLINE
+        bool compareElement (const value_type &A, const value_type &B) {
+            return magnitude_less (A, B);
+        }
+
+    private:
+        size_type n_;
+        value_type mean_;
+        value_type m2_;
+        value_type min_;
+        value_type max_;
+        std::vector<value_type> buffer_;
+        boost::unordered_map<value_type, size_type> count_map_;
+    };
+
+    template<class V>
+    struct vector_describe {
+        typedef typename V::value_type value_type;
+        typedef typename V::size_type size_type;
+        typedef stats_summary<value_type, size_type> result_type;
+        typedef describe_accumulator<value_type, size_type> accumulator_type;
 
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) { 
+        result_type apply (const vector_expression<E> &e) {
             typedef typename E::size_type vector_size_type;
             vector_size_type size (e ().size ());
-            result_type sumsq = result_type (0);
-            result_type sum = result_type (0);
+            accumulator_type acc (size);
+            for (vector_size_type i = 0; i < size; ++ i)
+                acc.push (e () (i));
+            return acc.result ();
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) {
+            accumulator_type acc (size);
+            while (-- size >= 0) {
+                acc.push (*it);
+                ++ it;
+            }
+            return acc.result ();
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            accumulator_type acc;
+            while (it != it_end) {
+                acc.push (*it);
+                ++ it;
+            }
+            return acc.result ();
+        }
+    };
+
+    // Unary returning real scalar 
+    template<class V>
+    struct vector_scalar_real_unary_functor {
+        typedef typename V::value_type value_type;
+        typedef typename type_traits<value_type>::real_type real_type;
+        typedef real_type result_type;
+    };
+
+    template<class V>
+    struct vector_norm_1:
+        public vector_scalar_real_unary_functor<V> {
+        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
+        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+            return vector_reduce<norm_1_partial<value_type> > (e).t;
+        }
+        // Dense case
+        template<class D, class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (D size, I it) {
+            real_type t = real_type ();
+            while (-- size >= 0) {
+                real_type u (type_traits<value_type>::norm_1 (*it));
+                t += u;
+                ++ it;
+            }
+            return t;
+        }
+        // Sparse case
+        template<class I>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I it, const I &it_end) {
+            real_type t = real_type ();
+            while (it != it_end) {
+                real_type u (type_traits<value_type>::norm_1 (*it));
+                t += u;
+                ++ it;
+            }
+            return t;
+        }
+    };
+    template<class V>
+    struct vector_norm_2:
+        public vector_scalar_real_unary_functor<V> {
+        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
+        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+#ifndef BOOST_UBLAS_SCALED_NORM
+            real_type t = vector_reduce<norm_2_partial<value_type> > (e).t;
+            return static_cast<result_type>(type_traits<real_type>::type_sqrt (t));
+#else
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            real_type scale = real_type ();
+            real_type sum_squares (1);
             for (vector_size_type i = 0; i < size; ++ i) {
-                sumsq += e () (i) * e () (i);
-                sum += e () (i);
+                real_type u (type_traits<value_type>::norm_2 (e () (i)));
+                if ( real_type () /* zero */ == u ) continue;
+                if (scale < u) {
+                    real_type v (scale / u);
+                    sum_squares = sum_squares * v * v + real_type (1);
+                    scale = u;
+                } else {
+                    real_type v (u / scale);
+                    sum_squares += v * v;
+                }
             }
-            return (sumsq - (sum * sum) / size) / size;
+            return static_cast<result_type>(scale * type_traits<real_type>::type_sqrt (sum_squares));
+#endif
         }
         // Dense case
         template<class D, class I>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            result_type sumsq = result_type (0);
-            result_type sum = result_type (0);
-            D i (0);
-            while (++i <= size) {
-                sumsq += *it * *it;
-                sum += *it;
+        result_type apply (D size, I it) {
+#ifndef BOOST_UBLAS_SCALED_NORM
+            real_type t = real_type ();
+            while (-- size >= 0) {
+                real_type u (type_traits<value_type>::norm_2 (*it));
+                t +=  u * u;
                 ++ it;
             }
-            return (sumsq - (sum * sum) / size) / size;
+            return static_cast<result_type>(type_traits<real_type>::type_sqrt (t));
+#else
+            real_type scale = real_type ();
+            real_type sum_squares (1);
+            while (-- size >= 0) {
+                real_type u (type_traits<value_type>::norm_2 (*it));
+                if (scale < u) {
+                    real_type v (scale / u);
+                    sum_squares = sum_squares * v * v + real_type (1);
+                    scale = u;
+                } else {
+                    real_type v (u / scale);
+                    sum_squares += v * v;
+                }
+                ++ it;
+            }
+            return static_cast<result_type>(scale * type_traits<real_type>::type_sqrt (sum_squares));
+#endif
         }
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end) {
-            result_type sumsq = result_type (0);
-            result_type sum = result_type (0);
-            typedef typename I::difference_type vector_difference_type;
-            vector_difference_type size (0);
+#ifndef BOOST_UBLAS_SCALED_NORM
+            real_type t = real_type ();
             while (it != it_end) {
-                sumsq += *it * *it;
-                sum += *it;
+                real_type u (type_traits<value_type>::norm_2 (*it));
+                t +=  u * u;
+                ++ it;
+            }
+            return static_cast<result_type>(type_traits<real_type>::type_sqrt (t));
+#else
+            real_type scale = real_type ();
+            real_type sum_squares (1);
+            while (it != it_end) {
+                real_type u (type_traits<value_type>::norm_2 (*it));
+                if (scale < u) {
+                    real_type v (scale / u);
+                    sum_squares = sum_squares * v * v + real_type (1);
+                    scale = u;
+                } else {
+                    real_type v (u / scale);
+                    sum_squares += v * v;
+                }
                 ++ it;
-                ++ size;
             }
-            return (sumsq - (sum * sum) / size) / size;
+            return static_cast<result_type>(scale * type_traits<real_type>::type_sqrt (sum_squares));
+#endif
         }
     };
 
     template<class V>
-    struct vector_variance_iterative: 
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
-        // typedef double result_type;
+    struct vector_norm_2_square :
+        public vector_scalar_real_unary_functor<V> {
+        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
+        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
 
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) { 
-            result_type mean = result_type (0);
-            result_type var = result_type (0);
-            result_type del;
+        result_type apply (const vector_expression<E> &e) {
+            real_type t = real_type ();
             typedef typename E::size_type vector_size_type;
             vector_size_type size (e ().size ());
             for (vector_size_type i = 0; i < size; ++ i) {
-                del = e () (i) - mean;
-                mean += del / (i + 1);
-                var += del * (e () (i) - mean);
+                real_type u (type_traits<value_type>::norm_2 (e () (i)));
+                t +=  u * u;
             }
-            return var / size;
+            return t;
         }
         // Dense case
         template<class D, class I>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            result_type mean = result_type (0);
-            result_type n = result_type (0);
-            result_type var = result_type (0);
-            result_type del;
-            while (++ n <= size){
-                del = *it - mean;
-                mean += del / n;
-                var += del * (*it - mean);
+        result_type apply (D size, I it) {
+            real_type t = real_type ();
+            while (-- size >= 0) {
+                real_type u (type_traits<value_type>::norm_2 (*it));
+                t +=  u * u;
                 ++ it;
             }
-            return var / size; 
+            return t;
         }
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end) {
-            typedef typename I::difference_type vector_difference_type;
-            result_type mean = result_type (0);
-            vector_difference_type n (0);
-            result_type var = result_type (0);
-            result_type del;
-            while (it != it_end)  {
-                ++ n;
-                del = *it - mean;
-                mean += del / n;
-                var += del * (*it - mean);
+            real_type t = real_type ();
+            while (it != it_end) {
+                real_type u (type_traits<value_type>::norm_2 (*it));
+                t +=  u * u;
                 ++ it;
             }
-            return var / n; 
+            return t;
         }
     };
 
     template<class V>
-    struct vector_mode: 
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
-        
+    struct vector_norm_inf:
+        public vector_scalar_real_unary_functor<V> {
+        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
+        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
+
         template<class E>
         static BOOST_UBLAS_INLINE
         result_type apply (const vector_expression<E> &e) {
-            typedef typename E::size_type vector_size_type;
-            boost::unordered_map<result_type, vector_size_type> count_map (0);
-            vector_size_type size (e ().size ());
-            typename boost::unordered_map<result_type, vector_size_type>::iterator p;
-            // auto p = count_map.iterator;
-            for (vector_size_type i = 0; i < size; ++ i) {
-                p = count_map.find (e () (i));
-                if (p != count_map.end ())
-                    p->second += vector_size_type (1);
-                else
-                    count_map.emplace (e () (i), vector_size_type (1));
-            }
-            
-            result_type mode = result_type (0);
-            vector_size_type mode_val = vector_size_type (0);
-            p = count_map.begin ();
-            while (p != count_map.end ()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+            return vector_reduce<norm_inf_partial<value_type> > (e).t;
         }
         // Dense case
         template<class D, class I>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) { 
-            boost::unordered_map<result_type, D> count_map;
-            
-            typename boost::unordered_map<result_type, D>::iterator p;
-            // auto p = count_map.iterator;
+        result_type apply (D size, I it) {
+            real_type t = real_type ();
             while (-- size >= 0) {
-                p = count_map.find (*it);
-                if ( p != count_map.end ())
-                    p->second += D (1);
-                else
-                    count_map.emplace (*it, D (1));
+                real_type u (type_traits<value_type>::norm_inf (*it));
+                if (u > t)
+                    t = u;
                 ++ it;
             }
-            
-            result_type mode = result_type (0);
-            D mode_val = D (0);
-            p = count_map.begin ();
-            while (p != count_map.end ()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+            return t;
         }
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            typedef typename I::difference_type vector_difference_type;
-
-            boost::unordered_map<result_type, vector_difference_type> count_map;
-            
-            typename boost::unordered_map<result_type, vector_difference_type>::iterator p;
-            // auto p = count_map.iterator;
-
+        result_type apply (I it, const I &it_end) { 
+            real_type t = real_type ();
             while (it != it_end) {
-                p = count_map.find (*it);
-                if ( p != count_map.end ())
-                    p->second += vector_difference_type (1);
-                else
-                    count_map.emplace (*it, vector_difference_type (1));
+                real_type u (type_traits<value_type>::norm_inf (*it));
+                if (u > t) 
+                    t = u;
                 ++ it;
             }
-            
-            result_type mode = result_type (0);
-            vector_difference_type mode_val = vector_difference_type (0);
-            p = count_map.begin();
-            while (p != count_map.end()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+            return t; 
         }
     };
 
+    // Unary returning index
     template<class V>
-    struct vector_median:
-        public vector_scalar_unary_functor<V> {
-        typedef typename vector_scalar_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_unary_functor<V>::result_type result_type;
-        
+    struct vector_scalar_index_unary_functor {
+        typedef typename V::value_type value_type;
+        typedef typename type_traits<value_type>::real_type real_type;
+        typedef typename V::size_type result_type;
+    };
+
+    template<class V>
+    struct vector_index_norm_inf:
+        public vector_scalar_index_unary_functor<V> {
+        typedef typename vector_scalar_index_unary_functor<V>::value_type value_type;
+        typedef typename vector_scalar_index_unary_functor<V>::real_type real_type;
+        typedef typename vector_scalar_index_unary_functor<V>::result_type result_type;
+
         template<class E>
         static BOOST_UBLAS_INLINE
         result_type apply (const vector_expression<E> &e) {
+            // ISSUE For CBLAS compatibility return 0 index in empty case
+            result_type i_norm_inf (0);
+            real_type t = real_type ();
             typedef typename E::size_type vector_size_type;
             vector_size_type size (e ().size ());
-            vector<value_type> v (size);
-            for (int i = 0; i < size; ++ i)
-                v (i) = e () (i);
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
+            for (vector_size_type i = 0; i < size; ++ i) {
+                real_type u (type_traits<value_type>::norm_inf (e () (i)));
+                if (u > t) {
+                    i_norm_inf = i;
+                    t = u;
+                }
+            }
+            return i_norm_inf;
         }
-
         // Dense case
         template<class D, class I>
         static BOOST_UBLAS_INLINE
         result_type apply (D size, I it) {
-            vector<value_type> v (size);
-            D size_temp = size;
-            D i = D (0);
-            while (-- size_temp >= 0) {
-                v (i) = *it;
+            // ISSUE For CBLAS compatibility return 0 index in empty case
+            result_type i_norm_inf (0);
+            real_type t = real_type ();
+            while (-- size >= 0) {
+                real_type u (type_traits<value_type>::norm_inf (*it));
+                if (u > t) {
+                    i_norm_inf = it.index ();
+                    t = u;
+                }
                 ++ it;
-                ++  i;
             }
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
+            return i_norm_inf;
         }
-
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end) {
-            typedef typename I::difference_type vector_difference_type;
-            vector_difference_type size = vector_difference_type (0);
-            I it1 = it;
-            while (it1 != it_end) {
-                ++ it1;
-                ++ size;
-            }
-            vector<value_type> v (size);
-            vector_difference_type i = vector_difference_type (0);
+            // ISSUE For CBLAS compatibility return 0 index in empty case
+            result_type i_norm_inf (0);
+            real_type t = real_type ();
             while (it != it_end) {
-                v (i) = *it;
+                real_type u (type_traits<value_type>::norm_inf (*it));
+                if (u > t) {
+                    i_norm_inf = it.index ();
+                    t = u;
+                }
                 ++ it;
-                ++ i;
             }
-            
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
-        }
-
-        static BOOST_UBLAS_INLINE
-        bool compareElement (const value_type &A, const value_type &B) {
-            return (type_traits<value_type>::type_abs (A) < type_traits<value_type>::type_abs (B));
+            return i_norm_inf;
         }
     };
 
-    // Unary returning real scalar 
-    template<class V>
-    struct vector_scalar_real_unary_functor {
-        typedef typename V::value_type value_type;
-        typedef typename type_traits<value_type>::real_type real_type;
-        typedef real_type result_type;
+    // Binary returning scalar
+    template<class V1, class V2, class TV>
+    struct vector_scalar_binary_functor {
+        typedef TV value_type;
+        typedef TV result_type;
     };
 
-    template<class V>
-    struct vector_norm_1:
-        public vector_scalar_real_unary_functor<V> {
-        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
-        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
+    template<class V1, class V2, class TV>
+    struct vector_inner_prod:
+        public vector_scalar_binary_functor<V1, V2, TV> {
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::value_type value_type;
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::result_type result_type;
 
-        template<class E>
+        template<class C1, class C2>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) {
-            real_type t = real_type ();
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            for (vector_size_type i = 0; i < size; ++ i) {
-                real_type u (type_traits<value_type>::type_abs (e () (i)));
-                t += u;
+        result_type apply (const vector_container<C1> &c1,
+                           const vector_container<C2> &c2) {
+#ifdef BOOST_UBLAS_USE_SIMD
+            using namespace raw;
+            typedef typename C1::size_type vector_size_type;
+            vector_size_type size (BOOST_UBLAS_SAME (c1 ().size (), c2 ().size ()));
+            const typename V1::value_type *data1 = data_const (c1 ());
+            const typename V1::value_type *data2 = data_const (c2 ());
+            vector_size_type s1 = stride (c1 ());
+            vector_size_type s2 = stride (c2 ());
+            result_type t = result_type (0);
+            if (s1 == 1 && s2 == 1) {
+                t = detail::contiguous_dot (data1, data2, size);
+            } else if (s2 == 1) {
+                for (vector_size_type i = 0, i1 = 0; i < size; ++ i, i1 += s1)
+                    t += data1 [i1] * data2 [i];
+            } else if (s1 == 1) {
+                for (vector_size_type i = 0, i2 = 0; i < size; ++ i, i2 += s2)
+                    t += data1 [i] * data2 [i2];
+            } else {
+                for (vector_size_type i = 0, i1 = 0, i2 = 0; i < size; ++ i, i1 += s1, i2 += s2)
+                    t += data1 [i1] * data2 [i2];
             }
             return t;
+#elif defined(BOOST_UBLAS_HAVE_BINDINGS)
+            return boost::numeric::bindings::atlas::dot (c1 (), c2 ());
+#else
+            return apply (static_cast<const vector_expression<C1> > (c1), static_cast<const vector_expression<C2> > (c2));
+#endif
+        }
+        template<class E1, class E2>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E1> &e1,
+                           const vector_expression<E2> &e2) {
+            typedef typename E1::size_type vector_size_type;
+            vector_size_type size (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()));
+            result_type t = result_type (0);
+#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
+            for (vector_size_type i = 0; i < size; ++ i)
+                t += e1 () (i) * e2 () (i);
+#else
+            vector_size_type i (0);
+            DD (size, 4, r, (t += e1 () (i) * e2 () (i), ++ i));
+#endif
+            return t;
         }
         // Dense case
-        template<class D, class I>
+        template<class D, class I1, class I2>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) {
-            real_type t = real_type ();
-            while (-- size >= 0) {
-                real_type u (type_traits<value_type>::norm_1 (*it));
-                t += u;
-                ++ it;
+        result_type apply (D size, I1 it1, I2 it2) {
+            result_type t = result_type (0);
+#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
+            while (-- size >= 0)
+                t += *it1 * *it2, ++ it1, ++ it2;
+#else
+            DD (size, 4, r, (t += *it1 * *it2, ++ it1, ++ it2));
+#endif
+            return t;
+        }
+        // Packed case
+        template<class I1, class I2>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end) {
+            result_type t = result_type (0);
+            typedef typename I1::difference_type vector_difference_type;
+            vector_difference_type it1_size (it1_end - it1);
+            vector_difference_type it2_size (it2_end - it2);
+            vector_difference_type diff (0);
+            if (it1_size > 0 && it2_size > 0)
+                diff = it2.index () - it1.index ();
+            if (diff != 0) {
+                vector_difference_type size = (std::min) (diff, it1_size);
+                if (size > 0) {
+                    it1 += size;
+                    it1_size -= size;
+                    diff -= size;
+                }
+                size = (std::min) (- diff, it2_size);
+                if (size > 0) {
+                    it2 += size;
+                    it2_size -= size;
+                    diff += size;
+                }
             }
+            vector_difference_type size ((std::min) (it1_size, it2_size));
+            while (-- size >= 0)
+                t += *it1 * *it2, ++ it1, ++ it2;
             return t;
         }
         // Sparse case
-        template<class I>
+        template<class I1, class I2>
         static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            real_type t = real_type ();
-            while (it != it_end) {
-                real_type u (type_traits<value_type>::norm_1 (*it));
-                t += u;
-                ++ it;
+        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end, sparse_bidirectional_iterator_tag) {
+            result_type t = result_type (0);
+            if (it1 != it1_end && it2 != it2_end) {
+                for (;;) {
+                    if (it1.index () == it2.index ()) {
+                        t += *it1 * *it2, ++ it1, ++ it2;
+                        if (it1 == it1_end || it2 == it2_end)
+                            break;
+                    } else if (it1.index () < it2.index ()) {
+                        increment (it1, it1_end, it2.index () - it1.index ());
+                        if (it1 == it1_end)
+                            break;
+                    } else if (it1.index () > it2.index ()) {
+                        increment (it2, it2_end, it1.index () - it2.index ());
+                        if (it2 == it2_end)
+                            break;
+                    }
+                }
             }
             return t;
         }
     };
-    template<class V>
-    struct vector_norm_2:
-        public vector_scalar_real_unary_functor<V> {
-        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
-        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
 
-        template<class E>
+    template<class V1, class V2, class TV>
+    struct vector_covariance:
+        public vector_scalar_binary_functor<V1, V2, TV> {
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::value_type value_type;
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::result_type result_type;
+
+        template<class C1, class C2>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) {
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-#ifndef BOOST_UBLAS_SCALED_NORM
-            real_type t = real_type ();
+        result_type apply (const vector_container<C1> &c1, const vector_container<C2> &c2) {
+            return apply (static_cast<const vector_expression<C1> > (c1), static_cast<const vector_expression<C2> > (c2));
+        }
+
+        template<class E1, class E2>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E1> &e1, const vector_expression<E2> &e2) {
+            typedef typename E1::size_type vector_size_type;
+            vector_size_type size (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()));
+            result_type t = result_type (0);
+            result_type mean1 = result_type (0);
+            result_type mean2 = result_type (0);
+            result_type del1, del2;
+#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
             for (vector_size_type i = 0; i < size; ++ i) {
-                real_type u (type_traits<value_type>::norm_2 (e () (i)));
-                t +=  u * u;
+                del1 = (e1 () (i) - mean1) / (i + 1);
+                mean1 += del1;
+                del2 = (e2 () (i) - mean2) / (i + 1);
+                mean2 += del2;
+                t += i * del1 * del2 - t / (i + 1);
             }
-            return static_cast<result_type>(type_traits<real_type>::type_sqrt (t));
 #else
-            real_type scale = real_type ();
-            real_type sum_squares (1);
-            for (vector_size_type i = 0; i < size; ++ i) {
-                real_type u (type_traits<value_type>::norm_2 (e () (i)));
-                if ( real_type () /* zero */ == u ) continue;
-                if (scale < u) {
-                    real_type v (scale / u);
-                    sum_squares = sum_squares * v * v + real_type (1);
-                    scale = u;
-                } else {
-                    real_type v (u / scale);
-                    sum_squares += v * v;
-                }
-            }
-            return static_cast<result_type>(scale * type_traits<real_type>::type_sqrt (sum_squares));
+            vector_size_type i (0);
+            DD (size, 4, r, del1 = (e1 () (i) - mean1) / (i + 1),
+                mean1 += del1,
+                del2 = (e2 () (i) - mean2) / (i + 1),
+                mean2 += del2,
+                t += i * del1 * del2 - t / (i + 1), ++ i);
 #endif
+            // return size / (size - 1) * t;
+            return t;
         }
+
         // Dense case
-        template<class D, class I>
+        template<class D, class I1, class I2>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) {
-#ifndef BOOST_UBLAS_SCALED_NORM
-            real_type t = real_type ();
-            while (-- size >= 0) {
-                real_type u (type_traits<value_type>::norm_2 (*it));
-                t +=  u * u;
-                ++ it;
+        result_type apply (D size, I1 it1, I2 it2) {
+            result_type t = result_type (0);
+            result_type i = result_type (0);
+            result_type mean1 = result_type (0);
+            result_type mean2 = result_type (0);
+            result_type del1, del2;
+#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
+            while (++ i <= size) {
+                del1 = (*it1 - mean1) / i;
+                mean1 += del1;
+                del2 = (*it2 - mean2) / i;
+                mean2 += del2;
+                t += (i - 1) * del1 * del2 - t / i;
+                ++ it1;
+                ++ it2;
             }
-            return static_cast<result_type>(type_traits<real_type>::type_sqrt (t));
 #else
-            real_type scale = real_type ();
-            real_type sum_squares (1);
-            while (-- size >= 0) {
-                real_type u (type_traits<value_type>::norm_2 (*it));
-                if (scale < u) {
-                    real_type v (scale / u);
-                    sum_squares = sum_squares * v * v + real_type (1);
-                    scale = u;
-                } else {
-                    real_type v (u / scale);
-                    sum_squares += v * v;
-                }
-                ++ it;
-            }
-            return static_cast<result_type>(scale * type_traits<real_type>::type_sqrt (sum_squares));
+            DD (size, 4, r, del1 = (*it1 - mean1) / (i + 1),
+                mean1 += del1,
+                del2 = (*it2 - mean2) / (i + 1),
+                mean2 += del2,
+                t += i * del1 * del2 - t / (i + 1),
+                ++ it1, ++ it2, ++ i);
 #endif
+            return size / (size - 1) * t;
         }
-        // Sparse case
-        template<class I>
+
+        // Packed case
+        template<class I1, class I2>
         static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-#ifndef BOOST_UBLAS_SCALED_NORM
-            real_type t = real_type ();
-            while (it != it_end) {
-                real_type u (type_traits<value_type>::norm_2 (*it));
-                t +=  u * u;
-                ++ it;
+        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end) {
+            result_type t = result_type (0);
+            result_type i = result_type (0);
+            result_type mean1 = result_type (0);
+            result_type mean2 = result_type (0);
+            result_type del1, del2;
+            typedef typename I1::difference_type vector_difference_type;
+            vector_difference_type it1_size (it1_end - it1);
+            vector_difference_type it2_size (it2_end - it2);
+            vector_difference_type diff (0);
+            if (it1_size > 0 && it2_size > 0)
+                diff = it2.index () - it1.index ();
+            if (diff != 0) {
+                vector_difference_type size = (std::min) (diff, it1_size);
+                if (size > 0) {
+                    it1 += size;
+                    it1_size -= size;
+                    diff -= size;
+                }
+                size = (std::min) (- diff, it2_size);
+                if (size > 0) {
+                    it2 += size;
+                    it2_size -= size;
+                    diff += size;
+                }
             }
-            return static_cast<result_type>(type_traits<real_type>::type_sqrt (t));
-#else
-            real_type scale = real_type ();
-            real_type sum_squares (1);
-            while (it != it_end) {
-                real_type u (type_traits<value_type>::norm_2 (*it));
-                if (scale < u) {
-                    real_type v (scale / u);
-                    sum_squares = sum_squares * v * v + real_type (1);
-                    scale = u;
-                } else {
-                    real_type v (u / scale);
-                    sum_squares += v * v;
+            vector_difference_type size ((std::min) (it1_size, it2_size));
+            while (++ i <= size) {
+                del1 = (*it1 - mean1) / i;
+                mean1 += del1;
+                del2 = (*it2 - mean2) / i;
+                mean2 += del2;
+                t += (i - 1) * del1 * del2 - t / i;
+                ++ it1;
+                ++ it2;
+            }
+            return size / (size - 1) * t;
+        }
+
+        // Sparse case
+        template<class I1, class I2>
+        static BOOST_UBLAS_INLINE
+        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end, sparse_bidirectional_iterator_tag) {
+            typedef typename I1::difference_type vector_difference_type;
+            result_type t = result_type (0);
+            vector_difference_type i (1);
+            result_type mean1 = result_type (0);
+            result_type mean2 = result_type (0);
+            result_type del1, del2;
+            if (it1 != it1_end && it2 != it2_end) {
+                for (;;) {
+                    if (it1.index () == it2.index ()) {
+                        del1 = (*it1 - mean1) / i;
+                        mean1 += del1;
+                        del2 = (*it2 - mean2) / i;
+                        mean2 += del2;
+                        t += (i - 1) * del1 * del2 - t / i;
+                        ++ i;
+                        ++ it1;
+                        ++ it2;
+                        if (it1 == it1_end || it2 == it2_end)
+                            break;
+                    } else if (it1.index () < it2.index ()) {
+                        increment (it1, it1_end, it2.index () - it1.index ());
+                        if (it1 == it1_end)
+                            break;
+                    } else if (it1.index () > it2.index ()) {
+                        increment (it2, it2_end, it1.index () - it2.index ());
+                        if (it2 == it2_end)
+                            break;
+                    }
                 }
-                ++ it;
             }
-            return static_cast<result_type>(scale * type_traits<real_type>::type_sqrt (sum_squares));
-#endif
+            return i / (i - 1) * t;
         }
     };
 
-    template<class V>
-    struct vector_norm_2_square :
-        public vector_scalar_real_unary_functor<V> {
-        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
-        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
+    // Pearson correlation from one pass of bivariate Welford updates of the
+    // means and of the centered second moments
+    template<class V1, class V2, class TV>
+    struct vector_correlation:
+        public vector_scalar_binary_functor<V1, V2, TV> {
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::value_type value_type;
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::result_type result_type;
 
-        template<class E>
+        template<class E1, class E2>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) {
-            real_type t = real_type ();
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
+        result_type apply (const vector_expression<E1> &e1, const vector_expression<E2> &e2) {
+            typedef typename E1::size_type vector_size_type;
+            vector_size_type size (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()));
+            value_type mean1 = value_type (0);
+            value_type mean2 = value_type (0);
+            value_type m11 = value_type (0);
+            value_type m22 = value_type (0);
+            value_type m12 = value_type (0);
             for (vector_size_type i = 0; i < size; ++ i) {
-                real_type u (type_traits<value_type>::norm_2 (e () (i)));
-                t +=  u * u;
-            }
-            return t;
-        }
-        // Dense case
-        template<class D, class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) {
-            real_type t = real_type ();
-            while (-- size >= 0) {
-                real_type u (type_traits<value_type>::norm_2 (*it));
-                t +=  u * u;
-                ++ it;
-            }
-            return t;
+                value_type x1 (e1 () (i));
+                value_type x2 (e2 () (i));
+                value_type del1 = x1 - mean1;
+                value_type del2 = x2 - mean2;
+                mean1 += del1 / value_type (i + 1);
+                mean2 += del2 / value_type (i + 1);
+                m11 += del1 * (x1 - mean1);
+                m22 += del2 * (x2 - mean2);
+                m12 += del1 * (x2 - mean2);
+            }
+            return m12 / type_traits<value_type>::type_sqrt (m11 * m22);
         }
-        // Sparse case
-        template<class I>
+    };
+
+    // Weighted covariance of vector_weighted_mean: the bivariate form of
+    // West's update, as vector_correlation
+    template<class V1, class V2, class TV>
+    struct vector_weighted_covariance:
+        public vector_scalar_binary_functor<V1, V2, TV> {
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::value_type value_type;
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::result_type result_type;
+
+        template<class E1, class E2, class W>
         static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            real_type t = real_type ();
-            while (it != it_end) {
-                real_type u (type_traits<value_type>::norm_2 (*it));
-                t +=  u * u;
-                ++ it;
-            }
-            return t;
+        result_type apply (const vector_expression<E1> &e1, const vector_expression<E2> &e2, const vector_expression<W> &w) {
+            typedef typename E1::size_type vector_size_type;
+            vector_size_type size (BOOST_UBLAS_SAME (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()), w ().size ()));
+            value_type weight = value_type (0);
+            value_type mean1 = value_type (0);
+            value_type mean2 = value_type (0);
+            value_type m12 = value_type (0);
+            for (vector_size_type i = 0; i < size; ++ i) {
+                value_type wi (w () (i));
+                if (wi == value_type (0))
+                    continue;
+                weight += wi;
+                value_type x1 (e1 () (i));
+                value_type x2 (e2 () (i));
+                value_type del1 = x1 - mean1;
+                mean1 += del1 * (wi / weight);
+                mean2 += (x2 - mean2) * (wi / weight);
+                m12 += wi * del1 * (x2 - mean2);
+            }
+            return m12 / weight;
         }
     };
 
+    // Ordering by value for the rank based statistics. Unlike median and
+    // quantile, they rank by value and not by magnitude. Ranks of integral
+    // elements are fractional when there are ties, so they are kept as
+    // double.
+    template<class T>
+    struct rank_traits {
+        typedef typename boost::mpl::if_c<boost::is_integral<T>::value, double, T>::type value_type;
+    };
+
+    // Indices that sort e in ascending order; equal elements keep their
+    // order. The elements are sorted together with their indices, so no
+    // comparison goes through the expression.
     template<class V>
-    struct vector_norm_inf:
-        public vector_scalar_real_unary_functor<V> {
-        typedef typename vector_scalar_real_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_real_unary_functor<V>::real_type real_type;
-        typedef typename vector_scalar_real_unary_functor<V>::result_type result_type;
+    struct vector_argsort {
+        typedef typename V::value_type value_type;
+        typedef typename V::size_type size_type;
 
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) {
-            real_type t = real_type ();
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            for (vector_size_type i = 0; i < size; ++ i) {
-                real_type u (type_traits<value_type>::norm_inf (e () (i)));
-                if (u > t)
-                    t = u;
-            }
-            return t;
-        }
-        // Dense case
-        template<class D, class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) {
-            real_type t = real_type ();
-            while (-- size >= 0) {
-                real_type u (type_traits<value_type>::norm_inf (*it));
-                if (u > t)
-                    t = u;
-                ++ it;
-            }
-            return t;
+        void apply (const vector_expression<E> &e, std::vector<std::pair<value_type, size_type> > &order) {
+            size_type size (e ().size ());
+            order.resize (size);
+            for (size_type i = 0; i < size; ++ i)
+                order [i] = std::make_pair (value_type (e () (i)), i);
+            std::sort (order.begin (), order.end ());
         }
-        // Sparse case
-        template<class I>
+
+        template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) { 
-            real_type t = real_type ();
-            while (it != it_end) {
-                real_type u (type_traits<value_type>::norm_inf (*it));
-                if (u > t) 
-                    t = u;
-                ++ it;
-            }
-            return t; 
+        void apply (const vector_expression<E> &e, vector<size_type> &r) {
+            std::vector<std::pair<value_type, size_type> > order;
+            apply (e, order);
+            r.resize (order.size (), false);
+            for (size_type i = 0; i < order.size (); ++ i)
+                r (i) = order [i].second;
         }
     };
 
-    // Unary returning index
+    // Ranks 1, ..., size of the elements of e, tied elements sharing the
+    // average of their ranks. The sort buffer is passed in, so repeated
+    // calls (one per variable of spearman_matrix) reuse it.
     template<class V>
-    struct vector_scalar_index_unary_functor {
+    struct vector_rank {
         typedef typename V::value_type value_type;
-        typedef typename type_traits<value_type>::real_type real_type;
-        typedef typename V::size_type result_type;
-    };
+        typedef typename V::size_type size_type;
+        typedef typename rank_traits<value_type>::value_type result_type;
 
-    template<class V>
-    struct vector_index_norm_inf:
-        public vector_scalar_index_unary_functor<V> {
-        typedef typename vector_scalar_index_unary_functor<V>::value_type value_type;
-        typedef typename vector_scalar_index_unary_functor<V>::real_type real_type;
-        typedef typename vector_scalar_index_unary_functor<V>::result_type result_type;
+        template<class E, class R>
+        static BOOST_UBLAS_INLINE
+        void apply (const vector_expression<E> &e, std::vector<std::pair<value_type, size_type> > &order, R r) {
+            vector_argsort<V>::apply (e, order);
+            size_type size (order.size ());
+            for (size_type first = 0; first < size;) {
+                size_type last (first + 1);
+                while (last < size && order [last].first == order [first].first)
+                    ++ last;
+                result_type t ((result_type (first) + result_type (last - 1)) / result_type (2) + result_type (1));
+                for (size_type i = first; i < last; ++ i)
+                    r [order [i].second] = t;
+                first = last;
+            }
+        }
 
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E> &e) {
-            // ISSUE For CBLAS compatibility return 0 index in empty case
-            result_type i_norm_inf (0);
-            real_type t = real_type ();
-            typedef typename E::size_type vector_size_type;
-            vector_size_type size (e ().size ());
-            for (vector_size_type i = 0; i < size; ++ i) {
-                real_type u (type_traits<value_type>::norm_inf (e () (i)));
-                if (u > t) {
-                    i_norm_inf = i;
-                    t = u;
-                }
-            }
-            return i_norm_inf;
+        void apply (const vector_expression<E> &e, vector<result_type> &r) {
+            std::vector<std::pair<value_type, size_type> > order;
+            r.resize (e ().size (), false);
+            apply (e, order, r.begin ());
         }
-        // Dense case
-        template<class D, class I>
+    };
+
+    // Kendall's tau-b, with Knight's O(size log size) algorithm. The pairs
+    // are sorted by (e1, e2). A bottom up merge sort of the e2 values then
+    // counts the discordant pairs as inversions. Tied pairs are counted
+    // from runs in the sorted orders.
+    template<class V1, class V2, class TV>
+    struct vector_kendall:
+        public vector_scalar_binary_functor<V1, V2, TV> {
+        typedef typename vector_scalar_binary_functor<V1, V2, TV>::value_type value_type;
+        typedef typename rank_traits<value_type>::value_type result_type;
+
+        template<class E1, class E2>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I it) {
-            // ISSUE For CBLAS compatibility return 0 index in empty case
-            result_type i_norm_inf (0);
-            real_type t = real_type ();
-            while (-- size >= 0) {
-                real_type u (type_traits<value_type>::norm_inf (*it));
-                if (u > t) {
-                    i_norm_inf = it.index ();
-                    t = u;
+        result_type apply (const vector_expression<E1> &e1, const vector_expression<E2> &e2) {
+            typedef typename E1::size_type vector_size_type;
+            typedef std::pair<value_type, value_type> element;
+            vector_size_type size (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()));
+            std::vector<element> p (size);
+            for (vector_size_type i = 0; i < size; ++ i)
+                p [i] = element (e1 () (i), e2 () (i));
+            std::sort (p.begin (), p.end ());
+
+            boost::uint64_t x_ties (0), joint_ties (0);
+            for (vector_size_type first = 0; first < size;) {
+                vector_size_type last (first + 1);
+                while (last < size && p [last].first == p [first].first)
+                    ++ last;
+                x_ties += pairs (last - first);
+                for (vector_size_type i = first; i < last;) {
+                    vector_size_type j (i + 1);
+                    while (j < last && p [j].second == p [i].second)
+                        ++ j;
+                    joint_ties += pairs (j - i);
+                    i = j;
                 }
-                ++ it;
+                first = last;
             }
-            return i_norm_inf;
-        }
-        // Sparse case
-        template<class I>
-        static BOOST_UBLAS_INLINE
-        result_type apply (I it, const I &it_end) {
-            // ISSUE For CBLAS compatibility return 0 index in empty case
-            result_type i_norm_inf (0);
-            real_type t = real_type ();
-            while (it != it_end) {
-                real_type u (type_traits<value_type>::norm_inf (*it));
-                if (u > t) {
-                    i_norm_inf = it.index ();
-                    t = u;
+
+            std::vector<value_type> y (size), scratch (size);
+            for (vector_size_type i = 0; i < size; ++ i)
+                y [i] = p [i].second;
+            boost::uint64_t swaps (0);
+            for (vector_size_type width = 1; width < size; width *= 2) {
+                for (vector_size_type lo = 0; lo < size; lo += 2 * width) {
+                    vector_size_type mid ((std::min) (lo + width, size));
+                    vector_size_type hi ((std::min) (lo + 2 * width, size));
+                    vector_size_type i (lo), j (mid), k (lo);
+                    while (i < mid && j < hi) {
+                        if (y [j] < y [i]) {
+                            swaps += mid - i;
+                            scratch [k ++] = y [j ++];
+                        }
+                        else
+                            scratch [k ++] = y [i ++];
+                    }
+                    while (i < mid)
+                        scratch [k ++] = y [i ++];
+                    while (j < hi)
+                        scratch [k ++] = y [j ++];
                 }
-                ++ it;
+                y.swap (scratch);
             }
-            return i_norm_inf;
+
+            boost::uint64_t y_ties (0);
+            for (vector_size_type first = 0; first < size;) {
+                vector_size_type last (first + 1);
+                while (last < size && y [last] == y [first])
+                    ++ last;
+                y_ties += pairs (last - first);
+                first = last;
+            }
+
+            boost::uint64_t total (pairs (size));
+            result_type concordance (result_type (total) - result_type (x_ties) - result_type (y_ties) +
+                                     result_type (joint_ties) - result_type (2) * result_type (swaps));
+            return concordance / type_traits<result_type>::type_sqrt (result_type (total - x_ties) * result_type (total - y_ties));
         }
-    };
 
-    // Binary returning scalar
-    template<class V1, class V2, class TV>
-    struct vector_scalar_binary_functor {
-        typedef TV value_type;
-        typedef TV result_type;
+    private:
+        template<class S>
+        static BOOST_UBLAS_INLINE
+        boost::uint64_t pairs (S n) {
+            return boost::uint64_t (n) * (boost::uint64_t (n) - 1) / 2;
+        }
     };
 
-    template<class V1, class V2, class TV>
-    struct vector_inner_prod:
-        public vector_scalar_binary_functor<V1, V2, TV> {
-        typedef typename vector_scalar_binary_functor<V1, V2, TV>::value_type value_type;
-        typedef typename vector_scalar_binary_functor<V1, V2, TV>::result_type result_type;
+    // Rolling window functors: apply (e, w, r) sets r (i) to the statistic
+    // of e (i), ..., e (i + w - 1) for every full window, sliding the window
+    // one element at a time instead of recomputing it.
+    template<class V>
+    struct vector_rolling_functor {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+        typedef typename V::size_type size_type;
 
-        template<class C1, class C2>
+        // Number of full windows of width w
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_container<C1> &c1,
-                           const vector_container<C2> &c2) {
-#ifdef BOOST_UBLAS_USE_SIMD
-            using namespace raw;
-            typedef typename C1::size_type vector_size_type;
-            vector_size_type size (BOOST_UBLAS_SAME (c1 ().size (), c2 ().size ()));
-            const typename V1::value_type *data1 = data_const (c1 ());
-            const typename V1::value_type *data2 = data_const (c2 ());
-            vector_size_type s1 = stride (c1 ());
-            vector_size_type s2 = stride (c2 ());
-            result_type t = result_type (0);
-            if (s1 == 1 && s2 == 1) {
-                for (vector_size_type i = 0; i < size; ++ i)
-                    t += data1 [i] * data2 [i];
-            } else if (s2 == 1) {
-                for (vector_size_type i = 0, i1 = 0; i < size; ++ i, i1 += s1)
-                    t += data1 [i1] * data2 [i];
-            } else if (s1 == 1) {
-                for (vector_size_type i = 0, i2 = 0; i < size; ++ i, i2 += s2)
-                    t += data1 [i] * data2 [i2];
-            } else {
-                for (vector_size_type i = 0, i1 = 0, i2 = 0; i < size; ++ i, i1 += s1, i2 += s2)
-                    t += data1 [i1] * data2 [i2];
+        size_type windows (size_type size, size_type w) {
+            BOOST_UBLAS_CHECK (w > size_type (0), bad_argument ());
+            return w > size_type (0) && size >= w ? size - w + 1 : size_type (0);
+        }
+    };
+
+    // Mean and sum of squared deviations of the finite values of a window
+    // of fixed width: one value enters and one leaves per step. NaNs and
+    // infinities are skipped as in vector_nanmedian, and a window without
+    // finite values gives NaN. The moments are rebuilt from the window every
+    // w steps, and when the leaving value carries most of m2, so that the
+    // rounding error of a large value does not outlive it.
+    template<class T, class S>
+    struct window_moments {
+        typedef T value_type;
+        typedef S size_type;
+        typedef typename type_traits<T>::real_type real_type;
+
+        BOOST_UBLAS_INLINE
+        explicit window_moments (size_type w):
+            w (w), n (0), steps (0), mean (0), m2 (0) {}
+
+        // Moments of e (first), ..., e (first + w - 1)
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void rebuild (const E &e, size_type first) {
+            n = 0;
+            steps = 0;
+            mean = m2 = value_type (0);
+            for (size_type i = first; i < first + w; ++ i)
+                push (e (i));
+        }
+        // Moves the window from e (first - 1), ... to e (first), ...
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void slide (const E &e, size_type first) {
+            value_type y (e (first - 1));
+            if (++ steps == w || (finite (y) && (y - mean) * (y - mean) > m2 / value_type (2))) {
+                rebuild (e, first);
+                return;
             }
-            return t;
-#elif defined(BOOST_UBLAS_HAVE_BINDINGS)
-            return boost::numeric::bindings::atlas::dot (c1 (), c2 ());
-#else
-            return apply (static_cast<const vector_expression<C1> > (c1), static_cast<const vector_expression<C2> > (c2));
-#endif
+            pop (y);
+            push (e (first + w - 1));
         }
-        template<class E1, class E2>
+
+        BOOST_UBLAS_INLINE
+        value_type window_mean () const {
+            return n > size_type (0) ? mean : std::numeric_limits<value_type>::quiet_NaN ();
+        }
+        BOOST_UBLAS_INLINE
+        value_type window_variance () const {
+            return n > size_type (0) ? m2 / value_type (n) : std::numeric_limits<value_type>::quiet_NaN ();
+        }
+
+    private:
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E1> &e1,
-                           const vector_expression<E2> &e2) {
-            typedef typename E1::size_type vector_size_type;
-            vector_size_type size (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()));
-            result_type t = result_type (0);
-#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
-            for (vector_size_type i = 0; i < size; ++ i)
-                t += e1 () (i) * e2 () (i);
-#else
-            vector_size_type i (0);
-            DD (size, 4, r, (t += e1 () (i) * e2 () (i), ++ i));
-#endif
-            return t;
+        bool finite (const value_type &x) {
+            return type_traits<value_type>::type_abs (x) <= (std::numeric_limits<real_type>::max) ();
         }
-        // Dense case
-        template<class D, class I1, class I2>
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (! finite (x))
+                return;
+            ++ n;
+            value_type del = x - mean;
+            mean += del / value_type (n);
+            m2 += del * (x - mean);
+        }
+        BOOST_UBLAS_INLINE
+        void pop (const value_type &y) {
+            if (! finite (y))
+                return;
+            if (-- n == size_type (0)) {
+                mean = m2 = value_type (0);
+                return;
+            }
+            value_type old_mean = mean;
+            mean -= (y - mean) / value_type (n);
+            m2 -= (y - old_mean) * (y - mean);
+            if (m2 < value_type (0))
+                m2 = value_type (0);
+        }
+
+        size_type w;
+        size_type n;
+        size_type steps;
+        value_type mean;
+        value_type m2;
+    };
+
+    template<class V>
+    struct vector_rolling_mean:
+        public vector_rolling_functor<V> {
+        typedef typename vector_rolling_functor<V>::value_type value_type;
+        typedef typename vector_rolling_functor<V>::result_type result_type;
+        typedef typename vector_rolling_functor<V>::size_type size_type;
+
+        template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I1 it1, I2 it2) {
-            result_type t = result_type (0);
-#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
-            while (-- size >= 0)
-                t += *it1 * *it2, ++ it1, ++ it2;
-#else
-            DD (size, 4, r, (t += *it1 * *it2, ++ it1, ++ it2));
-#endif
-            return t;
+        void apply (const vector_expression<E> &e, size_type w, vector<result_type> &r) {
+            r.resize (vector_rolling_functor<V>::windows (e ().size (), w), false);
+            if (r.size () == 0)
+                return;
+            window_moments<result_type, size_type> m (w);
+            m.rebuild (e (), 0);
+            r (0) = m.window_mean ();
+            for (size_type i = 1; i < r.size (); ++ i) {
+                m.slide (e (), i);
+                r (i) = m.window_mean ();
+            }
         }
-        // Packed case
-        template<class I1, class I2>
+    };
+
+    // Population variance of every window, as variance (v)
+    template<class V>
+    struct vector_rolling_variance:
+        public vector_rolling_functor<V> {
+        typedef typename vector_rolling_functor<V>::value_type value_type;
+        typedef typename vector_rolling_functor<V>::result_type result_type;
+        typedef typename vector_rolling_functor<V>::size_type size_type;
+
+        template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end) {
-            result_type t = result_type (0);
-            typedef typename I1::difference_type vector_difference_type;
-            vector_difference_type it1_size (it1_end - it1);
-            vector_difference_type it2_size (it2_end - it2);
-            vector_difference_type diff (0);
-            if (it1_size > 0 && it2_size > 0)
-                diff = it2.index () - it1.index ();
-            if (diff != 0) {
-                vector_difference_type size = (std::min) (diff, it1_size);
-                if (size > 0) {
-                    it1 += size;
-                    it1_size -= size;
-                    diff -= size;
-                }
-                size = (std::min) (- diff, it2_size);
-                if (size > 0) {
-                    it2 += size;
-                    it2_size -= size;
-                    diff += size;
-                }
+        void apply (const vector_expression<E> &e, size_type w, vector<result_type> &r) {
+            r.resize (vector_rolling_functor<V>::windows (e ().size (), w), false);
+            if (r.size () == 0)
+                return;
+            window_moments<result_type, size_type> m (w);
+            m.rebuild (e (), 0);
+            r (0) = m.window_variance ();
+            for (size_type i = 1; i < r.size (); ++ i) {
+                m.slide (e (), i);
+                r (i) = m.window_variance ();
             }
-            vector_difference_type size ((std::min) (it1_size, it2_size));
-            while (-- size >= 0)
-                t += *it1 * *it2, ++ it1, ++ it2;
-            return t;
         }
-        // Sparse case
-        template<class I1, class I2>
+    };
+
+    // Magnitude ordered extremum of every window as in vector_min (Compare
+    // is std::greater) and vector_max (Compare is std::less). A deque keeps
+    // the candidates of the window from best to worst, so each element is
+    // pushed and popped once; ties keep the first element.
+    template<class V, class Compare>
+    struct vector_rolling_extremum:
+        public vector_rolling_functor<V> {
+        typedef typename vector_rolling_functor<V>::value_type value_type;
+        typedef typename vector_rolling_functor<V>::result_type result_type;
+        typedef typename vector_rolling_functor<V>::size_type size_type;
+
+        template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end, sparse_bidirectional_iterator_tag) {
-            result_type t = result_type (0);
-            if (it1 != it1_end && it2 != it2_end) {
-                for (;;) {
-                    if (it1.index () == it2.index ()) {
-                        t += *it1 * *it2, ++ it1, ++ it2;
-                        if (it1 == it1_end || it2 == it2_end)
-                            break;
-                    } else if (it1.index () < it2.index ()) {
-                        increment (it1, it1_end, it2.index () - it1.index ());
-                        if (it1 == it1_end)
-                            break;
-                    } else if (it1.index () > it2.index ()) {
-                        increment (it2, it2_end, it1.index () - it2.index ());
-                        if (it2 == it2_end)
-                            break;
-                    }
+        void apply (const vector_expression<E> &e, size_type w, vector<result_type> &r) {
+            r.resize (vector_rolling_functor<V>::windows (e ().size (), w), false);
+            if (r.size () == 0)
+                return;
+            std::deque<std::pair<size_type, value_type> > candidates;
+            for (size_type i = 0; i < r.size () + w - 1; ++ i) {
+                value_type x (e () (i));
+                while (! candidates.empty () &&
+                       Compare () (type_traits<value_type>::type_abs (candidates.back ().second), type_traits<value_type>::type_abs (x)))
+                    candidates.pop_back ();
+                candidates.push_back (std::make_pair (i, x));
+                if (i + 1 >= w) {
+                    if (candidates.front ().first + w <= i)
+                        candidates.pop_front ();
+                    r (i + 1 - w) = candidates.front ().second;
                 }
             }
-            return t;
         }
     };
 
-    template<class V1, class V2, class TV>
-    struct vector_covariance:
-        public vector_scalar_binary_functor<V1, V2, TV> {
-        typedef typename vector_scalar_binary_functor<V1, V2, TV>::value_type value_type;
-        typedef typename vector_scalar_binary_functor<V1, V2, TV>::result_type result_type;
+    // Median of every window under the magnitude ordering of vector_median.
+    // The window is split into an ordered lower and upper half, so a step
+    // costs O(log w). NaNs
+    // are skipped as in vector_nanmedian, and a window of only NaNs gives NaN.
+    template<class V>
+    struct vector_rolling_median:
+        public vector_rolling_functor<V> {
+        typedef typename vector_rolling_functor<V>::value_type value_type;
+        typedef typename vector_rolling_functor<V>::result_type result_type;
+        typedef typename vector_rolling_functor<V>::size_type size_type;
 
-        template<class C1, class C2>
+        template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_container<C1> &c1, const vector_container<C2> &c2) {
-#ifdef BOOST_UBLAS_USE_SIMD
-            using namespace raw;
-            typedef typename C1::size_type vector_size_type;
-            vector_size_type size (BOOST_UBLAS_SAME (c1 ().size (), c2 ().size ()));
-            const typename V1::value_type *data1 = data_const (c1 ());
-            const typename V1::value_type *data2 = data_const (c2 ());
-            vector_size_type s1 = stride (c1 ());
-            vector_size_type s2 = stride (c2 ());
-            result_type t = result_type (0);
-            result_type mean1 = result_type (0);
-            result_type mean2 = result_type (0);
-            result_type del1, del2;
-            if (s1 == 1 && s2 == 1) {
-                for (vector_size_type i = 0; i < size; ++ i) {
-                    del1 = (data1[i] - mean1) / (i + 1);
-                    mean1 += del1;
-                    del2 = (data2[i] - mean2) / (i + 1);
-                    mean2 += del2;
-                    t += i * del1 * del2 - t / (i + 1);
+        void apply (const vector_expression<E> &e, size_type w, vector<result_type> &r) {
+            r.resize (vector_rolling_functor<V>::windows (e ().size (), w), false);
+            if (r.size () == 0)
+                return;
+            half_type lower (compareElement), upper (compareElement);
+            for (size_type i = 0; i < r.size () + w - 1; ++ i) {
+                value_type x (e () (i));
+                if (x == x) {
+                    if (lower.empty () || ! compareElement (*lower.rbegin (), x))
+                        lower.insert (x);
+                    else
+                        upper.insert (x);
                 }
-            } else if (s2 == 1) {
-                for (vector_size_type i = 0, i1 = 0; i < size; ++ i, i1 += s1) {
-                    del1 = (data1[i1] - mean1) / (i + 1);
-                    mean1 += del1;
-                    del2 = (data2[i] - mean2) / (i + 1);
-                    mean2 += del2;
-                    t += i * del1 * del2 - t / (i + 1);
+                if (i >= w) {
+                    value_type y (e () (i - w));
+                    if (y == y)
+                        remove (! compareElement (*lower.rbegin (), y) ? lower : upper, y);
                 }
-            } else if (s1 == 1) {
-                for (vector_size_type i = 0, i2 = 0; i < size; ++ i, i2 += s2) {
-                    del1 = (data1[i] - mean1) / (i + 1);
-                    mean1 += del1;
-                    del2 = (data2[i2] - mean2) / (i + 1);
-                    mean2 += del2;
-                    t += i * del1 * del2 - t / (i + 1);
+                // lower holds the first (n + 1) / 2 of the n valid elements
+                // of the window
+                while (lower.size () > upper.size () + 1) {
+                    upper.insert (*lower.rbegin ());
+                    lower.erase (-- lower.end ());
                 }
-            } else {
-                for (vector_size_type i = 0, i1 = 0, i2 = 0; i < size; ++ i, i1 += s1, i2 += s2) {
-                    del1 = (data1[i1] - mean1) / (i + 1);
-                    mean1 += del1;
-                    del2 = (data2[i2] - mean2) / (i + 1);
-                    mean2 += del2;
-                    t += i * del1 * del2 - t / (i + 1);
+                while (upper.size () > lower.size ()) {
+                    lower.insert (*upper.begin ());
+                    upper.erase (upper.begin ());
+                }
+                if (i + 1 >= w) {
+                    if (lower.empty ())
+                        r (i + 1 - w) = std::numeric_limits<result_type>::quiet_NaN ();
+                    else if (lower.size () > upper.size ())
+                        r (i + 1 - w) = *lower.rbegin ();
+                    else
+                        r (i + 1 - w) = (*lower.rbegin () + *upper.begin ()) / 2;
                 }
             }
-            return size / (size - 1) * t;
-#else
-            return apply (static_cast<const vector_expression<C1> > (c1), static_cast<const vector_expression<C2> > (c2));
-#endif
         }
 
-        template<class E1, class E2>
         static BOOST_UBLAS_INLINE
-        result_type apply (const vector_expression<E1> &e1, const vector_expression<E2> &e2) {
-            typedef typename E1::size_type vector_size_type;
-            vector_size_type size (BOOST_UBLAS_SAME (e1 ().size (), e2 ().size ()));
-            result_type t = result_type (0);
-            result_type mean1 = result_type (0);
-            result_type mean2 = result_type (0);
-            result_type del1, del2;
-#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
+        bool compareElement (const value_type &A, const value_type &B) {
+            return magnitude_less (A, B);
+        }
+
+    private:
+        typedef std::multiset<value_type, bool (*) (const value_type &, const value_type &)> half_type;
+
+        static BOOST_UBLAS_INLINE
+        void remove (half_type &half, const value_type &y) {
+            typename half_type::iterator it (half.find (y));
+            BOOST_UBLAS_CHECK (it != half.end (), internal_logic ());
+            if (it != half.end ())
+                half.erase (it);
+        }
+    };
+
+    // Pushes e (i) for the indices of chunk c into the partial of its group
+    // among the partials of chunk c
+    template<class E, class K, class P>
+    class group_reduce_kernel {
+    public:
+        typedef typename E::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        group_reduce_kernel (const E &e, const group_index<K> &index, std::vector<std::vector<P> > &partials):
+            e_ (e), index_ (index), partials_ (partials) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type c, size_type first, size_type last) const {
+            std::vector<P> &p (partials_ [c]);
+            for (size_type i = first; i < last; ++ i)
+                p [index_.group (i)].push (e_ (i));
+        }
+
+    private:
+        const E &e_;
+        const group_index<K> &index_;
+        std::vector<std::vector<P> > &partials_;
+    };
+
+    // Per group statistic of the elements of a vector, in one traversal
+    // with one partial per group. Large vectors with few groups are split
+    // into parallel chunks with their own partials, merged in order.
+    template<class V, class Tag>
+    struct vector_group_reduce {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E, class K>
+        static BOOST_UBLAS_INLINE
+        void apply (const vector_expression<E> &e, const group_index<K> &index, vector<result_type> &r) {
+            typedef typename E::size_type vector_size_type;
+            typedef group_operation<result_type, vector_size_type, Tag> operation;
+            typedef typename operation::partial_type partial_type;
+            vector_size_type size (BOOST_UBLAS_SAME (e ().size (), vector_size_type (index.size ())));
+            vector_size_type groups (index.groups ());
+            vector_size_type chunks (detail::expression_chunks<E> (size));
+            if (groups > vector_size_type (0) && chunks > size / groups)
+                chunks = (std::max) (size / groups, vector_size_type (1));
+            std::vector<std::vector<partial_type> > partials (chunks, std::vector<partial_type> (groups));
+            group_reduce_kernel<E, K, partial_type> kernel (e (), index, partials);
+            detail::reduce_chunks (size, chunks, kernel);
+            r.resize (groups, false);
+            for (vector_size_type k = 0; k < groups; ++ k) {
+                for (vector_size_type c = 1; c < chunks; ++ c)
+                    partials [0] [k].merge (partials [c] [k]);
+                r (k) = operation::value (partials [0] [k]);
+            }
+        }
+    };
+
+    // A robust statistic (mad_statistic, iqr_statistic or
+    // trimmed_mean_statistic) of a copy of the elements of e
+    template<class V>
+    struct vector_robust {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E, class S>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e, const S &statistic) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            std::vector<value_type> v (size);
+            for (vector_size_type i = 0; i < size; ++ i)
+                v [i] = e () (i);
+            return statistic (v.begin (), v.end ());
+        }
+    };
+
+    // Elements of e clipped to the limits of select_winsor_limits
+    template<class V>
+    struct vector_winsorize {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const vector_expression<E> &e, double lo, double hi, vector<result_type> &r) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            r.resize (size, false);
+            if (size == vector_size_type (0))
+                return;
+            for (vector_size_type i = 0; i < size; ++ i)
+                r (i) = e () (i);
+            value_type lower, upper;
+            select_winsor_limits (r.begin (), r.end (), lo, hi, lower, upper);
             for (vector_size_type i = 0; i < size; ++ i) {
-                del1 = (e1 () (i) - mean1) / (i + 1);
-                mean1 += del1;
-                del2 = (e2 () (i) - mean2) / (i + 1);
-                mean2 += del2;
-                t += i * del1 * del2 - t / (i + 1);
+                value_type x (e () (i));
+                r (i) = x < lower ? lower : (upper < x ? upper : x);
             }
-#else
-            vector_size_type i (0);
-            DD (size, 4, r, del1 = (e1 () (i) - mean1) / (i + 1),
-                mean1 += del1,
-                del2 = (e2 () (i) - mean2) / (i + 1),
-                mean2 += del2,
-                t += i * del1 * del2 - t / (i + 1), ++ i);
-#endif
-            // return size / (size - 1) * t;
-            return t;
         }
+    };
 
-        // Dense case
-        template<class D, class I1, class I2>
+    // NaN aware statistics of a vector. Mean and variance reduce through
+    // nan_moments_partial, in the masked SIMD kernel for contiguous float
+    // and double storage. The median selects in a copy of the valid
+    // elements under the magnitude ordering of vector_median.
+    template<class V, class Tag>
+    struct vector_nan_moment {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (D size, I1 it1, I2 it2) {
-            result_type t = result_type (0);
-            result_type i = result_type (0);
-            result_type mean1 = result_type (0);
-            result_type mean2 = result_type (0);
-            result_type del1, del2;
-#ifndef BOOST_UBLAS_USE_DUFF_DEVICE
-            while (++ i <= size) {
-                del1 = (*it1 - mean1) / i;
-                mean1 += del1;
-                del2 = (*it2 - mean2) / i;
-                mean2 += del2;
-                t += (i - 1) * del1 * del2 - t / i;
-                ++ it1;
-                ++ it2;
+        result_type apply (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            return vector_reduce<nan_moments_partial<result_type, vector_size_type> > (e).value (Tag ());
+        }
+    };
+
+    template<class V, class Compare>
+    struct vector_nan_extremum {
+        typedef typename V::value_type value_type;
+        typedef typename V::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            return vector_reduce<nan_extremum_partial<result_type, Compare, vector_size_type> > (e).value ();
+        }
+    };
+
+    template<class V>
+    struct vector_nanmedian:
+        public vector_median<V> {
+        typedef typename vector_median<V>::value_type value_type;
+        typedef typename vector_median<V>::result_type result_type;
+        using vector_median<V>::compareElement;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            std::vector<value_type> v;
+            v.reserve (size);
+            for (vector_size_type i = 0; i < size; ++ i) {
+                value_type x (e () (i));
+                if (x == x)
+                    v.push_back (x);
             }
+            if (v.empty ())
+                return std::numeric_limits<result_type>::quiet_NaN ();
+            return select_median (v.begin (), v.end (), compareElement);
+        }
+    };
+
+    // Matrix functors
+
+    // Storage-order sweep behind the batched axis reductions and the
+    // stored element reductions over a whole matrix. Calls
+    // acc.push (k, x) for every element x the iterators visit, where k is
+    // the column index for axis 0 and the row index for axis 1. Sparse
+    // matrices only visit their stored elements.
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_axis_sweep (const matrix_expression<E> &e, typename E::size_type axis, A &acc, row_major_tag) {
+        typedef typename E::const_iterator1 const_iterator1_type;
+        typedef typename E::const_iterator2 const_iterator2_type;
+        const_iterator1_type it1 (e ().begin1 ());
+        const_iterator1_type it1_end (e ().end1 ());
+        while (it1 != it1_end) {
+#ifndef BOOST_UBLAS_NO_NESTED_CLASS_RELATION
+            const_iterator2_type it2 (it1.begin ());
+            const_iterator2_type it2_end (it1.end ());
 #else
-            DD (size, 4, r, del1 = (*it1 - mean1) / (i + 1),
-                mean1 += del1,
-                del2 = (*it2 - mean2) / (i + 1),
-                mean2 += del2,
-                t += i * del1 * del2 - t / (i + 1),
-                ++ it1, ++ it2, ++ i);
+            const_iterator2_type it2 (begin (it1, iterator1_tag ()));
+            const_iterator2_type it2_end (end (it1, iterator1_tag ()));
 #endif
-            return size / (size - 1) * t;
+            if (axis == 0)
+                // Row-major accumulate-into-vector kernel
+                while (it2 != it2_end) {
+                    acc.push (it2.index2 (), *it2);
+                    ++ it2;
+                }
+            else
+                while (it2 != it2_end) {
+                    acc.push (it2.index1 (), *it2);
+                    ++ it2;
+                }
+            ++ it1;
         }
-
-        // Packed case
-        template<class I1, class I2>
-        static BOOST_UBLAS_INLINE
-        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end) {
-            result_type t = result_type (0);
-            result_type i = result_type (0);
-            result_type mean1 = result_type (0);
-            result_type mean2 = result_type (0);
-            result_type del1, del2;
-            typedef typename I1::difference_type vector_difference_type;
-            vector_difference_type it1_size (it1_end - it1);
-            vector_difference_type it2_size (it2_end - it2);
-            vector_difference_type diff (0);
-            if (it1_size > 0 && it2_size > 0)
-                diff = it2.index () - it1.index ();
-            if (diff != 0) {
-                vector_difference_type size = (std::min) (diff, it1_size);
-                if (size > 0) {
-                    it1 += size;
-                    it1_size -= size;
-                    diff -= size;
+    }
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_axis_sweep (const matrix_expression<E> &e, typename E::size_type axis, A &acc, column_major_tag) {
+        typedef typename E::const_iterator1 const_iterator1_type;
+        typedef typename E::const_iterator2 const_iterator2_type;
+        const_iterator2_type it2 (e ().begin2 ());
+        const_iterator2_type it2_end (e ().end2 ());
+        while (it2 != it2_end) {
+#ifndef BOOST_UBLAS_NO_NESTED_CLASS_RELATION
+            const_iterator1_type it1 (it2.begin ());
+            const_iterator1_type it1_end (it2.end ());
+#else
+            const_iterator1_type it1 (begin (it2, iterator2_tag ()));
+            const_iterator1_type it1_end (end (it2, iterator2_tag ()));
+#endif
+            if (axis == 0)
+                while (it1 != it1_end) {
+                    acc.push (it1.index2 (), *it1);
+                    ++ it1;
                 }
-                size = (std::min) (- diff, it2_size);
-                if (size > 0) {
-                    it2 += size;
-                    it2_size -= size;
-                    diff += size;
+            else
+                while (it1 != it1_end) {
+                    acc.push (it1.index1 (), *it1);
+                    ++ it1;
                 }
+            ++ it2;
+        }
+    }
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_axis_sweep (const matrix_expression<E> &e, typename E::size_type axis, A &acc, unknown_orientation_tag) {
+        matrix_axis_sweep (e, axis, acc, row_major_tag ());
+    }
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_axis_sweep (const matrix_expression<E> &e, typename E::size_type axis, A &acc) {
+        matrix_axis_sweep (e, axis, acc, typename E::orientation_category ());
+    }
+
+    // Per-index running sums, counts and extrema filled by matrix_axis_sweep.
+    // Elements not visited by the sweep are implicit zeros and are accounted
+    // for once the sweep is done.
+    template<class T, class S>
+    class axis_moments_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit axis_moments_accumulator (size_type size):
+            count_ (size, size_type (0)), mean_ (size, value_type (0)), m2_ (size, value_type (0)) {}
+
+        // Welford update of slot k
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            size_type n = ++ count_ [k];
+            value_type del = x - mean_ [k];
+            mean_ [k] += del / value_type (n);
+            m2_ [k] += del * (x - mean_ [k]);
+        }
+
+        // Fold the length - count_ [k] implicit zeros into slot k
+        BOOST_UBLAS_INLINE
+        void finish (size_type k, size_type length, value_type &mean, value_type &m2) const {
+            size_type n = count_ [k];
+            if (n == length) {
+                mean = mean_ [k];
+                m2 = m2_ [k];
             }
-            vector_difference_type size ((std::min) (it1_size, it2_size));
-            while (++ i <= size) {
-                del1 = (*it1 - mean1) / i;
-                mean1 += del1;
-                del2 = (*it2 - mean2) / i;
-                mean2 += del2;
-                t += (i - 1) * del1 * del2 - t / i;
-                ++ it1;
-                ++ it2;
+            else {
+                value_type del = mean_ [k];
+                mean = mean_ [k] * value_type (n) / value_type (length);
+                m2 = m2_ [k] + del * del * value_type (n) * value_type (length - n) / value_type (length);
             }
-            return size / (size - 1) * t;
         }
 
-        // Sparse case
-        template<class I1, class I2>
-        static BOOST_UBLAS_INLINE
-        result_type apply (I1 it1, const I1 &it1_end, I2 it2, const I2 &it2_end, sparse_bidirectional_iterator_tag) {
-            typedef typename I1::difference_type vector_difference_type;
-            result_type t = result_type (0);
-            vector_difference_type i (1);
-            result_type mean1 = result_type (0);
-            result_type mean2 = result_type (0);
-            result_type del1, del2;
-            if (it1 != it1_end && it2 != it2_end) {
-                for (;;) {
-                    if (it1.index () == it2.index ()) {
-                        del1 = (*it1 - mean1) / i;
-                        mean1 += del1;
-                        del2 = (*it2 - mean2) / i;
-                        mean2 += del2;
-                        t += (i - 1) * del1 * del2 - t / i;
-                        ++ i;
-                        ++ it1;
-                        ++ it2;
-                        if (it1 == it1_end || it2 == it2_end)
-                            break;
-                    } else if (it1.index () < it2.index ()) {
-                        increment (it1, it1_end, it2.index () - it1.index ());
-                        if (it1 == it1_end)
-                            break;
-                    } else if (it1.index () > it2.index ()) {
-                        increment (it2, it2_end, it1.index () - it2.index ());
-                        if (it2 == it2_end)
-                            break;
-                    }
-                }
+    private:
+        std::vector<size_type> count_;
+        std::vector<value_type> mean_;
+        std::vector<value_type> m2_;
+    };
+
+    // One partial per index, filled by matrix_axis_sweep. The implicit zeros
+    // of an index are merged in as a partial of constant values.
+    template<class P, class S>
+    class axis_partial_accumulator {
+    public:
+        typedef typename P::value_type value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit axis_partial_accumulator (size_type size, const P &init = P ()):
+            init_ (init), partials_ (size, init) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            partials_ [k].push (x);
+        }
+
+        BOOST_UBLAS_INLINE
+        P finish (size_type k, size_type length) const {
+            P p (partials_ [k]);
+            if (p.count < length) {
+                P zeros (init_);
+                zeros.count = length - p.count;
+                p.merge (zeros);
             }
-            return i / (i - 1) * t;
+            return p;
         }
+
+    private:
+        P init_;
+        std::vector<P> partials_;
     };
 
-    // Matrix functors
+    // One NaN aware partial per index, filled by matrix_axis_sweep. The
+    // entries a sparse sweep does not visit are pushed as zeros.
+    template<class P, class S>
+    class axis_nan_accumulator {
+    public:
+        typedef typename P::value_type value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit axis_nan_accumulator (size_type size):
+            partials_ (size) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            partials_ [k].push (x);
+        }
+
+        BOOST_UBLAS_INLINE
+        P finish (size_type k, size_type length) const {
+            P p (partials_ [k]);
+            if (p.seen () < length)
+                p.push_zeros (length - p.seen ());
+            return p;
+        }
+
+    private:
+        std::vector<P> partials_;
+    };
+
+    template<class T, class S>
+    class axis_sum_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit axis_sum_accumulator (vector<value_type> &r):
+            r_ (r) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            r_ (k) += x;
+        }
+
+    private:
+        vector<value_type> &r_;
+    };
+
+    // Magnitude ordered extremum per slot, as in vector_min (Compare is
+    // std::greater) and vector_max (Compare is std::less).
+    template<class T, class S, class Compare>
+    class axis_extremum_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+        typedef typename type_traits<value_type>::real_type real_type;
+
+        BOOST_UBLAS_INLINE
+        axis_extremum_accumulator (vector<value_type> &r):
+            r_ (r), count_ (r.size (), size_type (0)) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            if (count_ [k] ++ == 0 || Compare () (type_traits<value_type>::type_abs (r_ (k)), type_traits<value_type>::type_abs (x)))
+                r_ (k) = x;
+        }
+
+        // Slots with implicit zeros compete with a zero value
+        BOOST_UBLAS_INLINE
+        void finish (size_type length) {
+            for (size_type k = 0; k < r_.size (); ++ k)
+                if (count_ [k] < length &&
+                    (count_ [k] == 0 || Compare () (type_traits<value_type>::type_abs (r_ (k)), real_type (0))))
+                    r_ (k) = value_type (0);
+        }
+
+    private:
+        vector<value_type> &r_;
+        std::vector<size_type> count_;
+    };
+
+    // Pushes the slots [first, last) of chunk c of a dense matrix into acc, in
+    // storage order. Chunks own disjoint slots, so they share acc.
+    template<class E, class A>
+    class matrix_axis_block_kernel {
+    public:
+        typedef typename E::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        matrix_axis_block_kernel (const E &e, size_type axis, A &acc):
+            e_ (e), axis_ (axis), acc_ (acc) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type, size_type first, size_type last) const {
+            bool column_major = boost::is_same<typename E::orientation_category, column_major_tag>::value;
+            size_type size1 (e_.size1 ());
+            size_type size2 (e_.size2 ());
+            if (axis_ == 0) {
+                if (column_major)
+                    for (size_type k = first; k < last; ++ k)
+                        for (size_type i = 0; i < size1; ++ i)
+                            acc_.push (k, e_ (i, k));
+                else
+                    for (size_type i = 0; i < size1; ++ i)
+                        for (size_type k = first; k < last; ++ k)
+                            acc_.push (k, e_ (i, k));
+            }
+            else {
+                if (column_major)
+                    for (size_type j = 0; j < size2; ++ j)
+                        for (size_type k = first; k < last; ++ k)
+                            acc_.push (k, e_ (k, j));
+                else
+                    for (size_type k = first; k < last; ++ k)
+                        for (size_type j = 0; j < size2; ++ j)
+                            acc_.push (k, e_ (k, j));
+            }
+        }
+
+    private:
+        const E &e_;
+        size_type axis_;
+        A &acc_;
+    };
+
+    // matrix_axis_sweep, split into chunks of slots for large dense
+    // expressions when BOOST_UBLAS_PARALLEL_REDUCTIONS is defined
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_axis_reduce (const matrix_expression<E> &e, typename E::size_type axis, A &acc, dense_proxy_tag) {
+        typedef typename E::size_type matrix_size_type;
+        matrix_size_type slots (axis == 0 ? e ().size2 () : e ().size1 ());
+        matrix_size_type chunks (detail::reduction_chunks (e ().size1 () * e ().size2 ()));
+        if (chunks > slots)
+            chunks = slots;
+        if (chunks > matrix_size_type (1)) {
+            matrix_axis_block_kernel<E, A> kernel (e (), axis, acc);
+            detail::reduce_chunks (slots, chunks, kernel);
+        }
+        else
+            matrix_axis_sweep (e, axis, acc);
+    }
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_axis_reduce (const matrix_expression<E> &e, typename E::size_type axis, A &acc, unknown_storage_tag) {
+        matrix_axis_sweep (e, axis, acc);
+    }
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_axis_reduce (const matrix_expression<E> &e, typename E::size_type axis, A &acc) {
+        matrix_axis_reduce (e, axis, acc, typename E::storage_category ());
+    }
+
+    // Routes every element of a sweep to slot 0 of acc
+    template<class A>
+    class single_slot_accumulator {
+    public:
+        typedef typename A::value_type value_type;
+        typedef typename A::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit single_slot_accumulator (A &acc):
+            acc_ (acc) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type, const value_type &x) {
+            acc_.push (size_type (0), x);
+        }
+
+    private:
+        A &acc_;
+    };
+
+    // Sweep over the elements of a whole matrix into slot 0 of acc
+    template<class E, class A>
+    BOOST_UBLAS_INLINE
+    void matrix_stored_sweep (const matrix_expression<E> &e, A &acc) {
+        single_slot_accumulator<A> slot (acc);
+        matrix_axis_sweep (e, typename E::size_type (0), slot);
+    }
+
+    // Stored values of a sweep, in the order visited
+    template<class T, class S>
+    class stored_values_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit stored_values_accumulator (std::vector<value_type> &v):
+            v_ (v) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type, const value_type &x) {
+            v_.push_back (x);
+        }
+
+    private:
+        std::vector<value_type> &v_;
+    };
+
+    // Stored values of every slot of a sweep, in the order visited
+    template<class T, class S>
+    class axis_values_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit axis_values_accumulator (size_type size):
+            values_ (size) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            values_ [k].push_back (x);
+        }
+
+        BOOST_UBLAS_INLINE
+        std::vector<value_type> &values (size_type k) {
+            return values_ [k];
+        }
+
+    private:
+        std::vector<std::vector<value_type> > values_;
+    };
+
+    // Scalar functors tagged with stored_elements_tag provide apply_stored (e),
+    // which matrix_scalar_unary uses for sparse expressions. It visits the
+    // stored elements only and accounts for the implicit zeros analytically.
+    struct indexed_elements_tag {};
+    struct stored_elements_tag {};
 
     // Unary returning scalar
     template<class M>
     struct matrix_scalar_unary_functor {
         typedef typename M::value_type value_type;
         typedef typename M::value_type result_type;
+        typedef indexed_elements_tag element_category;
     };
 
     template<class M>
@@ -1505,19 +4498,23 @@ namespace boost { namespace numeric { namespace ublas {
         public matrix_scalar_unary_functor<M> {
         typedef typename matrix_scalar_unary_functor<M>::value_type value_type;
         typedef typename matrix_scalar_unary_functor<M>::result_type result_type;
+        typedef stored_elements_tag element_category;
         
         template<class E>
         static BOOST_UBLAS_INLINE
         result_type apply (const matrix_expression<E> &e) { 
+            return matrix_reduce<extremum_partial<result_type, std::greater<typename type_traits<value_type>::real_type> > > (e).value;
+        }
+        // Stored elements of a sparse expression
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply_stored (const matrix_expression<E> &e) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-            result_type min_val = result_type ( e () (matrix_size_type (0), matrix_size_type (0)));
-            for (matrix_size_type i = 0; i < size1; ++ i)
-                for (matrix_size_type j = 0; j < size2; ++ j)
-                    if ( type_traits<value_type>::type_abs(min_val) > type_traits<value_type>::type_abs(e () (i, j)) )
-                        min_val = e () (i, j);
-            return min_val;
+            vector<result_type> r (1);
+            axis_extremum_accumulator<result_type, matrix_size_type, std::greater<typename type_traits<value_type>::real_type> > acc (r);
+            matrix_stored_sweep (e, acc);
+            acc.finish (e ().size1 () * e ().size2 ());
+            return r (0);
         }
         // Dense case
         template<class D, class I>
@@ -1553,19 +4550,23 @@ namespace boost { namespace numeric { namespace ublas {
         public matrix_scalar_unary_functor<M> {
         typedef typename matrix_scalar_unary_functor<M>::value_type value_type;
         typedef typename matrix_scalar_unary_functor<M>::result_type result_type;
+        typedef stored_elements_tag element_category;
         
         template<class E>
         static BOOST_UBLAS_INLINE
         result_type apply (const matrix_expression<E> &e) { 
+            return matrix_reduce<extremum_partial<result_type, std::less<typename type_traits<value_type>::real_type> > > (e).value;
+        }
+        // Stored elements of a sparse expression
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply_stored (const matrix_expression<E> &e) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-            result_type max_val = result_type ( e () (matrix_size_type (0), matrix_size_type (0)));
-            for (matrix_size_type i = 0; i < size1; ++ i)
-                for (matrix_size_type j = 0; j < size2; ++ j)
-                    if ( type_traits<value_type>::type_abs(max_val) < type_traits<value_type>::type_abs(e () (i, j)) )
-                        max_val = e () (i, j);
-            return max_val;
+            vector<result_type> r (1);
+            axis_extremum_accumulator<result_type, matrix_size_type, std::less<typename type_traits<value_type>::real_type> > acc (r);
+            matrix_stored_sweep (e, acc);
+            acc.finish (e ().size1 () * e ().size2 ());
+            return r (0);
         }
         // Dense case
         template<class D, class I>
@@ -1601,46 +4602,59 @@ namespace boost { namespace numeric { namespace ublas {
         public matrix_scalar_unary_functor<M> {
         typedef typename matrix_scalar_unary_functor<M>::value_type value_type;
         typedef typename matrix_scalar_unary_functor<M>::result_type result_type;
+        typedef stored_elements_tag element_category;
         // typedef double result_type;
 
         template<class E>
         static BOOST_UBLAS_INLINE
         result_type apply (const matrix_expression<E> &e) { 
-            result_type t = result_type (0);
-            typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-            for (matrix_size_type i = 0; i < size1; ++ i) {
-                for (matrix_size_type j = 0; j < size2; ++ j) {
-                    t += e () (i, j);
-                }
-            }
-            return t;
+            typedef typename default_summation::template partial<result_type>::type partial_type;
+            return matrix_reduce<partial_type> (e).result ();
+        }
+        // Stored elements of a sparse expression
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply_stored (const matrix_expression<E> &e) {
+            vector<result_type> r (1, result_type (0));
+            axis_sum_accumulator<result_type, typename E::size_type> acc (r);
+            matrix_stored_sweep (e, acc);
+            return r (0);
         }
         // Dense case
         template<class D, class I>
         static BOOST_UBLAS_INLINE
         result_type apply (D size, I it) { 
-            result_type t = result_type (0);
+            typename default_summation::template partial<result_type>::type t;
             while (-- size >= 0) {
-                t += *it;
+                t.push (*it);
                 ++ it;
             }
-            return t; 
+            return t.result (); 
         }
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end) {
-            result_type t = result_type (0);
-            typedef typename I::difference_type matrix_difference_type;
-            matrix_difference_type size (0);
+            typename default_summation::template partial<result_type>::type t;
             while (it != it_end) {
-                t += *it;
+                t.push (*it);
                 ++ it;
-                ++ size;
             }
-            return t;
+            return t.result ();
+        }
+    };
+
+    // vector_summation over all elements of a matrix
+    template<class M, class P>
+    struct matrix_summation {
+        typedef typename M::value_type value_type;
+        typedef typename P::template partial<value_type>::type partial_type;
+        typedef typename partial_type::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const matrix_expression<E> &e) {
+            return matrix_reduce<partial_type> (e).result ();
         }
     };
 
@@ -1649,21 +4663,24 @@ namespace boost { namespace numeric { namespace ublas {
         public matrix_scalar_unary_functor<M> {
         typedef typename matrix_scalar_unary_functor<M>::value_type value_type;
         typedef typename matrix_scalar_unary_functor<M>::result_type result_type;
+        typedef stored_elements_tag element_category;
         // typedef double result_type;
 
         template<class E>
         static BOOST_UBLAS_INLINE
         result_type apply (const matrix_expression<E> &e) { 
-            result_type t = result_type (0);
-            typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-            for (matrix_size_type i = 0; i < size1; ++ i) {
-                for (matrix_size_type j = 0; j < size2; ++ j) {
-                    t += e () (i, j);
-                }
-            }
-            return t / (size1 * size2);
+            typedef typename default_summation::template partial<result_type>::type partial_type;
+            return matrix_reduce<partial_type> (e).result () / (e ().size1 () * e ().size2 ());
+        }
+        // Stored elements of a sparse expression; the implicit zeros only
+        // add to the count
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply_stored (const matrix_expression<E> &e) {
+            vector<result_type> r (1, result_type (0));
+            axis_sum_accumulator<result_type, typename E::size_type> acc (r);
+            matrix_stored_sweep (e, acc);
+            return r (0) / (e ().size1 () * e ().size2 ());
         }
         // Dense case
         template<class D, class I>
@@ -1697,24 +4714,29 @@ namespace boost { namespace numeric { namespace ublas {
         public matrix_scalar_unary_functor<M> {
         typedef typename matrix_scalar_unary_functor<M>::value_type value_type;
         typedef typename matrix_scalar_unary_functor<M>::result_type result_type;
+        typedef stored_elements_tag element_category;
         // typedef double result_type;
 
         template<class E>
-        static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e) { 
-            typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-            matrix_size_type num_elements = size1 * size2;
-            result_type sumsq = result_type (0);
-            result_type sum = result_type (0);
-            for (matrix_size_type i = 0; i < size1; ++ i) {
-                for (matrix_size_type j = 0; j < size2; ++ j) {
-                    sumsq += e () (i, j) * e () (i, j);
-                    sum += e () (i, j);
-                }
-            }
-            return (sumsq - (sum * sum) / num_elements) / (num_elements);
+        static BOOST_UBLAS_INLINE
+        result_type apply (const matrix_expression<E> &e) { 
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type num_elements = e ().size1 () * e ().size2 ();
+            power_sums_partial<result_type> p (matrix_reduce<power_sums_partial<result_type> > (e));
+            return (p.sumsq - (p.sum * p.sum) / num_elements) / (num_elements);
+        }
+        // Stored elements of a sparse expression, merged with the block of
+        // implicit zeros
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply_stored (const matrix_expression<E> &e) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type num_elements (e ().size1 () * e ().size2 ());
+            axis_moments_accumulator<result_type, matrix_size_type> acc (1);
+            matrix_stored_sweep (e, acc);
+            result_type mean, m2;
+            acc.finish (0, num_elements, mean, m2);
+            return m2 / num_elements;
         }
         // Dense case
         template<class D, class I>
@@ -1753,106 +4775,55 @@ namespace boost { namespace numeric { namespace ublas {
         public matrix_scalar_unary_functor<V> {
         typedef typename matrix_scalar_unary_functor<V>::value_type value_type;
         typedef typename matrix_scalar_unary_functor<V>::result_type result_type;
+        typedef stored_elements_tag element_category;
         
         template<class E>
         static BOOST_UBLAS_INLINE
         result_type apply (const matrix_expression<E> &e) {
             typedef typename E::size_type matrix_size_type;
-            boost::unordered_map<result_type, matrix_size_type> count_map;
+            mode_engine<result_type, matrix_size_type> engine;
             matrix_size_type size1 (e ().size1 ());
             matrix_size_type size2 (e ().size2 ());
-            typename boost::unordered_map<result_type, matrix_size_type>::iterator p;
-            // auto p = count_map.iterator;
+            engine.values ().reserve (size1 * size2);
             for (matrix_size_type i = 0; i < size1; ++ i)
-                for (matrix_size_type j = 0; j < size2; ++ j) {
-                    p = count_map.find (e () (i, j));
-                    if (p != count_map.end ())
-                        p->second += matrix_size_type(1);
-                    else
-                        count_map.emplace (e () (i, j), matrix_size_type (1));
-                }
-            
-            result_type mode = result_type (0);
-            matrix_size_type mode_val = matrix_size_type(0);
-            p = count_map.begin();
-            while (p != count_map.end()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs(p->first) < type_traits<value_type>::type_abs(mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+                for (matrix_size_type j = 0; j < size2; ++ j)
+                    engine.values ().push_back (e () (i, j));
+            return engine.mode ();
+        }
+        // Stored elements of a sparse expression; the implicit zeros count
+        // towards zero
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply_stored (const matrix_expression<E> &e) {
+            typedef typename E::size_type matrix_size_type;
+            mode_engine<result_type, matrix_size_type> engine;
+            stored_values_accumulator<result_type, matrix_size_type> acc (engine.values ());
+            matrix_stored_sweep (e, acc);
+            matrix_size_type stored (engine.values ().size ());
+            return engine.mode (e ().size1 () * e ().size2 () - stored);
         }
         // Dense case
         template<class D, class I>
         static BOOST_UBLAS_INLINE
         result_type apply (D size, I it) { 
-            boost::unordered_map<result_type, D> count_map;
-            
-            typename boost::unordered_map<result_type, D>::iterator p;
-            // auto p = count_map.iterator;
+            mode_engine<result_type, std::size_t> engine;
+            engine.values ().reserve (size);
             while (-- size >= 0) {
-                p = count_map.find (*it);
-                if ( p != count_map.end ())
-                    p->second += D(1);
-                else
-                    count_map.emplace (*it, D (1));
+                engine.values ().push_back (*it);
                 ++ it;
             }
-            
-            result_type mode = result_type (0);
-            D mode_val = D(0);
-            p = count_map.begin();
-            while (p != count_map.end()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs(p->first) < type_traits<value_type>::type_abs(mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+            return engine.mode ();
         }
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end) {
-            typedef typename I::difference_type matrix_difference_type;
-
-            boost::unordered_map<result_type, matrix_difference_type> count_map;
-            
-            typename boost::unordered_map<result_type, matrix_difference_type>::iterator p;
-            // auto p = count_map.iterator;
-
+            mode_engine<result_type, std::size_t> engine;
             while (it != it_end) {
-                p = count_map.find (*it);
-                if ( p != count_map.end ())
-                    p->second += matrix_difference_type(1);
-                else
-                    count_map.emplace (*it, matrix_difference_type (1));
+                engine.values ().push_back (*it);
                 ++ it;
             }
-            
-            result_type mode = result_type (0);
-            matrix_difference_type mode_val = matrix_difference_type(0);
-            p = count_map.begin();
-            while (p != count_map.end()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs(p->first) < type_traits<value_type>::type_abs(mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+            return engine.mode ();
         }
     };
 
@@ -1861,6 +4832,7 @@ namespace boost { namespace numeric { namespace ublas {
         public matrix_scalar_unary_functor<V> {
         typedef typename vector_scalar_unary_functor<V>::value_type value_type;
         typedef typename vector_scalar_unary_functor<V>::result_type result_type;
+        typedef stored_elements_tag element_category;
         
         template<class E>
         static BOOST_UBLAS_INLINE
@@ -1874,11 +4846,17 @@ namespace boost { namespace numeric { namespace ublas {
             for (matrix_size_type i = 0; i < size1; ++ i)
                 for (matrix_size_type j = 0; j < size2; ++ j)
                     v (k ++) = e () (i, j);
-            boost::sort (v, compareElement);
-            if (num_elements % 2)
-                return v (num_elements / 2);
-            else
-                return (v (num_elements / 2) + v ((num_elements / 2) - 1)) / 2;
+            return select_median (v.begin (), v.end (), compareElement);
+        }
+
+        // Stored elements of a sparse expression; the implicit zeros are a
+        // run at the front of the magnitude order
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply_stored (const matrix_expression<E> &e) {
+            std::vector<value_type> v;
+            typename std::vector<value_type>::difference_type zeros = gather_stored (e, v);
+            return select_quantile (v.begin (), v.end (), zeros, 0.5, quantile_linear, compareElement);
         }
 
         // Dense case
@@ -1893,11 +4871,7 @@ namespace boost { namespace numeric { namespace ublas {
                 ++ it;
                 ++  i;
             }
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
+            return select_median (v.begin (), v.end (), compareElement);
         }
 
         // Sparse case
@@ -1919,21 +4893,134 @@ namespace boost { namespace numeric { namespace ublas {
                 ++ i;
             }
             
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
+            return select_median (v.begin (), v.end (), compareElement);
         }
 
         static BOOST_UBLAS_INLINE
         bool compareElement (const value_type &A, const value_type &B) {
-            return (type_traits<value_type>::type_abs (A) < type_traits<value_type>::type_abs (B));
+            return magnitude_less (A, B);
+        }
+
+    protected:
+        // Copy the stored elements of e into v and return the number of
+        // implicit zeros
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        typename std::vector<value_type>::difference_type
+        gather_stored (const matrix_expression<E> &e, std::vector<value_type> &v) {
+            typedef typename std::vector<value_type>::difference_type difference_type;
+            stored_values_accumulator<value_type, typename E::size_type> acc (v);
+            matrix_stored_sweep (e, acc);
+            return difference_type (e ().size1 () * e ().size2 ()) - difference_type (v.size ());
+        }
+    };
+
+    template<class M>
+    struct matrix_quantile:
+        public matrix_median<M> {
+        typedef typename matrix_median<M>::value_type value_type;
+        typedef typename matrix_median<M>::result_type result_type;
+        typedef typename std::vector<value_type>::difference_type difference_type;
+        using matrix_median<M>::compareElement;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const matrix_expression<E> &e, double q, quantile_interpolation method) {
+            std::vector<value_type> v;
+            difference_type zeros = copy (e, v, typename E::storage_category ());
+            return select_quantile (v.begin (), v.end (), zeros, q, method, compareElement);
+        }
+
+        template<class E, class Q>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, const vector_expression<Q> &q, quantile_interpolation method, vector<result_type> &r) {
+            std::vector<value_type> v;
+            difference_type zeros = copy (e, v, typename E::storage_category ());
+            r.resize (q ().size (), false);
+            select_quantiles (v.begin (), v.end (), zeros, q ().begin (), q ().end (), r.begin (), method, compareElement);
+        }
+
+    private:
+        using matrix_median<M>::gather_stored;
+
+        // Copy the elements of e into v and return the number of implicit
+        // zeros left out, which only sparse expressions have
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        difference_type copy (const matrix_expression<E> &e, std::vector<value_type> &v, packed_proxy_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            v.reserve (size1 * size2);
+            for (matrix_size_type i = 0; i < size1; ++ i)
+                for (matrix_size_type j = 0; j < size2; ++ j)
+                    v.push_back (e () (i, j));
+            return difference_type (0);
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        difference_type copy (const matrix_expression<E> &e, std::vector<value_type> &v, sparse_proxy_tag) {
+            return gather_stored (e, v);
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        difference_type copy (const matrix_expression<E> &e, std::vector<value_type> &v, unknown_storage_tag) {
+            return copy (e, v, packed_proxy_tag ());
+        }
+    };
+
+    template<class M>
+    struct matrix_describe {
+        typedef typename M::value_type value_type;
+        typedef typename M::size_type size_type;
+        typedef stats_summary<value_type, size_type> result_type;
+        typedef describe_accumulator<value_type, size_type> accumulator_type;
+        typedef indexed_elements_tag element_category;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const matrix_expression<E> &e) {
+            accumulator_type acc (e ().size1 () * e ().size2 ());
+            accumulate (e, acc, typename E::orientation_category ());
+            return acc.result ();
+        }
+
+    private:
+        // Visit the elements in storage order
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void accumulate (const matrix_expression<E> &e, accumulator_type &acc, row_major_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            for (matrix_size_type i = 0; i < size1; ++ i)
+                for (matrix_size_type j = 0; j < size2; ++ j)
+                    acc.push (e () (i, j));
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void accumulate (const matrix_expression<E> &e, accumulator_type &acc, column_major_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            for (matrix_size_type j = 0; j < size2; ++ j)
+                for (matrix_size_type i = 0; i < size1; ++ i)
+                    acc.push (e () (i, j));
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void accumulate (const matrix_expression<E> &e, accumulator_type &acc, unknown_orientation_tag) {
+            accumulate (e, acc, row_major_tag ());
         }
     };
 
     // Unary returning vector of value_type TV
 
+    // Axis functors compute the whole result vector in one sweep instead of
+    // one slice per index. The axis free functions evaluate them straight
+    // into a vector, so the result does not depend on the matrix after the
+    // call.
+
     template<class M, class TV>
     struct matrix_vector_unary_functor {
         typedef typename M::value_type value_type;
@@ -1946,49 +5033,16 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
         typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
-        // template<class E>
-        // static BOOST_UBLAS_INLINE
-        // result_type apply (const matrix_expression<E> &e, typename E::size_type axis) { 
-        //     typedef typename E::size_type matrix_size_type;
-        //     matrix_size_type size1 (e ().size1 ());
-        //     matrix_size_type size2 (e ().size2 ());
-
-        //     matrix_size_type result_vector_size = matrix_size_type(0);
-        //     if (axis == 0)
-        //         result_vector_size = size2;
-        //     else if (axis == 1)
-        //         result_vector_size = size1;
-
-        //     result_type t = result_type (result_vector_size);
-        //     for (matrix_size_type i = 0; i < result_vector_size; ++ i) {
-        //         t (i) = apply (e, axis, i);
-        //     }
-        //     return t;
-        // }
-
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index) { 
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-
-            result_type vmin = result_type(0);
-            
-            if (axis == 0){
-                vmin = result_type(e () (0, index));
-                for (matrix_size_type i = 0; i < size1; ++ i)
-                    if ( type_traits<value_type>::type_abs(vmin) > type_traits<value_type>::type_abs(e () (i, index)) )
-                        vmin = e () (i, index);
-                return vmin;
-            }
-            else if (axis == 1){
-                vmin = result_type(e () (index, 0));
-                for (matrix_size_type i = 0; i < size2; ++ i)
-                    if ( type_traits<value_type>::type_abs(vmin) > type_traits<value_type>::type_abs(e () (index, i)) )
-                        vmin = e () (index, i);
-                return vmin;
-            }
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            r.resize (size, false);
+            axis_extremum_accumulator<result_type, matrix_size_type, std::greater<typename type_traits<value_type>::real_type> > acc (r);
+            matrix_axis_reduce (e, axis, acc);
+            acc.finish (length);
         }
 
         // Dense case
@@ -2065,49 +5119,16 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
         typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
-        // template<class E>
-        // static BOOST_UBLAS_INLINE
-        // result_type apply (const matrix_expression<E> &e, typename E::size_type axis) { 
-        //     typedef typename E::size_type matrix_size_type;
-        //     matrix_size_type size1 (e ().size1 ());
-        //     matrix_size_type size2 (e ().size2 ());
-
-        //     matrix_size_type result_vector_size = matrix_size_type(0);
-        //     if (axis == 0)
-        //         result_vector_size = size2;
-        //     else if (axis == 1)
-        //         result_vector_size = size1;
-
-        //     result_type t = result_type (result_vector_size);
-        //     for (matrix_size_type i = 0; i < result_vector_size; ++ i) {
-        //         t (i) = apply (e, axis, i);
-        //     }
-        //     return t;
-        // }
-
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index) { 
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-
-            result_type vmax = result_type(0);
-            
-            if (axis == 0){
-                vmax = result_type(e () (0, index));
-                for (matrix_size_type i = 0; i < size1; ++ i)
-                    if ( type_traits<value_type>::type_abs(vmax) < type_traits<value_type>::type_abs(e () (i, index)) )
-                        vmax = e () (i, index);
-                return vmax;
-            }
-            else if (axis == 1){
-                vmax = result_type(e () (index, 0));
-                for (matrix_size_type i = 0; i < size2; ++ i)
-                    if ( type_traits<value_type>::type_abs(vmax) < type_traits<value_type>::type_abs(e () (index, i)) )
-                        vmax = e () (index, i);
-                return vmax;
-            }
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            r.resize (size, false);
+            axis_extremum_accumulator<result_type, matrix_size_type, std::less<typename type_traits<value_type>::real_type> > acc (r);
+            matrix_axis_reduce (e, axis, acc);
+            acc.finish (length);
         }
 
         // Dense case
@@ -2184,48 +5205,15 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
         typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
-        // template<class E>
-        // static BOOST_UBLAS_INLINE
-        // result_type apply (const matrix_expression<E> &e, typename E::size_type axis) {
-        //     typedef typename E::size_type matrix_size_type;
-        //     matrix_size_type size1 (e ().size1 ());
-        //     matrix_size_type size2 (e ().size2 ());
-
-        //     matrix_size_type result_vector_size = matrix_size_type(0);
-        //     if (axis == 0)
-        //         result_vector_size = size2;
-        //     else if (axis == 1)
-        //         result_vector_size = size1;
-
-        //     result_type t = result_type (result_vector_size);
-        //     for (matrix_size_type i = 0; i < result_vector_size; ++ i) {
-        //         t (i) = apply (e, axis, i);
-        //     }
-        //     return t;
-        // }
-
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index) { 
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-
-            result_type vsum = result_type(0);
-            
-            if (axis == 0){
-                for (matrix_size_type i = 0; i < size1; ++ i) {
-                    vsum += e () (i, index);
-                }
-                return vsum;
-            }
-            else if (axis == 1){
-                for (matrix_size_type i = 0; i < size2; ++ i) {
-                    vsum += e () (index, i);
-                }
-                return vsum;
-            }
-
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            r.resize (size, false);
+            r.clear ();
+            axis_sum_accumulator<result_type, matrix_size_type> acc (r);
+            matrix_axis_reduce (e, axis, acc);
         }
 
         // Dense case
@@ -2300,48 +5288,18 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
         typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
-        // template<class E>
-        // static BOOST_UBLAS_INLINE
-        // result_type apply (const matrix_expression<E> &e, typename E::size_type axis) {
-        //     typedef typename E::size_type matrix_size_type;
-        //     matrix_size_type size1 (e ().size1 ());
-        //     matrix_size_type size2 (e ().size2 ());
-
-        //     matrix_size_type result_vector_size = matrix_size_type(0);
-        //     if (axis == 0)
-        //         result_vector_size = size2;
-        //     else if (axis == 1)
-        //         result_vector_size = size1;
-
-        //     result_type t = result_type (result_vector_size);
-        //     for (matrix_size_type i = 0; i < result_vector_size; ++ i) {
-        //         t (i) = apply (e, axis, i);
-        //     }
-        //     return t;
-        // }
-
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index) { 
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-
-            result_type vsum = result_type(0);
-            
-            if (axis == 0){
-                for (matrix_size_type i = 0; i < size1; ++ i) {
-                    vsum += e () (i, index);
-                }
-                return vsum / size1;
-            }
-            else if (axis == 1){
-                for (matrix_size_type i = 0; i < size2; ++ i) {
-                    vsum += e () (index, i);
-                }
-                return vsum / size2;
-            }
-
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            r.resize (size, false);
+            r.clear ();
+            axis_sum_accumulator<result_type, matrix_size_type> acc (r);
+            matrix_axis_reduce (e, axis, acc);
+            for (matrix_size_type k = 0; k < size; ++ k)
+                r (k) /= length;
         }
 
         // Dense case
@@ -2421,51 +5379,20 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
         typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
-        // template<class E>
-        // static BOOST_UBLAS_INLINE
-        // result_type apply (const matrix_expression<E> &e, typename E::size_type axis) {
-        //     typedef typename E::size_type matrix_size_type;
-        //     matrix_size_type size1 (e ().size1 ());
-        //     matrix_size_type size2 (e ().size2 ());
-
-        //     matrix_size_type result_vector_size = matrix_size_type(0);
-        //     if (axis == 0)
-        //         result_vector_size = size2;
-        //     else if (axis == 1)
-        //         result_vector_size = size1;
-
-        //     result_type t = result_type (result_vector_size);
-        //     for (matrix_size_type i = 0; i < result_vector_size; ++ i) {
-        //         t (i) = apply (e, axis, i);
-        //     }
-        //     return t;
-        // }
-
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index) { 
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-
-            result_type sumsq = result_type (0);
-            result_type sum = result_type (0);
-
-            if (axis == 0){
-                for (matrix_size_type i = 0; i < size1; ++ i) {
-                    sumsq += e () (i, index) * e () (i, index);
-                    sum += e () (i, index);
-                }
-                return (sumsq - (sum * sum) / size1) / size1;
-            }
-            else if (axis == 1){
-                for (matrix_size_type i = 0; i < size2; ++ i) {
-                    sumsq += e () (index, i) * e () (index, i);
-                    sum += e () (index, i);
-                }
-                return (sumsq - (sum * sum) / size2) / size2;
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            r.resize (size, false);
+            axis_moments_accumulator<result_type, matrix_size_type> acc (size);
+            matrix_axis_reduce (e, axis, acc);
+            result_type mean, m2;
+            for (matrix_size_type k = 0; k < size; ++ k) {
+                acc.finish (k, length, mean, m2);
+                r (k) = m2 / length;
             }
-
         }
 
         // Dense case
@@ -2545,176 +5472,241 @@ namespace boost { namespace numeric { namespace ublas {
         }
     };
 
-    template<class M, class TV>
-    struct matrix_mode_axis: 
+    // vector_higher_moment over all elements of a matrix
+    template<class M, class Tag>
+    struct matrix_higher_moment {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const matrix_expression<E> &e) {
+            typedef typename E::size_type matrix_size_type;
+            return moment_statistic (matrix_reduce<higher_moments_partial<result_type, matrix_size_type> > (e), Tag ());
+        }
+    };
+
+    template<class M>
+    struct matrix_moment {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const matrix_expression<E> &e, typename E::size_type k) {
+            typedef typename E::size_type matrix_size_type;
+            if (k <= matrix_size_type (4))
+                return central_moment (matrix_reduce<higher_moments_partial<result_type, matrix_size_type> > (e), k);
+            return central_moment (matrix_reduce (e, central_moments_partial<result_type, matrix_size_type> (k)), k);
+        }
+    };
+
+    // vector_higher_moment of every column (axis 0) or row (axis 1) in one
+    // sweep
+    template<class M, class TV, class Tag>
+    struct matrix_higher_moment_axis:
         public matrix_vector_unary_functor<M, TV> {
         typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
         typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
-        // template<class E>
-        // static BOOST_UBLAS_INLINE
-        // result_type apply (const matrix_expression<E> &e, typename E::size_type axis) {
-        //     typedef typename E::size_type matrix_size_type;
-        //     matrix_size_type size1 (e ().size1 ());
-        //     matrix_size_type size2 (e ().size2 ());
-
-        //     matrix_size_type result_vector_size = matrix_size_type(0);
-        //     if (axis == 0)
-        //         result_vector_size = size2;
-        //     else if (axis == 1)
-        //         result_vector_size = size1;
-
-        //     result_type t = result_type (result_vector_size);
-        //     for (matrix_size_type i = 0; i < result_vector_size; ++ i) {
-        //         t (i) = apply (e, axis, i);
-        //     }
-        //     return t;
-        // }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            r.resize (size, false);
+            axis_partial_accumulator<higher_moments_partial<result_type, matrix_size_type>, matrix_size_type> acc (size);
+            matrix_axis_reduce (e, axis, acc);
+            for (matrix_size_type k = 0; k < size; ++ k)
+                r (k) = moment_statistic (acc.finish (k, length), Tag ());
+        }
+    };
+
+    template<class M>
+    struct matrix_moment_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type k, typename E::size_type axis, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            if (k <= matrix_size_type (4))
+                apply (e, k, axis, higher_moments_partial<result_type, matrix_size_type> (), r);
+            else
+                apply (e, k, axis, central_moments_partial<result_type, matrix_size_type> (k), r);
+        }
+
+    private:
+        template<class E, class P>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type k, typename E::size_type axis, const P &init, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            r.resize (size, false);
+            axis_partial_accumulator<P, matrix_size_type> acc (size, init);
+            matrix_axis_reduce (e, axis, acc);
+            for (matrix_size_type i = 0; i < size; ++ i)
+                r (i) = central_moment (acc.finish (i, length), k);
+        }
+    };
+
+    // vector_ewm of every column (axis 0) or row (axis 1) of a matrix of
+    // series. The matrix is read in storage order with one state per series.
+    template<class M, class Tag>
+    struct matrix_ewm_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, const value_type &alpha, typename E::size_type axis, matrix<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            BOOST_UBLAS_CHECK (alpha > value_type (0) && alpha <= value_type (1), bad_argument ());
+            BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            r.resize (size1, size2, false);
+            std::vector<ewm_moments<result_type> > m (axis == 0 ? size2 : size1, ewm_moments<result_type> (alpha));
+            if (boost::is_same<typename E::orientation_category, column_major_tag>::value) {
+                for (matrix_size_type j = 0; j < size2; ++ j)
+                    for (matrix_size_type i = 0; i < size1; ++ i)
+                        push (e () (i, j), m [axis == 0 ? j : i], r (i, j));
+            }
+            else {
+                for (matrix_size_type i = 0; i < size1; ++ i)
+                    for (matrix_size_type j = 0; j < size2; ++ j)
+                        push (e () (i, j), m [axis == 0 ? j : i], r (i, j));
+            }
+        }
+
+    private:
+        static BOOST_UBLAS_INLINE
+        void push (const value_type &x, ewm_moments<result_type> &m, result_type &t) {
+            m.push (x);
+            t = m.value (Tag ());
+        }
+    };
+
+    // Pushes the columns [first, last) of every row i of a matrix into the
+    // partials of the group of row i. Chunks own disjoint columns, so they
+    // share the partials.
+    template<class E, class K, class P>
+    class matrix_group_reduce_kernel {
+    public:
+        typedef typename E::size_type size_type;
+
+        BOOST_UBLAS_INLINE
+        matrix_group_reduce_kernel (const E &e, const group_index<K> &index, std::vector<P> &partials):
+            e_ (e), index_ (index), partials_ (partials) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type, size_type first, size_type last) const {
+            size_type size1 (e_.size1 ());
+            size_type size2 (e_.size2 ());
+            if (boost::is_same<typename E::orientation_category, column_major_tag>::value)
+                for (size_type j = first; j < last; ++ j)
+                    for (size_type i = 0; i < size1; ++ i)
+                        partials_ [index_.group (i) * size2 + j].push (e_ (i, j));
+            else
+                for (size_type i = 0; i < size1; ++ i) {
+                    P *p (&partials_ [index_.group (i) * size2]);
+                    for (size_type j = first; j < last; ++ j)
+                        p [j].push (e_ (i, j));
+                }
+        }
+
+    private:
+        const E &e_;
+        const group_index<K> &index_;
+        std::vector<P> &partials_;
+    };
+
+    // vector_group_reduce of every column of a matrix whose rows are keyed:
+    // r (k, j) is the statistic of column j over the rows of group k. The
+    // matrix is read once in storage order, in parallel chunks of columns.
+    template<class M, class Tag>
+    struct matrix_group_reduce {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E, class K>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, const group_index<K> &index, matrix<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            typedef group_operation<result_type, matrix_size_type, Tag> operation;
+            typedef typename operation::partial_type partial_type;
+            matrix_size_type size1 (BOOST_UBLAS_SAME (e ().size1 (), matrix_size_type (index.size ())));
+            matrix_size_type size2 (e ().size2 ());
+            matrix_size_type groups (index.groups ());
+            std::vector<partial_type> partials (groups * size2);
+            matrix_size_type chunks (detail::expression_chunks<E> (size1 * size2));
+            if (chunks > size2)
+                chunks = (std::max) (size2, matrix_size_type (1));
+            matrix_group_reduce_kernel<E, K, partial_type> kernel (e (), index, partials);
+            detail::reduce_chunks (size2, chunks, kernel);
+            r.resize (groups, size2, false);
+            for (matrix_size_type k = 0; k < groups; ++ k)
+                for (matrix_size_type j = 0; j < size2; ++ j)
+                    r (k, j) = operation::value (partials [k * size2 + j]);
+        }
+    };
+
+    template<class M, class TV>
+    struct matrix_mode_axis: 
+        public matrix_vector_unary_functor<M, TV> {
+        typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
+        typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
+        // One engine counts every slot, reusing its scratch
+        // storage
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index) {
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-
-            boost::unordered_map<result_type, matrix_size_type> count_map;
-            typename boost::unordered_map<result_type, matrix_size_type>::iterator p;
-            
-            if (axis == 0){
-                for (matrix_size_type i = 0; i < size1; ++ i) {
-                    p = count_map.find (e () (i, index));
-                    if (p != count_map.end ())
-                        p->second += matrix_size_type (1);
-                    else
-                        count_map.emplace (e () (i, index), matrix_size_type (1));
-                }
-
-            }
-            else if (axis == 1){
-                for (matrix_size_type i = 0; i < size2; ++ i) {
-                    p = count_map.find (e () (index, i));
-                    if (p != count_map.end ())
-                        p->second += matrix_size_type (1);
-                    else
-                        count_map.emplace (e () (index, i), matrix_size_type (1));
-                }
-            }
-
-            result_type mode = result_type (0);
-            matrix_size_type mode_val = matrix_size_type (0);
-            p = count_map.begin();
-            while (p != count_map.end ()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            r.resize (size, false);
+            mode_engine<result_type, matrix_size_type> engine;
+            apply (e, axis, r, engine, typename E::storage_category ());
         }
 
         // Dense case
         template<class D, class I>
         static BOOST_UBLAS_INLINE
         result_type apply (D size, I it) {
-            boost::unordered_map<result_type, D> count_map;
-            typename boost::unordered_map<result_type, D>::iterator p;
-            
+            mode_engine<result_type, std::size_t> engine;
+            engine.values ().reserve (size);
             while (-- size >= 0) {
-                p = count_map.find (*it);
-                if (p != count_map.end ())
-                    p->second += D (1);
-                else
-                    count_map.emplace (*it, D (1));
+                engine.values ().push_back (*it);
                 ++ it;
             }
-
-            result_type mode = result_type (0);
-            D mode_val = D (0);
-            p = count_map.begin();
-            while (p != count_map.end ()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (mode))
-                    mode = p->first;
-                ++ p;
-            }
-            
-            return mode;
+            return engine.mode ();
         }
 
         // Packed case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end) {
-            typedef typename I::difference_type matrix_difference_type;
-            
-            boost::unordered_map<result_type, matrix_difference_type> count_map;
-            typename boost::unordered_map<result_type, matrix_difference_type>::iterator p;
-            
+            mode_engine<result_type, std::size_t> engine;
             while (it != it_end){
-                p = count_map.find (*it);
-                if (p != count_map.end ())
-                    p->second += matrix_difference_type (1);
-                else
-                    count_map.emplace (*it, matrix_difference_type (1));
+                engine.values ().push_back (*it);
                 ++ it;
             }
-
-            result_type mode = result_type (0);
-            matrix_difference_type mode_val = matrix_difference_type (0);
-            p = count_map.begin();
-            while (p != count_map.end ()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (mode))
-                    mode = p->first;
-                ++ p;
-            }
-
-            return mode;
+            return engine.mode ();
         }
 
         // Sparse case
         template<class I>
         static BOOST_UBLAS_INLINE
         result_type apply (I it, const I &it_end, sparse_bidirectional_iterator_tag) {
-            typedef typename I::difference_type matrix_difference_type;
-            
-            boost::unordered_map<result_type, matrix_difference_type> count_map;
-            typename boost::unordered_map<result_type, matrix_difference_type>::iterator p;
-            
+            mode_engine<result_type, std::size_t> engine;
             while (it != it_end){
-                p = count_map.find (*it);
-                if (p != count_map.end ())
-                    p->second += matrix_difference_type (1);
-                else
-                    count_map.emplace (*it, matrix_difference_type (1));
+                engine.values ().push_back (*it);
                 ++ it;
             }
-
-            result_type mode = result_type (0);
-            matrix_difference_type mode_val = matrix_difference_type (0);
-            p = count_map.begin();
-            while (p != count_map.end ()) {
-                if (p->second > mode_val) {
-                    mode = p->first;
-                    mode_val = p->second;
-                }
-                else if (p->second == mode_val && type_traits<value_type>::type_abs (p->first) < type_traits<value_type>::type_abs (mode))
-                    mode = p->first;
-                ++ p;
-            }
-
-            return mode;
+            return engine.mode ();
         //     result_type t = result_type (0);
         //     if (it1 != it1_end && it2 != it2_end) {
         //         size_type it1_index = it1.index2 (), it2_index = it2.index ();
@@ -2744,61 +5736,70 @@ namespace boost { namespace numeric { namespace ublas {
         //     }
         //     return t;
         }
+
+    private:
+        // Dense slices are read in place
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r,
+                    mode_engine<result_type, typename E::size_type> &engine, dense_proxy_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            for (matrix_size_type k = 0; k < r.size (); ++ k) {
+                for (matrix_size_type l = 0; l < length; ++ l)
+                    engine.values ().push_back (axis == 0 ? e () (l, k) : e () (k, l));
+                r (k) = engine.mode ();
+            }
+        }
+        // The stored values of all slots are gathered in one sweep and the
+        // implicit zeros are added per slot
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r,
+                    mode_engine<result_type, typename E::size_type> &engine, unknown_storage_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            axis_values_accumulator<result_type, matrix_size_type> acc (r.size ());
+            matrix_axis_sweep (e, axis, acc);
+            for (matrix_size_type k = 0; k < r.size (); ++ k) {
+                engine.values ().swap (acc.values (k));
+                r (k) = engine.mode (length - engine.values ().size ());
+            }
+        }
     };
 
+    // Copy column (axis 0) or row (axis 1) index of e into v, which keeps its
+    // capacity, so one buffer serves every slice of an axis sweep
+    template<class E, class T>
+    BOOST_UBLAS_INLINE
+    void matrix_slice_copy (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index, std::vector<T> &v) {
+        typedef typename E::size_type matrix_size_type;
+        v.clear ();
+        if (axis == 0)
+            for (matrix_size_type i = 0; i < e ().size1 (); ++ i)
+                v.push_back (e () (i, index));
+        else
+            for (matrix_size_type j = 0; j < e ().size2 (); ++ j)
+                v.push_back (e () (index, j));
+    }
+
     template<class M, class TV>
     struct matrix_median_axis: 
         public matrix_vector_unary_functor<M, TV> {
         typedef typename matrix_vector_unary_functor<M, TV>::value_type value_type;
         typedef typename matrix_vector_unary_functor<M, TV>::result_type result_type;
 
-        // template<class E>
-        // static BOOST_UBLAS_INLINE
-        // result_type apply (const matrix_expression<E> &e, typename E::size_type axis) {
-        //     typedef typename E::size_type matrix_size_type;
-        //     matrix_size_type size1 (e ().size1 ());
-        //     matrix_size_type size2 (e ().size2 ());
-
-        //     matrix_size_type result_vector_size = matrix_size_type(0);
-        //     if (axis == 0)
-        //         result_vector_size = size2;
-        //     else if (axis == 1)
-        //         result_vector_size = size1;
-
-        //     result_type t = result_type (result_vector_size);
-        //     for (matrix_size_type i = 0; i < result_vector_size; ++ i) {
-        //         t (i) = apply (e, axis, i);
-        //     }
-        //     return t;
-        // }
-
+        // Every slice is selected in one shared buffer
         template<class E>
         static BOOST_UBLAS_INLINE
-        result_type apply (const matrix_expression<E> &e, typename E::size_type axis, typename E::size_type index) {
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
             typedef typename E::size_type matrix_size_type;
-            matrix_size_type size1 (e ().size1 ());
-            matrix_size_type size2 (e ().size2 ());
-
-            if (axis == 0){
-                vector<value_type> v (size1);
-                for (matrix_size_type i = 0; i < size1; ++ i)
-                    v (i) = e () (i, index);
-                boost::sort (v, compareElement);
-                if (size1 % 2)
-                    return v (size1 / 2);
-                else
-                    return (v (size1 / 2) + v ((size1 / 2) - 1)) / 2;
-
-            }
-            else if (axis == 1){
-                vector<value_type> v (size2);
-                for (matrix_size_type i = 0; i < size2; ++ i)
-                    v (i) = e () (index, i);
-                boost::sort (v, compareElement);
-                if (size2 % 2)
-                    return v (size2 / 2);
-                else
-                    return (v (size2 / 2) + v ((size2 / 2) - 1)) / 2;
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            std::vector<value_type> v;
+            r.resize (size, false);
+            for (matrix_size_type k = 0; k < size; ++ k) {
+                matrix_slice_copy (e, axis, k, v);
+                r (k) = select_median (v.begin (), v.end (), compareElement);
             }
         }
 
@@ -2814,11 +5815,7 @@ namespace boost { namespace numeric { namespace ublas {
                 ++ it;
                 ++  i;
             }
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
+            return select_median (v.begin (), v.end (), compareElement);
         }
 
         // Packed case
@@ -2840,11 +5837,7 @@ namespace boost { namespace numeric { namespace ublas {
                 ++ i;
             }
             
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
+            return select_median (v.begin (), v.end (), compareElement);
         }
 
         // Sparse case
@@ -2866,11 +5859,7 @@ namespace boost { namespace numeric { namespace ublas {
                 ++ i;
             }
             
-            boost::sort (v, compareElement);
-            if (size % 2)
-                return v (size / 2);
-            else
-                return (v (size / 2) + v ((size / 2) - 1)) / 2;
+            return select_median (v.begin (), v.end (), compareElement);
         //     result_type t = result_type (0);
         //     if (it1 != it1_end && it2 != it2_end) {
         //         size_type it1_index = it1.index2 (), it2_index = it2.index ();
@@ -2903,7 +5892,522 @@ namespace boost { namespace numeric { namespace ublas {
 
         static BOOST_UBLAS_INLINE
         bool compareElement (const value_type &A, const value_type &B) {
-            return (type_traits<value_type>::type_abs (A) < type_traits<value_type>::type_abs (B));
+            return magnitude_less (A, B);
+        }
+    };
+
+    // Per slice quantiles; all slices share one scratch buffer.
+    template<class M, class TV>
+    struct matrix_quantile_axis:
+        public matrix_median_axis<M, TV> {
+        typedef typename matrix_median_axis<M, TV>::value_type value_type;
+        typedef typename matrix_median_axis<M, TV>::result_type result_type;
+        using matrix_median_axis<M, TV>::compareElement;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, double q, typename E::size_type axis, quantile_interpolation method, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            std::vector<value_type> v;
+            r.resize (size, false);
+            for (matrix_size_type k = 0; k < size; ++ k) {
+                matrix_slice_copy (e, axis, k, v);
+                r (k) = select_quantile (v.begin (), v.end (), q, method, compareElement);
+            }
+        }
+
+        // Result row l holds quantile q (l) of every slice
+        template<class E, class Q>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, const vector_expression<Q> &q, typename E::size_type axis, quantile_interpolation method, matrix<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            std::vector<value_type> v;
+            std::vector<result_type> t (q ().size ());
+            r.resize (q ().size (), size, false);
+            for (matrix_size_type k = 0; k < size; ++ k) {
+                matrix_slice_copy (e, axis, k, v);
+                select_quantiles (v.begin (), v.end (), q ().begin (), q ().end (), t.begin (), method, compareElement);
+                for (matrix_size_type l = 0; l < t.size (); ++ l)
+                    r (l, k) = t [l];
+            }
+        }
+    };
+
+    // vector_robust of every column (axis 0) or row (axis 1), all slices
+    // sharing one scratch buffer
+    template<class M>
+    struct matrix_robust_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E, class S>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, const S &statistic, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            std::vector<value_type> v;
+            r.resize (size, false);
+            for (matrix_size_type k = 0; k < size; ++ k) {
+                matrix_slice_copy (e, axis, k, v);
+                r (k) = statistic (v.begin (), v.end ());
+            }
+        }
+    };
+
+    // vector_winsorize of every column (axis 0) or row (axis 1), all slices
+    // sharing one scratch buffer
+    template<class M>
+    struct matrix_winsorize_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, double lo, double hi, typename E::size_type axis, matrix<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            matrix_size_type size (axis == 0 ? size2 : size1);
+            std::vector<value_type> v;
+            r.resize (size1, size2, false);
+            for (matrix_size_type k = 0; k < size; ++ k) {
+                matrix_slice_copy (e, axis, k, v);
+                if (v.empty ())
+                    continue;
+                value_type lower, upper;
+                select_winsor_limits (v.begin (), v.end (), lo, hi, lower, upper);
+                for (matrix_size_type l = 0; l < (axis == 0 ? size1 : size2); ++ l) {
+                    value_type x (axis == 0 ? e () (l, k) : e () (k, l));
+                    (axis == 0 ? r (l, k) : r (k, l)) = x < lower ? lower : (upper < x ? upper : x);
+                }
+            }
+        }
+    };
+
+#ifdef BOOST_UBLAS_USE_SIMD
+    // Fills the partials of the slots [first, last) of a contiguous matrix
+    // with the masked SIMD kernels. A slice that runs along the storage
+    // rows is pushed as one range. Slices that run across them are updated
+    // together, one storage row at a time, with value_type counts flushed
+    // into the partials every block of rows.
+    template<class E, class P>
+    class matrix_nan_moments_kernel {
+    public:
+        typedef typename E::size_type size_type;
+        typedef typename E::value_type value_type;
+
+        BOOST_UBLAS_INLINE
+        matrix_nan_moments_kernel (const E &e, size_type axis, std::vector<P> &partials):
+            e_ (e), axis_ (axis), partials_ (partials) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type, size_type first, size_type last) const {
+            bool column_major = boost::is_same<typename E::orientation_category, column_major_tag>::value;
+            size_type size (axis_ == 0 ? e_.size2 () : e_.size1 ());
+            size_type length (axis_ == 0 ? e_.size1 () : e_.size2 ());
+            const value_type *data = contiguous_storage<E>::data (e_);
+            if ((axis_ == 1) != column_major) {
+                for (size_type k = first; k < last; ++ k)
+                    partials_ [k].push_range (data + k * length, data + (k + 1) * length);
+                return;
+            }
+            size_type width (last - first);
+            std::vector<value_type> count (width), mean (width), m2 (width);
+            const size_type block (size_type (1) << 22);
+            for (size_type l1 = 0; l1 < length; l1 += block) {
+                size_type l2 ((std::min) (length, l1 + block));
+                std::fill (count.begin (), count.end (), value_type (0));
+                std::fill (mean.begin (), mean.end (), value_type (0));
+                std::fill (m2.begin (), m2.end (), value_type (0));
+                for (size_type l = l1; l < l2; ++ l)
+                    detail::contiguous_nan_moments_update (data + l * size + first, width, &count [0], &mean [0], &m2 [0]);
+                for (size_type k = 0; k < width; ++ k) {
+                    P p;
+                    p.count = size_type (count [k]);
+                    p.nans = (l2 - l1) - p.count;
+                    p.mean = mean [k];
+                    p.m2 = m2 [k];
+                    partials_ [first + k].merge (p);
+                }
+            }
+        }
+
+    private:
+        const E &e_;
+        size_type axis_;
+        std::vector<P> &partials_;
+    };
+#endif
+
+    // vector_nan_moment of every column (axis 0) or row (axis 1). Contiguous
+    // float and double matrices go through matrix_nan_moments_kernel in
+    // parallel chunks of slots, anything else sweeps into an
+    // axis_nan_accumulator.
+    template<class M, class Tag>
+    struct matrix_nan_moment_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            r.resize (size, false);
+            if (size == matrix_size_type (0))
+                return;
+            apply (e, axis, r, boost::mpl::bool_<contiguous_storage<E>::value> ());
+        }
+
+    private:
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r, boost::mpl::false_) {
+            typedef typename E::size_type matrix_size_type;
+            typedef nan_moments_partial<result_type, matrix_size_type> partial_type;
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            axis_nan_accumulator<partial_type, matrix_size_type> acc (r.size ());
+            matrix_axis_reduce (e, axis, acc);
+            for (matrix_size_type k = 0; k < r.size (); ++ k)
+                r (k) = acc.finish (k, length).value (Tag ());
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r, boost::mpl::true_) {
+            typedef typename E::size_type matrix_size_type;
+            typedef nan_moments_partial<result_type, matrix_size_type> partial_type;
+            matrix_size_type size (r.size ());
+            std::vector<partial_type> partials (size);
+            matrix_size_type chunks (detail::reduction_chunks (e ().size1 () * e ().size2 ()));
+            if (chunks > size)
+                chunks = size;
+            matrix_nan_moments_kernel<E, partial_type> kernel (e (), axis, partials);
+            detail::reduce_chunks (size, chunks, kernel);
+            for (matrix_size_type k = 0; k < size; ++ k)
+                r (k) = partials [k].value (Tag ());
+        }
+#endif
+    };
+
+    // vector_nan_extremum of every column (axis 0) or row (axis 1)
+    template<class M, class Compare>
+    struct matrix_nan_extremum_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            typedef nan_extremum_partial<result_type, Compare, matrix_size_type> partial_type;
+            BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            r.resize (size, false);
+            axis_nan_accumulator<partial_type, matrix_size_type> acc (size);
+            matrix_axis_reduce (e, axis, acc);
+            for (matrix_size_type k = 0; k < size; ++ k)
+                r (k) = acc.finish (k, length).value ();
+        }
+    };
+
+    // vector_nanmedian of every column (axis 0) or row (axis 1), all slices
+    // sharing one scratch buffer
+    template<class M>
+    struct matrix_nanmedian_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::value_type result_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void apply (const matrix_expression<E> &e, typename E::size_type axis, vector<result_type> &r) {
+            typedef typename E::size_type matrix_size_type;
+            BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            std::vector<value_type> v;
+            r.resize (size, false);
+            for (matrix_size_type k = 0; k < size; ++ k) {
+                matrix_slice_copy (e, axis, k, v);
+                typename std::vector<value_type>::iterator last (v.begin ());
+                for (typename std::vector<value_type>::iterator it = v.begin (); it != v.end (); ++ it)
+                    if (*it == *it)
+                        *last ++ = *it;
+                r (k) = last == v.begin () ? std::numeric_limits<result_type>::quiet_NaN () :
+                        select_median (v.begin (), last, vector_median<vector<value_type> >::compareElement);
+            }
+        }
+    };
+
+    // Per-slot smallest and largest element by value, filled by
+    // matrix_axis_sweep. Slots with implicit zeros take zero into account.
+    template<class T, class S>
+    class axis_range_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit axis_range_accumulator (size_type size):
+            count_ (size, size_type (0)), lo_ (size, value_type (0)), hi_ (size, value_type (0)) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            if (count_ [k] ++ == 0)
+                lo_ [k] = hi_ [k] = x;
+            else if (x < lo_ [k])
+                lo_ [k] = x;
+            else if (hi_ [k] < x)
+                hi_ [k] = x;
+        }
+
+        BOOST_UBLAS_INLINE
+        void finish (size_type k, size_type length, value_type &lo, value_type &hi) const {
+            lo = lo_ [k];
+            hi = hi_ [k];
+            if (count_ [k] < length) {
+                if (count_ [k] == 0 || value_type (0) < lo)
+                    lo = value_type (0);
+                if (count_ [k] == 0 || hi < value_type (0))
+                    hi = value_type (0);
+            }
+        }
+
+    private:
+        std::vector<size_type> count_;
+        std::vector<value_type> lo_;
+        std::vector<value_type> hi_;
+    };
+
+    // Replaces e (i, j) by (e (i, j) - shift [k]) * scale [k], where k is j
+    // for axis 0 and i for axis 1, over the storage lines [first, last).
+    // Chunks own disjoint lines.
+    template<class E>
+    class matrix_affine_axis_kernel {
+    public:
+        typedef typename E::size_type size_type;
+        typedef typename E::value_type value_type;
+
+        BOOST_UBLAS_INLINE
+        matrix_affine_axis_kernel (E &e, size_type axis, const std::vector<value_type> &shift, const std::vector<value_type> &scale):
+            e_ (e), axis_ (axis), shift_ (shift), scale_ (scale) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type, size_type first, size_type last) const {
+            bool column_major = boost::is_same<typename E::orientation_category, column_major_tag>::value;
+            size_type length (column_major ? e_.size1 () : e_.size2 ());
+            // Slot of the line when the slices run along the storage lines
+            bool along ((axis_ == 1) != column_major);
+            for (size_type l = first; l < last; ++ l)
+                for (size_type j = 0; j < length; ++ j) {
+                    size_type k (along ? l : j);
+                    size_type i1 (column_major ? j : l);
+                    size_type i2 (column_major ? l : j);
+                    e_ (i1, i2) = (e_ (i1, i2) - shift_ [k]) * scale_ [k];
+                }
+        }
+
+    private:
+        E &e_;
+        size_type axis_;
+        const std::vector<value_type> &shift_;
+        const std::vector<value_type> &scale_;
+    };
+
+    // Storage the axis transforms can rewrite element by element. Packed
+    // storage is excluded: symmetric storage would transform the shared
+    // off-diagonal elements twice and triangular or banded storage has no
+    // room for the structural zeros the transform moves.
+    template<class S>
+    struct axis_transform_storage {
+        BOOST_STATIC_CONSTANT (bool, value = false);
+    };
+    template<>
+    struct axis_transform_storage<dense_tag> {
+        BOOST_STATIC_CONSTANT (bool, value = true);
+    };
+    template<>
+    struct axis_transform_storage<dense_proxy_tag> {
+        BOOST_STATIC_CONSTANT (bool, value = true);
+    };
+    template<>
+    struct axis_transform_storage<sparse_tag> {
+        BOOST_STATIC_CONSTANT (bool, value = true);
+    };
+    template<>
+    struct axis_transform_storage<sparse_proxy_tag> {
+        BOOST_STATIC_CONSTANT (bool, value = true);
+    };
+
+    struct center_transform_tag {};
+    struct zscore_transform_tag {};
+    struct min_max_transform_tag {};
+
+    // Standardizes every column (axis 0) or row (axis 1) in place in two
+    // sweeps: matrix_axis_reduce gathers a shift and scale per slot, then
+    // matrix_affine_axis_kernel applies them in storage order, in parallel
+    // chunks of lines for dense matrices. Slices with no spread are only
+    // shifted, to all zeros. Only dense and sparse storage is accepted, see
+    // axis_transform_storage.
+    template<class M>
+    struct matrix_transform_axis {
+        typedef typename M::value_type value_type;
+
+        template<class E, class Tag>
+        static BOOST_UBLAS_INLINE
+        void apply (matrix_expression<E> &e, typename E::size_type axis, Tag tag) {
+            typedef typename E::size_type matrix_size_type;
+            BOOST_STATIC_ASSERT (axis_transform_storage<typename E::storage_category>::value);
+            BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
+            matrix_size_type size (axis == 0 ? e ().size2 () : e ().size1 ());
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            if (size == matrix_size_type (0) || length == matrix_size_type (0))
+                return;
+            std::vector<value_type> shift (size), scale (size);
+            statistics (e, axis, shift, scale, tag);
+            matrix_affine_axis_kernel<E> kernel (e (), axis, shift, scale);
+            sweep (e, kernel, typename E::storage_category ());
+        }
+
+    private:
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void statistics (const matrix_expression<E> &e, typename E::size_type axis,
+                         std::vector<value_type> &shift, std::vector<value_type> &scale, center_transform_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            axis_moments_accumulator<value_type, matrix_size_type> acc (shift.size ());
+            matrix_axis_reduce (e, axis, acc);
+            value_type m2;
+            for (matrix_size_type k = 0; k < shift.size (); ++ k) {
+                acc.finish (k, length, shift [k], m2);
+                scale [k] = value_type (1);
+            }
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void statistics (const matrix_expression<E> &e, typename E::size_type axis,
+                         std::vector<value_type> &shift, std::vector<value_type> &scale, zscore_transform_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            axis_moments_accumulator<value_type, matrix_size_type> acc (shift.size ());
+            matrix_axis_reduce (e, axis, acc);
+            value_type m2;
+            for (matrix_size_type k = 0; k < shift.size (); ++ k) {
+                acc.finish (k, length, shift [k], m2);
+                value_type sd (type_traits<value_type>::type_sqrt (m2 / length));
+                scale [k] = sd > value_type (0) ? value_type (1) / sd : value_type (1);
+            }
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void statistics (const matrix_expression<E> &e, typename E::size_type axis,
+                         std::vector<value_type> &shift, std::vector<value_type> &scale, min_max_transform_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type length (axis == 0 ? e ().size1 () : e ().size2 ());
+            axis_range_accumulator<value_type, matrix_size_type> acc (shift.size ());
+            matrix_axis_reduce (e, axis, acc);
+            value_type hi;
+            for (matrix_size_type k = 0; k < shift.size (); ++ k) {
+                acc.finish (k, length, shift [k], hi);
+                scale [k] = shift [k] < hi ? value_type (1) / (hi - shift [k]) : value_type (1);
+            }
+        }
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void sweep (matrix_expression<E> &e, matrix_affine_axis_kernel<E> &kernel, dense_proxy_tag) {
+            typedef typename E::size_type matrix_size_type;
+            bool column_major = boost::is_same<typename E::orientation_category, column_major_tag>::value;
+            matrix_size_type lines (column_major ? e ().size2 () : e ().size1 ());
+            matrix_size_type chunks (detail::reduction_chunks (e ().size1 () * e ().size2 ()));
+            if (chunks > lines)
+                chunks = lines;
+            detail::reduce_chunks (lines, chunks, kernel);
+        }
+        // Sparse matrices fill in, so they are swept by a single thread
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void sweep (matrix_expression<E> &e, matrix_affine_axis_kernel<E> &kernel, sparse_proxy_tag) {
+            typedef typename E::size_type matrix_size_type;
+            bool column_major = boost::is_same<typename E::orientation_category, column_major_tag>::value;
+            kernel (matrix_size_type (0), matrix_size_type (0), column_major ? e ().size2 () : e ().size1 ());
+        }
+    };
+
+    // Unary returning summary of vectors
+
+    // One describe_accumulator per output index, fed by a single sweep over
+    // the matrix in its storage order.
+    template<class M>
+    struct matrix_describe_axis {
+        typedef typename M::value_type value_type;
+        typedef typename M::size_type size_type;
+        typedef stats_summary<vector<value_type>, size_type> result_type;
+        typedef describe_accumulator<value_type, size_type> accumulator_type;
+
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        result_type apply (const matrix_expression<E> &e, typename E::size_type axis) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            matrix_size_type result_size = axis == 0 ? size2 : size1;
+            matrix_size_type slice_size = axis == 0 ? size1 : size2;
+
+            std::vector<accumulator_type> accs (result_size, accumulator_type (slice_size));
+            accumulate (e, axis, accs, typename E::orientation_category ());
+
+            result_type s;
+            s.count = slice_size;
+            s.mean.resize (result_size, false);
+            s.variance.resize (result_size, false);
+            s.min.resize (result_size, false);
+            s.max.resize (result_size, false);
+            s.median.resize (result_size, false);
+            s.mode.resize (result_size, false);
+            for (matrix_size_type k = 0; k < result_size; ++ k) {
+                stats_summary<value_type, size_type> sk = accs [k].result ();
+                s.mean (k) = sk.mean;
+                s.variance (k) = sk.variance;
+                s.min (k) = sk.min;
+                s.max (k) = sk.max;
+                s.median (k) = sk.median;
+                s.mode (k) = sk.mode;
+            }
+            return s;
+        }
+
+    private:
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void accumulate (const matrix_expression<E> &e, typename E::size_type axis, std::vector<accumulator_type> &accs, row_major_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            for (matrix_size_type i = 0; i < size1; ++ i)
+                for (matrix_size_type j = 0; j < size2; ++ j)
+                    accs [axis == 0 ? j : i].push (e () (i, j));
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void accumulate (const matrix_expression<E> &e, typename E::size_type axis, std::vector<accumulator_type> &accs, column_major_tag) {
+            typedef typename E::size_type matrix_size_type;
+            matrix_size_type size1 (e ().size1 ());
+            matrix_size_type size2 (e ().size2 ());
+            for (matrix_size_type j = 0; j < size2; ++ j)
+                for (matrix_size_type i = 0; i < size1; ++ i)
+                    accs [axis == 0 ? j : i].push (e () (i, j));
+        }
+        template<class E>
+        static BOOST_UBLAS_INLINE
+        void accumulate (const matrix_expression<E> &e, typename E::size_type axis, std::vector<accumulator_type> &accs, unknown_orientation_tag) {
+            accumulate (e, axis, accs, row_major_tag ());
         }
     };
 
@@ -2938,8 +6442,7 @@ namespace boost { namespace numeric { namespace ublas {
             size_type s2 = stride (c2 ());
             result_type t = result_type (0);
             if (s1 == 1 && s2 == 1) {
-                for (size_type j = 0; j < size; ++ j)
-                    t += data1 [j] * data2 [j];
+                t = detail::contiguous_dot (data1, data2, size);
             } else if (s2 == 1) {
                 for (size_type j = 0, j1 = 0; j < size; ++ j, j1 += s1)
                     t += data1 [j1] * data2 [j];
@@ -3106,8 +6609,7 @@ namespace boost { namespace numeric { namespace ublas {
             size_type s2 = stride1 (c2 ());
             result_type t = result_type (0);
             if (s1 == 1 && s2 == 1) {
-                for (size_type j = 0; j < size; ++ j)
-                    t += data1 [j] * data2 [j];
+                t = detail::contiguous_dot (data1, data2, size);
             } else if (s2 == 1) {
                 for (size_type j = 0, j1 = 0; j < size; ++ j, j1 += s1)
                     t += data1 [j1] * data2 [j];
@@ -3283,8 +6785,7 @@ namespace boost { namespace numeric { namespace ublas {
             size_type s2 = stride1 (c2 ());
             result_type t = result_type (0);
             if (s1 == 1 && s2 == 1) {
-                for (size_type k = 0; k < size; ++ k)
-                    t += data1 [k] * data2 [k];
+                t = detail::contiguous_dot (data1, data2, size);
             } else if (s2 == 1) {
                 for (size_type k = 0, k1 = 0; k < size; ++ k, k1 += s1)
                     t += data1 [k1] * data2 [k];
@@ -3402,6 +6903,7 @@ namespace boost { namespace numeric { namespace ublas {
         typedef typename M::value_type value_type;
         typedef typename type_traits<value_type>::real_type real_type;
         typedef real_type result_type;
+        typedef indexed_elements_tag element_category;
     };
 
     template<class M>
@@ -14,8 +14,14 @@
 
 #ifndef _BOOST_UBLAS_HISTOGRAM_
 #define _BOOST_UBLAS_HISTOGRAM_
-#endif
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/mpl/bool.hpp>
+#include <boost/mpl/if.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
@@ -23,86 +29,555 @@ static const double TOLER = 1e-12;
 
 namespace boost { namespace numeric { namespace ublas {
 
+namespace detail {
+
+    // Number of edges e with e - x < TOLER, by a binary search whose halving
+    // step compiles to a conditional move. Edges are increasing.
+    template<class T>
     BOOST_UBLAS_INLINE
-    template<class V>
-    vector<int> histogram (const V &v, int nbins = 10) {
-        typedef typename V::value_type value_type;
-        typedef typename V::size_type size_type;
+    std::size_t edges_below (const T *edges, std::size_t nedges, const T &x) {
+        const T *base = edges;
+        std::size_t n = nedges;
+        while (n > 1) {
+            std::size_t half = n / 2;
+            base = (base [half] - x < TOLER) ? base + half : base;
+            n -= half;
+        }
+        return (base - edges) + (*base - x < TOLER ? 1 : 0);
+    }
 
-        size_type vsize (v.size ());
+    // Same count for edges within a quarter bin width of e0 + i * width:
+    // computed from the position of x and corrected against the edges
+    template<class T>
+    BOOST_UBLAS_INLINE
+    std::size_t uniform_edges_below (const T *edges, std::size_t nedges, T width, const T &x) {
+        T r ((x - edges [0]) / width);
+        std::size_t k = ! (r >= T (0)) ? 0 : (r >= T (nedges) ? nedges : std::size_t (r) + 1);
+        while (k > 0 && ! (edges [k - 1] - x < TOLER))
+            -- k;
+        while (k < nedges && edges [k] - x < TOLER)
+            ++ k;
+        return k;
+    }
 
-        assert (vsize > 0 && "Vector is empty.");
+    // Bin of an element among nbins bins of the given width from lo. Positions
+    // within TOLER below a bin boundary round up, and the top of the range
+    // belongs to the last bin. NaNs and elements below lo go to nbins (), the
+    // slot outside the bins, as in edge_binner.
+    template<class T>
+    class uniform_binner {
+    public:
+        typedef T value_type;
 
-        assert (nbins > 0 && "Number of bins should be positive.");
+        BOOST_UBLAS_INLINE
+        uniform_binner (const value_type &lo, const value_type &width, std::size_t nbins):
+            lo_ (lo), width_ (width), top_ (value_type (nbins - 1)), nbins_ (nbins) {}
+
+        BOOST_UBLAS_INLINE
+        std::size_t nbins () const {
+            return nbins_;
+        }
+        BOOST_UBLAS_INLINE
+        std::size_t operator () (const value_type &x) const {
+            value_type r ((x - lo_) / width_ + value_type (TOLER));
+            if (! (r >= value_type (0)))
+                return nbins_;
+            return std::size_t (r < top_ ? r : top_);
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        // Bin positions of a block at a time from the SIMD kernel
+        template<class C>
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last, C &counts) const {
+            const std::size_t block = 256;
+            value_type r [block];
+            while (first != last) {
+                std::size_t n (std::min (block, std::size_t (last - first)));
+                contiguous_bin_positions (first, n, lo_, width_, value_type (TOLER), top_, r);
+                for (std::size_t i = 0; i < n; ++ i)
+                    ++ counts [r [i] >= value_type (0) ? std::size_t (r [i]) : nbins_];
+                first += n;
+            }
+        }
+#endif
+
+    private:
+        value_type lo_;
+        value_type width_;
+        value_type top_;
+        std::size_t nbins_;
+    };
+
+    // Bin of an element among the bins [edges [i], edges [i + 1]), the last
+    // one closed, or nbins () for elements outside the edges
+    template<class T>
+    class edge_binner {
+    public:
+        typedef T value_type;
+
+        BOOST_UBLAS_INLINE
+        explicit edge_binner (const std::vector<value_type> &edges):
+            edges_ (edges), uniform_ (true) {
+            std::size_t nedges (edges_.size ());
+            width_ = (edges_ [nedges - 1] - edges_ [0]) / value_type (nedges - 1);
+            for (std::size_t i = 1; i < nedges - 1 && uniform_; ++ i) {
+                value_type d (edges_ [i] - edges_ [0] - value_type (i) * width_);
+                uniform_ = d < width_ / 4 && -d < width_ / 4;
+            }
+        }
+
+        BOOST_UBLAS_INLINE
+        std::size_t nbins () const {
+            return edges_.size () - 1;
+        }
+        BOOST_UBLAS_INLINE
+        std::size_t operator () (const value_type &x) const {
+            std::size_t nedges (edges_.size ());
+            std::size_t k = uniform_ ? uniform_edges_below (&edges_ [0], nedges, width_, x) :
+                                       edges_below (&edges_ [0], nedges, x);
+            if (k == 0 || (k == nedges && x > edges_ [nedges - 1]))
+                return nedges - 1;
+            return k < nedges ? k - 1 : nedges - 2;
+        }
+        template<class C>
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last, C &counts) const {
+            for (; first != last; ++ first)
+                ++ counts [(*this) (*first)];
+        }
+
+    private:
+        std::vector<value_type> edges_;
+        value_type width_;
+        bool uniform_;
+    };
+
+    // Fills the sub-histogram of chunk c. Its extra last slot takes the
+    // elements the binner puts outside the bins.
+    template<class E, class B>
+    class histogram_kernel {
+    public:
+        typedef typename E::size_type size_type;
+        typedef std::vector<boost::uint64_t> counts_type;
+
+        BOOST_UBLAS_INLINE
+        histogram_kernel (const E &e, const B &binner, std::vector<counts_type> &counts):
+            e_ (e), binner_ (binner), counts_ (counts) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type c, size_type first, size_type last) const {
+            counts_type &h = counts_ [c];
+            h.assign (binner_.nbins () + 1, 0);
+            sweep (h, first, last, boost::mpl::bool_<contiguous_storage<E>::value> ());
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        void sweep (counts_type &h, size_type first, size_type last, boost::mpl::false_) const {
+            for (size_type i = first; i < last; ++ i)
+                ++ h [binner_ (e_ (i))];
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void sweep (counts_type &h, size_type first, size_type last, boost::mpl::true_) const {
+            const typename E::value_type *data = contiguous_storage<E>::data (e_);
+            binner_.push_range (data + first, data + last, h);
+        }
+#endif
+
+        const E &e_;
+        const B &binner_;
+        std::vector<counts_type> &counts_;
+    };
+
+    // Bin counts of the elements of e, from private sub-histograms of
+    // parallel chunks when BOOST_UBLAS_PARALLEL_REDUCTIONS is defined
+    template<class E, class B>
+    BOOST_UBLAS_INLINE
+    vector<boost::uint64_t> histogram_counts (const E &e, const B &binner) {
+        typedef typename E::size_type size_type;
+        size_type size (e.size ());
+        size_type chunks (expression_chunks<E> (size));
+        std::vector<std::vector<boost::uint64_t> > counts (chunks);
+        histogram_kernel<E, B> kernel (e, binner, counts);
+        reduce_chunks (size, chunks, kernel);
+        vector<boost::uint64_t> bin_counts (binner.nbins ());
+        for (std::size_t b = 0; b < binner.nbins (); ++ b) {
+            boost::uint64_t t (0);
+            for (size_type c = 0; c < chunks; ++ c)
+                t += counts [c] [b];
+            bin_counts (b) = t;
+        }
+        return bin_counts;
+    }
+
+    // Value range and number of stored elements of every slot of an axis
+    // sweep
+    template<class T, class S>
+    class axis_range_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        axis_range_accumulator (std::vector<range_partial<value_type> > &ranges, std::vector<size_type> &stored):
+            ranges_ (ranges), stored_ (stored) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            ranges_ [k].push (x);
+            ++ stored_ [k];
+        }
+
+    private:
+        std::vector<range_partial<value_type> > &ranges_;
+        std::vector<size_type> &stored_;
+    };
+
+    // Bin counts of every slot of an axis sweep, slot k in column k of counts
+    template<class T, class S>
+    class axis_histogram_accumulator {
+    public:
+        typedef T value_type;
+        typedef S size_type;
+
+        BOOST_UBLAS_INLINE
+        axis_histogram_accumulator (const std::vector<uniform_binner<value_type> > &binners, matrix<boost::uint64_t> &counts):
+            binners_ (binners), counts_ (counts) {}
+
+        BOOST_UBLAS_INLINE
+        void push (size_type k, const value_type &x) {
+            std::size_t b (binners_ [k] (x));
+            if (b < binners_ [k].nbins ())
+                ++ counts_ (b, k);
+        }
+
+    private:
+        const std::vector<uniform_binner<value_type> > &binners_;
+        matrix<boost::uint64_t> &counts_;
+    };
+
+    // Uniform binner over [lo, hi]. An empty range is widened to
+    // [lo - 0.5, hi + 0.5], as numpy does, so constant data lands in the
+    // middle bin.
+    template<class T>
+    BOOST_UBLAS_INLINE
+    uniform_binner<T> range_binner (T lo, T hi, std::size_t nbins) {
+        if (! (lo < hi)) {
+            lo -= T (0.5);
+            hi += T (0.5);
+        }
+        return uniform_binner<T> (lo, (hi - lo) / T (nbins), nbins);
+    }
+
+    // Observation i of a joint histogram: row i of a matrix, or element i of
+    // each of two vectors
+    template<class E>
+    class matrix_samples {
+    public:
+        typedef typename E::value_type value_type;
+        typedef typename E::size_type size_type;
+        typedef typename E::storage_category storage_category;
+
+        BOOST_UBLAS_INLINE
+        explicit matrix_samples (const E &e):
+            e_ (e) {}
+
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return e_.size1 ();
+        }
+        BOOST_UBLAS_INLINE
+        value_type operator () (size_type i, size_type d) const {
+            return e_ (i, d);
+        }
+
+    private:
+        const E &e_;
+    };
 
-        value_type bin_size = (max (v) - min (v)) / (nbins);
+    template<class E1, class E2>
+    class paired_samples {
+    public:
+        typedef typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type value_type;
+        typedef typename E1::size_type size_type;
+        typedef typename boost::mpl::if_c<splittable_expression<E1>::value && splittable_expression<E2>::value,
+                                          packed_proxy_tag, unknown_storage_tag>::type storage_category;
 
-        assert ((bin_size > 0 || (bin_size == 0 && nbins == 1)) && "Bin size cannot be zero.");
+        BOOST_UBLAS_INLINE
+        paired_samples (const E1 &e1, const E2 &e2):
+            e1_ (e1), e2_ (e2) {}
 
-        vector<int> bin_counts (nbins);
-        for (int i = 0; i < nbins; ++ i)
-            bin_counts (i) = 0;
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return BOOST_UBLAS_SAME (e1_.size (), e2_.size ());
+        }
+        BOOST_UBLAS_INLINE
+        value_type operator () (size_type i, size_type d) const {
+            return d == 0 ? value_type (e1_ (i)) : value_type (e2_ (i));
+        }
+
+    private:
+        const E1 &e1_;
+        const E2 &e2_;
+    };
+
+    // Fills the joint sub-histogram of chunk c, flattened with the first
+    // dimension slowest. Its extra last slot takes the observations any
+    // binner puts outside its bins.
+    template<class X, class B>
+    class joint_histogram_kernel {
+    public:
+        typedef typename X::size_type size_type;
+        typedef std::vector<boost::uint64_t> counts_type;
 
-        if (nbins == 1)
-            bin_counts (0) = vsize;
-        else {    
-            value_type min_val = min (v);
-            for (size_type i = 0; i < vsize; ++ i) {
-                int bin_index = (v (i) - min_val) / bin_size;
-                if ((double)(bin_index + 1) - ((v (i) - min_val) / bin_size) <= TOLER)
-                    bin_index += 1;
-                bin_index = (bin_index >= nbins) ? (nbins - 1) : bin_index;
-                bin_counts (bin_index) += 1;
+        BOOST_UBLAS_INLINE
+        joint_histogram_kernel (const X &samples, const std::vector<B> &binners, std::size_t nbins,
+                                std::vector<counts_type> &counts):
+            samples_ (samples), binners_ (binners), nbins_ (nbins), counts_ (counts) {}
+
+        BOOST_UBLAS_INLINE
+        void operator () (size_type c, size_type first, size_type last) const {
+            counts_type &h = counts_ [c];
+            h.assign (nbins_ + 1, 0);
+            for (size_type i = first; i < last; ++ i) {
+                std::size_t flat = 0;
+                bool inside = true;
+                for (size_type d = 0; d < binners_.size (); ++ d) {
+                    std::size_t b (binners_ [d] (samples_ (i, d)));
+                    inside = inside && b < binners_ [d].nbins ();
+                    flat = flat * binners_ [d].nbins () + b;
+                }
+                ++ h [inside ? flat : nbins_];
             }
         }
 
+    private:
+        const X &samples_;
+        const std::vector<B> &binners_;
+        std::size_t nbins_;
+        std::vector<counts_type> &counts_;
+    };
+
+    // Joint counts of the samples. The product of the bin counts must not
+    // exceed BOOST_UBLAS_HISTOGRAM_MAX_BINS, and chunks are only split off
+    // while each one still has at least as many observations as bins, since
+    // every chunk keeps a full set of counts.
+    template<class X, class B>
+    BOOST_UBLAS_INLINE
+    vector<boost::uint64_t> joint_histogram_counts (const X &samples, const std::vector<B> &binners) {
+        typedef typename X::size_type size_type;
+        const std::size_t max_bins (BOOST_UBLAS_HISTOGRAM_MAX_BINS);
+        std::size_t nbins = 1;
+        for (std::size_t d = 0; d < binners.size (); ++ d) {
+            if (binners [d].nbins () > max_bins / nbins)
+                bad_size ("Joint histogram has too many bins.").raise ();
+            nbins *= binners [d].nbins ();
+        }
+        size_type size (samples.size ());
+        size_type chunks (expression_chunks<X> (size));
+        if (chunks > size / nbins)
+            chunks = (std::max) (size / nbins, size_type (1));
+        std::vector<std::vector<boost::uint64_t> > counts (chunks);
+        joint_histogram_kernel<X, B> kernel (samples, binners, nbins, counts);
+        reduce_chunks (size, chunks, kernel);
+        vector<boost::uint64_t> bin_counts (nbins);
+        for (std::size_t b = 0; b < nbins; ++ b) {
+            boost::uint64_t t (0);
+            for (size_type c = 0; c < chunks; ++ c)
+                t += counts [c] [b];
+            bin_counts (b) = t;
+        }
         return bin_counts;
     }
 
+}
+
+    // Counts of the elements of v in nbins equal bins between its smallest
+    // and largest element. The range is found in one fused pass, and the
+    // elements are binned by direct index computation. NaNs are not counted,
+    // and constant data lands in the middle bin, as in the axis form.
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<boost::uint64_t> histogram (const vector_expression<E> &v, int nbins = 10) {
+        typedef typename E::value_type value_type;
+
+        std::size_t vsize (v ().size ());
+
+        assert (vsize > 0 && "Vector is empty.");
+
+        assert (nbins > 0 && "Number of bins should be positive.");
+
+        range_partial<value_type> range (vector_reduce<range_partial<value_type> > (v));
+
+        return detail::histogram_counts (v (), detail::range_binner (range.lo, range.hi, nbins));
+    }
+
+    // Counts of the elements of v in the bins [bin_edges (i), bin_edges (i + 1)),
+    // the last bin closed. Elements outside the edges are not counted. v is
+    // read once in place, so rows, columns and ranges need not be copied.
+    // Each element is located by binary search over the edges, or directly
+    // from its position when the edges are uniformly spaced.
+    template<class E1, class E2>
     BOOST_UBLAS_INLINE
-    template<class V>
-    vector<int> histogram (V v, const V &bin_edges) {
-        typedef typename V::value_type value_type;
-        typedef typename V::size_type size_type;
+    vector<boost::uint64_t> histogram (const vector_expression<E1> &v, const vector_expression<E2> &bin_edges) {
+        typedef typename E1::value_type value_type;
+        typedef std::size_t size_type;
 
-        size_type size1 (v.size ());
+        size_type size1 (v ().size ());
 
         assert (size1 > 0 && "Vector is empty.");
-        
-        size_type size2 (bin_edges.size ());
+
+        size_type size2 (bin_edges ().size ());
 
         assert (size2 > 1 && "Number of bins should be positive.");
 
+        std::vector<value_type> edges (size2);
+        for (size_type i = 0; i < size2; ++ i)
+            edges [i] = bin_edges () (i);
+
         for (size_type i = 0; i < size2 - 1; ++ i)
-            assert ((bin_edges (i) < bin_edges (i + 1)) &&
+            assert ((edges [i] < edges [i + 1]) &&
                 "Bin edges must be monotonically increasing.");
 
-        vector<int> bin_counts (size2 - 1);
-        for (int i = 0; i < bin_counts.size (); ++ i)
-            bin_counts (i) = 0;
+        return detail::histogram_counts (v (), detail::edge_binner<value_type> (edges));
+    }
 
-        boost::sort (v);
+    // Histograms of nbins equal bins over the range of every column (axis 0)
+    // or row (axis 1) of m. Column k of the nbins x slots result holds slot k,
+    // as in quantiles (m, q, axis). Ranges and counts of all slots are each
+    // formed in one storage-order sweep; sparse matrices visit only their
+    // stored elements and count their zeros afterwards.
+    template<class E>
+    BOOST_UBLAS_INLINE
+    matrix<boost::uint64_t> histogram (const matrix_expression<E> &m, int nbins, typename E::size_type axis) {
+        typedef typename E::value_type value_type;
+        typedef typename E::size_type size_type;
 
-        if (v (0) > bin_edges (size2 - 1) || v (size1 - 1) < bin_edges (0))
-            return bin_counts;
+        BOOST_UBLAS_CHECK (axis == 0 || axis == 1, bad_argument ());
 
-        size_type vcounter = size_type (0);
-        size_type bincounter = size_type (1);
-        while (vcounter < size1 && bincounter < size2) {
-            if (bin_edges (bincounter) - v (vcounter) >= TOLER) {
-                bin_counts (bincounter - 1) += 1;
-                ++ vcounter;
-            }
-            else
-                ++ bincounter;
+        size_type slots (axis == 0 ? m ().size2 () : m ().size1 ());
+        size_type length (axis == 0 ? m ().size1 () : m ().size2 ());
+
+        assert (length > 0 && "Matrix is empty.");
+
+        assert (nbins > 0 && "Number of bins should be positive.");
+
+        std::vector<range_partial<value_type> > ranges (slots);
+        std::vector<size_type> stored (slots, size_type (0));
+        detail::axis_range_accumulator<value_type, size_type> range_acc (ranges, stored);
+        matrix_axis_reduce (m, axis, range_acc);
+
+        std::vector<detail::uniform_binner<value_type> > binners;
+        binners.reserve (slots);
+        for (size_type k = 0; k < slots; ++ k) {
+            if (stored [k] < length)
+                ranges [k].push (value_type (0));
+            binners.push_back (detail::range_binner (ranges [k].lo, ranges [k].hi, nbins));
         }
 
-        while (vcounter < size1 && v (vcounter) <= bin_edges (size2 - 1)) {
-            bin_counts (size2 - 2) += 1;
-            ++ vcounter;
+        matrix<boost::uint64_t> counts (nbins, slots);
+        counts.clear ();
+        detail::axis_histogram_accumulator<value_type, size_type> count_acc (binners, counts);
+        matrix_axis_reduce (m, axis, count_acc);
+        for (size_type k = 0; k < slots; ++ k)
+            if (stored [k] < length)
+                counts (binners [k] (value_type (0)), k) += length - stored [k];
+
+        return counts;
+    }
+
+    // Joint histogram of the pairs (x (i), y (i)) in nbins_x x nbins_y equal
+    // bins over the ranges of x and y; element (i, j) counts the pairs in x
+    // bin i and y bin j
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    matrix<boost::uint64_t> histogram2d (const vector_expression<E1> &x, const vector_expression<E2> &y,
+                                         int nbins_x = 10, int nbins_y = 10) {
+        typedef typename detail::paired_samples<E1, E2>::value_type value_type;
+
+        detail::paired_samples<E1, E2> samples (x (), y ());
+
+        assert (samples.size () > 0 && "Vector is empty.");
+
+        assert (nbins_x > 0 && nbins_y > 0 && "Number of bins should be positive.");
+
+        range_partial<typename E1::value_type> range_x (vector_reduce<range_partial<typename E1::value_type> > (x));
+        range_partial<typename E2::value_type> range_y (vector_reduce<range_partial<typename E2::value_type> > (y));
+        std::vector<detail::uniform_binner<value_type> > binners;
+        binners.push_back (detail::range_binner<value_type> (range_x.lo, range_x.hi, nbins_x));
+        binners.push_back (detail::range_binner<value_type> (range_y.lo, range_y.hi, nbins_y));
+
+        vector<boost::uint64_t> flat (detail::joint_histogram_counts (samples, binners));
+        matrix<boost::uint64_t> counts (nbins_x, nbins_y);
+        std::copy (flat.begin (), flat.end (), counts.data ().begin ());
+        return counts;
+    }
+
+    // Joint histogram of the pairs (x (i), y (i)) in the bins between
+    // consecutive x_edges and y_edges, binned as histogram (v, bin_edges).
+    // Pairs outside either set of edges are not counted.
+    template<class E1, class E2, class E3, class E4>
+    BOOST_UBLAS_INLINE
+    matrix<boost::uint64_t> histogram2d (const vector_expression<E1> &x, const vector_expression<E2> &y,
+                                         const vector_expression<E3> &x_edges, const vector_expression<E4> &y_edges) {
+        typedef typename detail::paired_samples<E1, E2>::value_type value_type;
+
+        detail::paired_samples<E1, E2> samples (x (), y ());
+
+        assert (samples.size () > 0 && "Vector is empty.");
+
+        assert (x_edges ().size () > 1 && y_edges ().size () > 1 && "Number of bins should be positive.");
+
+        std::vector<value_type> edges_x (x_edges ().begin (), x_edges ().end ());
+        std::vector<value_type> edges_y (y_edges ().begin (), y_edges ().end ());
+        for (std::size_t i = 0; i < edges_x.size () - 1; ++ i)
+            assert ((edges_x [i] < edges_x [i + 1]) && "Bin edges must be monotonically increasing.");
+        for (std::size_t i = 0; i < edges_y.size () - 1; ++ i)
+            assert ((edges_y [i] < edges_y [i + 1]) && "Bin edges must be monotonically increasing.");
+        std::vector<detail::edge_binner<value_type> > binners;
+        binners.push_back (detail::edge_binner<value_type> (edges_x));
+        binners.push_back (detail::edge_binner<value_type> (edges_y));
+
+        vector<boost::uint64_t> flat (detail::joint_histogram_counts (samples, binners));
+        matrix<boost::uint64_t> counts (edges_x.size () - 1, edges_y.size () - 1);
+        std::copy (flat.begin (), flat.end (), counts.data ().begin ());
+        return counts;
+    }
+
+    // Joint histogram of the rows of m as observations of m.size2 ()
+    // variables, with nbins equal bins over the range of every column. The
+    // nbins^size2 counts are flattened with the first variable slowest;
+    // bad_size is thrown when there are more than BOOST_UBLAS_HISTOGRAM_MAX_BINS.
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<boost::uint64_t> histogramdd (const matrix_expression<E> &m, int nbins = 10) {
+        typedef typename E::value_type value_type;
+        typedef typename E::size_type size_type;
+
+        size_type nobvs (m ().size1 ());
+        size_type nvars (m ().size2 ());
+
+        assert (nobvs > 0 && nvars > 0 && "Matrix is empty.");
+
+        assert (nbins > 0 && "Number of bins should be positive.");
+
+        std::vector<range_partial<value_type> > ranges (nvars);
+        std::vector<size_type> stored (nvars, size_type (0));
+        detail::axis_range_accumulator<value_type, size_type> range_acc (ranges, stored);
+        matrix_axis_reduce (m, size_type (0), range_acc);
+
+        std::vector<detail::uniform_binner<value_type> > binners;
+        binners.reserve (nvars);
+        for (size_type d = 0; d < nvars; ++ d) {
+            if (stored [d] < nobvs)
+                ranges [d].push (value_type (0));
+            binners.push_back (detail::range_binner (ranges [d].lo, ranges [d].hi, nbins));
         }
 
-        return bin_counts;
+        return detail::joint_histogram_counts (detail::matrix_samples<E> (m ()), binners);
     }
 
-}}}
\ No newline at end of file
+}}}
+
+#endif
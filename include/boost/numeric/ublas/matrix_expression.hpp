@@ -5571,6 +5571,8 @@ namespace boost { namespace numeric { namespace ublas {
         typedef F functor_type;
         typedef typename F::result_type value_type;
         typedef typename E::const_closure_type expression_closure_type;
+        typedef typename F::element_category element_category;
+        typedef typename E::storage_category storage_category;
 
         // Construction and destruction
         BOOST_UBLAS_INLINE
@@ -5587,10 +5589,34 @@ namespace boost { namespace numeric { namespace ublas {
     public:
         BOOST_UBLAS_INLINE
         operator value_type () const {
-            return functor_type::apply (e_);
+            return evaluate (element_category (), storage_category ());
         }
 
     private:
+        // Indexed specialization
+        template<class S>
+        BOOST_UBLAS_INLINE
+        value_type evaluate (indexed_elements_tag, S) const {
+            return functor_type::apply (e_);
+        }
+
+        // Dense and packed specialization
+        BOOST_UBLAS_INLINE
+        value_type evaluate (stored_elements_tag, packed_proxy_tag) const {
+            return functor_type::apply (e_);
+        }
+
+        // Sparse specialization
+        BOOST_UBLAS_INLINE
+        value_type evaluate (stored_elements_tag, sparse_proxy_tag) const {
+            return functor_type::apply_stored (e_);
+        }
+
+        BOOST_UBLAS_INLINE
+        value_type evaluate (stored_elements_tag, unknown_storage_tag) const {
+            return functor_type::apply (e_);
+        }
+
         expression_closure_type e_;
     };
 
@@ -5636,6 +5662,23 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e ());
     }
 
+    // sum (m, policy) of all elements, as sum (v, policy)
+    template<class E, class P>
+    BOOST_UBLAS_INLINE
+    typename matrix_summation<E, P>::result_type
+    sum (const matrix_expression<E> &e, const summation_policy<P> &) {
+        return matrix_summation<E, P>::apply (e);
+    }
+
+    // mean (m, policy) = sum (m, policy) / (size1 * size2)
+    template<class E, class P>
+    BOOST_UBLAS_INLINE
+    typename matrix_summation<E, P>::result_type
+    mean (const matrix_expression<E> &e, const summation_policy<P> &) {
+        typedef typename matrix_summation<E, P>::result_type result_type;
+        return matrix_summation<E, P>::apply (e) / result_type (e ().size1 () * e ().size2 ());
+    }
+
     template<class E>
     BOOST_UBLAS_INLINE
     typename matrix_scalar_unary_traits<E, matrix_variance<E> >::result_type
@@ -5660,6 +5703,30 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e ());
     }
 
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename matrix_quantile<E>::result_type
+    quantile (const matrix_expression<E> &e, double q, quantile_interpolation method = quantile_linear) {
+        return matrix_quantile<E>::apply (e, q, method);
+    }
+
+    template<class E, class Q>
+    BOOST_UBLAS_INLINE
+    vector<typename matrix_quantile<E>::result_type>
+    quantiles (const matrix_expression<E> &e, const vector_expression<Q> &q, quantile_interpolation method = quantile_linear) {
+        vector<typename matrix_quantile<E>::result_type> r;
+        matrix_quantile<E>::apply (e, q, method, r);
+        return r;
+    }
+
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename matrix_describe<E>::result_type
+    describe (const matrix_expression<E> &e) {
+        typedef typename matrix_scalar_unary_traits<E, matrix_describe<E> >::expression_type expression_type;
+        return expression_type (e ());
+    }
+
     template<class E>
     BOOST_UBLAS_INLINE
     typename matrix_scalar_unary_traits<E, matrix_norm_1<E> >::result_type
@@ -5684,396 +5751,298 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e ());
     }
 
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    min (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_min_axis<E, typename E::value_type>::apply (e, axis, r);
+        return r;
+    }
 
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    max (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_max_axis<E, typename E::value_type>::apply (e, axis, r);
+        return r;
+    }
 
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    sum (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_sum_axis<E, typename E::value_type>::apply (e, axis, r);
+        return r;
+    }
 
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    mean (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_mean_axis<E, typename E::value_type>::apply (e, axis, r);
+        return r;
+    }
 
-    template<class E, class F>
-    class matrix_vector_unary:
-        public vector_expression<matrix_vector_unary<E, F> > {
-    public:
-        typedef E expression_type;
-        typedef F functor_type;
-        typedef typename F::result_type value_type;
-        typedef typename E::const_closure_type expression_closure_type;
-
-    private:
-        typedef matrix_vector_unary<E, F> self_type;
-    public:
-#ifdef BOOST_UBLAS_ENABLE_PROXY_SHORTCUTS
-        using vector_expression<self_type>::operator ();
-#endif
-        static const unsigned complexity = 1;
-        typedef typename E::size_type size_type;
-        typedef typename E::difference_type difference_type;
-        typedef value_type const_reference;
-        typedef const_reference reference;
-        typedef const self_type const_closure_type;
-        typedef const_closure_type closure_type;
-        typedef unknown_storage_tag storage_category;
-
-        // Construction and destruction
-        BOOST_UBLAS_INLINE
-        explicit matrix_vector_unary (const expression_type &e, size_type axis):
-            e_ (e), axis_(axis) {}
-
-        // Accessors
-        BOOST_UBLAS_INLINE
-        size_type size () const {
-            if (axis_ == 0)
-                return e_.size2 ();
-            else if (axis_ == 1)
-                return e_.size1 ();
-        }
-
-    private:
-        // Expression accessors
-        BOOST_UBLAS_INLINE
-        const expression_closure_type &expression () const {
-            return e_;
-        }
-
-    public:
-        // Element access
-        BOOST_UBLAS_INLINE
-        typename F::result_type operator () (size_type i) const {
-            return functor_type::apply (e_, axis_, i);
-        }
-
-        // Closure comparison
-        BOOST_UBLAS_INLINE
-        bool same_closure (const matrix_vector_unary &mvu) const {
-            return (*this).expression ().same_closure (mvu.expression ());
-        }
-
-        // Iterator types
-    private:
-        typedef typename E::const_iterator1 const_subiterator1_type;
-        typedef typename E::const_iterator2 const_subiterator2_type;
-        typedef const value_type *const_pointer;
-
-    public:
-#ifdef BOOST_UBLAS_USE_INDEXED_ITERATOR
-        typedef indexed_const_iterator<const_closure_type, typename const_subiterator_type::iterator_category> const_iterator;
-        typedef const_iterator iterator;
-#else
-        class const_iterator;
-        typedef const_iterator iterator;
-#endif
-
-        // Element lookup
-        BOOST_UBLAS_INLINE
-        const_iterator find (size_type i) const {
-#ifdef BOOST_UBLAS_USE_INDEXED_ITERATOR
-            if (axis_ == 0) {
-                const_subiterator_type it (e_.find2 (0, 0, i));
-                return const_iterator (*this, it.index2 ());
-            }
-            else if (axis_ == 1) {
-                const_subiterator_type it (e_.find1 (0, i, 0));
-                return const_iterator (*this, it.index1 ());
-            }
-#else
-            if (axis_ == 0)
-                return const_iterator (*this, e_.find1 (0, 0, 0), e_.find2 (0, 0, i));
-            else if (axis_ == 1)
-                return const_iterator (*this, e_.find1 (0, i, 0), e_.find2 (0, 0, 0));
-#endif
-        }
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    variance (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_variance_axis<E, typename E::value_type>::apply (e, axis, r);
+        return r;
+    }
 
-#ifndef BOOST_UBLAS_USE_INDEXED_ITERATOR
-        class const_iterator:
-            public container_const_reference<matrix_vector_unary>,
-            public iterator_base_traits< typename E::const_iterator1::iterator_category>::template
-                iterator_base<const_iterator, value_type>::type {
-        public:
-            typedef typename E::const_iterator1::iterator_category iterator_category;
-            typedef typename matrix_vector_unary::size_type size_type;
-            typedef typename matrix_vector_unary::difference_type difference_type;
-            typedef typename matrix_vector_unary::value_type value_type;
-            typedef typename matrix_vector_unary::const_reference reference;
-            typedef typename matrix_vector_unary::const_pointer pointer;
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    mode (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_mode_axis<E, typename E::value_type>::apply (e, axis, r);
+        return r;
+    }
 
-//             // Construction and destruction
-            BOOST_UBLAS_INLINE
-            const_iterator ():
-                container_const_reference<self_type> (), it1_ (), it2_ () {}
-            BOOST_UBLAS_INLINE
-            // const_iterator (const self_type &mvu, const const_subiterator1_type &it1):
-            //     container_const_reference<self_type> (mvu), it1_ (it1), it2_ () {}
-            // const_iterator (const self_type &mvu, const const_subiterator2_type &it2):
-            //     container_const_reference<self_type> (mvu), it1_ (), it2_ (it2) {}
-            const_iterator (const self_type &mvu, const const_subiterator1_type &it1, const const_subiterator2_type &it2):
-                container_const_reference<self_type> (mvu), it1_ (it1), it2_ (it2) {}
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    median (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_median_axis<E, typename E::value_type>::apply (e, axis, r);
+        return r;
+    }
 
-        private:
-            // Dense random access specialization
-            BOOST_UBLAS_INLINE
-            value_type dereference (dense_random_access_iterator_tag) const {
-                const self_type &mvu = (*this) ();
-                size_type axis_ = mvu.axis ();
-#ifdef BOOST_UBLAS_USE_INDEXING
-                return mvu (index ());
-#elif BOOST_UBLAS_USE_ITERATING
-                difference_type size = difference_type (0);
-                if (axis_ == 0) {
-                    size = mvu.expression ().size1 ();
-                    return functor_type::apply (size, it2_.begin ());
-                }
-                else if (axis_ == 1) {
-                    size = mvu.expression ().size2 ();
-                    return functor_type::apply (size, it1_.begin ());
-                }
-#else
-                difference_type size = difference_type (0);
-                if (axis_ == 0)
-                    size = mvu.expression ().size1 ();
-                else if (axis_ == 1)
-                    size = mvu.expression ().size2 ();
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    quantile (const matrix_expression<E> &e, double q, typename E::size_type axis, quantile_interpolation method = quantile_linear) {
+        vector<typename E::value_type> r;
+        matrix_quantile_axis<E, typename E::value_type>::apply (e, q, axis, method, r);
+        return r;
+    }
 
-                if (size >= BOOST_UBLAS_ITERATOR_THRESHOLD)
-                    if (axis_ == 0)
-                        return functor_type::apply (size, it2_.begin ());
-                    else if (axis_ == 1)
-                        return functor_type::apply (size, it1_.begin ());
-                else
-                    return mvb (index ());
-#endif
-            }
+    // Row k holds quantile q (k) of every column (axis 0) or row (axis 1)
+    template<class E, class Q>
+    BOOST_UBLAS_INLINE
+    matrix<typename E::value_type>
+    quantiles (const matrix_expression<E> &e, const vector_expression<Q> &q, typename E::size_type axis, quantile_interpolation method = quantile_linear) {
+        matrix<typename E::value_type> r;
+        matrix_quantile_axis<E, typename E::value_type>::apply (e, q, axis, method, r);
+        return r;
+    }
 
-            // Packed bidirectional specialization
-            BOOST_UBLAS_INLINE
-            value_type dereference (packed_random_access_iterator_tag) const {
-                const self_type &mvu = (*this) ();
-                size_type axis_ = mvu.axis ();
-                if (axis_ == 0)
-                    return functor_type::apply (it2_.begin (), it2_.end ());
-                else if (axis_ == 1)
-                    return functor_type::apply (it1_.begin (), it1_.end ());
-            }
+    // mad (v) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    mad (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_robust_axis<E>::apply (e, axis, mad_statistic (), r);
+        return r;
+    }
 
-            // Sparse bidirectional specialization
-            BOOST_UBLAS_INLINE
-            value_type dereference (sparse_bidirectional_iterator_tag) const {
-                const self_type &mvu = (*this) ();
-                size_type axis_ = mvu.axis ();
-                if (axis_ == 0)
-                    return functor_type::apply (it2_.begin (), it2_.end (), sparse_bidirectional_iterator_tag ());
-                else if (axis_ == 1)
-                    return functor_type::apply (it1_.begin (), it1_.end (), sparse_bidirectional_iterator_tag ());
-            }
+    // iqr (v) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    iqr (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_robust_axis<E>::apply (e, axis, iqr_statistic (), r);
+        return r;
+    }
 
-        public:
-            // Arithmetic
-            BOOST_UBLAS_INLINE
-            const_iterator &operator ++ () {
-                ++ it2_;
-                ++ it1_;
-                return *this;
-            }
-            BOOST_UBLAS_INLINE
-            const_iterator &operator -- () {
-                -- it1_;
-                -- it2_;
-                return *this;
-            }
-            BOOST_UBLAS_INLINE
-            const_iterator &operator += (difference_type n) {
-                it1_ += n;
-                it2_ += n;
-                return *this;
-            }
-            BOOST_UBLAS_INLINE
-            const_iterator &operator -= (difference_type n) {
-                it1_ -= n;
-                it2_ -= n;
-                return *this;
-            }
-            BOOST_UBLAS_INLINE
-            difference_type operator - (const const_iterator &it) const {
-                BOOST_UBLAS_CHECK ((*this) ().same_closure (it ()), external_logic ());
-                const self_type &mvu = (*this) ();
-                size_type axis_ = mvu.axis ();
-                if (axis_ == 0)
-                    return it2_ - it.it2_;
-                else if (axis_ == 1)
-                    return it1_ - it.it1_;
-            }
+    // trimmed_mean (v, frac) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    trimmed_mean (const matrix_expression<E> &e, double frac, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_robust_axis<E>::apply (e, axis, trimmed_mean_statistic (frac), r);
+        return r;
+    }
 
-            // Dereference
-            BOOST_UBLAS_INLINE
-            const_reference operator * () const {
-                return dereference (iterator_category ());
-            }
-            BOOST_UBLAS_INLINE
-            const_reference operator [] (difference_type n) const {
-                return *(*this + n);
-            }
+    // winsorize (v, lo, hi) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    matrix<typename E::value_type>
+    winsorize (const matrix_expression<E> &e, double lo, double hi, typename E::size_type axis) {
+        matrix<typename E::value_type> r;
+        matrix_winsorize_axis<E>::apply (e, lo, hi, axis, r);
+        return r;
+    }
 
-            // Index
-            BOOST_UBLAS_INLINE
-            size_type index () const {
-                const self_type &mvu = (*this) ();
-                size_type axis_ = mvu.axis ();
-                if (axis_ == 0)
-                    return it2_.index2 ();
-                else if (axis_ == 1)
-                    return it1_.index1 ();
-            }
+    // nanmean (v) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    nanmean (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_nan_moment_axis<E, nan_mean_tag>::apply (e, axis, r);
+        return r;
+    }
 
-            // Assignment
-            BOOST_UBLAS_INLINE
-            const_iterator &operator = (const const_iterator &it) {
-                container_const_reference<self_type>::assign (&it ());
-                it1_ = it.it1_;
-                it2_ = it.it2_;
-                return *this;
-            }
+    // nanvar (v) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    nanvar (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_nan_moment_axis<E, nan_variance_tag>::apply (e, axis, r);
+        return r;
+    }
 
-            // Comparison
-            BOOST_UBLAS_INLINE
-            bool operator == (const const_iterator &it) const {
-                BOOST_UBLAS_CHECK ((*this) ().same_closure (it ()), external_logic ());
-                const self_type &mvu = (*this) ();
-                size_type axis_ = mvu.axis ();
-                if (axis_ == 0)
-                    return (it2_ == it.it2_);
-                else if (axis_ == 1)
-                    return (it1_ == it.it1_);
-            }
-            BOOST_UBLAS_INLINE
-            bool operator < (const const_iterator &it) const {
-                BOOST_UBLAS_CHECK ((*this) ().same_closure (it ()), external_logic ());
-                const self_type &mvu = (*this) ();
-                size_type axis_ = mvu.axis ();
-                if (axis_ == 0)
-                    return it2_ < it.it2_;
-                else if (axis_ == 1)
-                    return it1_ < it.it1_;
-            }
+    // nanmin (v) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    nanmin (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_nan_extremum_axis<E, std::greater<typename type_traits<typename E::value_type>::real_type> >::apply (e, axis, r);
+        return r;
+    }
 
-        private:
-            const_subiterator1_type it1_;
-            const_subiterator2_type it2_;
-        };
-#endif
+    // nanmax (v) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    nanmax (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_nan_extremum_axis<E, std::less<typename type_traits<typename E::value_type>::real_type> >::apply (e, axis, r);
+        return r;
+    }
 
-        BOOST_UBLAS_INLINE
-        const_iterator begin () const {
-            return find (0);
-        }
-        BOOST_UBLAS_INLINE
-        const_iterator cbegin () const {
-            return begin ();
-        }
-        BOOST_UBLAS_INLINE
-        const_iterator end () const {
-            return find (size ()); 
-        }
-        BOOST_UBLAS_INLINE
-        const_iterator cend () const {
-            return end ();
-        }
+    // nanmedian (v) of every column (axis 0) or row (axis 1)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    nanmedian (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_nanmedian_axis<E>::apply (e, axis, r);
+        return r;
+    }
 
-        // Reverse iterator
-        typedef reverse_iterator_base<const_iterator> const_reverse_iterator;
+    // center (m, axis) subtracts the mean (v) of every column (axis 0) or row
+    // (axis 1) from it, in place. The transforms take dense and sparse
+    // matrices; packed ones are rejected at compile time
+    template<class E>
+    BOOST_UBLAS_INLINE
+    void center (matrix_expression<E> &e, typename E::size_type axis) {
+        matrix_transform_axis<E>::apply (e, axis, center_transform_tag ());
+    }
 
-        BOOST_UBLAS_INLINE
-        const_reverse_iterator rbegin () const {
-            return const_reverse_iterator (end ());
-        }
-        BOOST_UBLAS_INLINE
-        const_reverse_iterator crbegin () const {
-            return rbegin ();
-        }
-        BOOST_UBLAS_INLINE
-        const_reverse_iterator rend () const {
-            return const_reverse_iterator (begin ());
-        }
-        BOOST_UBLAS_INLINE
-        const_reverse_iterator crend () const {
-            return rend ();
-        }
+    // zscore (m, axis) replaces every column (axis 0) or row (axis 1) v by
+    // (v - mean (v)) / sqrt (variance (v)), in place; constant slices become zeros
+    template<class E>
+    BOOST_UBLAS_INLINE
+    void zscore (matrix_expression<E> &e, typename E::size_type axis) {
+        matrix_transform_axis<E>::apply (e, axis, zscore_transform_tag ());
+    }
 
-    public:
-        BOOST_UBLAS_INLINE
-        size_type axis () const {
-            return axis_;
-        }    
-    //     BOOST_UBLAS_INLINE
-    //     operator value_type () const {
-    //         return functor_type::apply (e_, axis_);
-    //     }
+    // min_max_scale (m, axis) maps every column (axis 0) or row (axis 1) onto
+    // [0, 1] by its smallest and largest element by value, in place; constant
+    // slices become zeros
+    template<class E>
+    BOOST_UBLAS_INLINE
+    void min_max_scale (matrix_expression<E> &e, typename E::size_type axis) {
+        matrix_transform_axis<E>::apply (e, axis, min_max_transform_tag ());
+    }
 
-    private:
-        expression_closure_type e_;
-        size_type axis_;
-    };
+    // skewness (m) of all elements, as skewness (v)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename E::value_type
+    skewness (const matrix_expression<E> &e) {
+        return matrix_higher_moment<E, skewness_tag>::apply (e);
+    }
 
-    template<class E, class F>
-    struct matrix_vector_unary_traits {
-        typedef matrix_vector_unary<E, F> expression_type;
-#ifndef BOOST_UBLAS_SIMPLE_ET_DEBUG
-        typedef expression_type result_type;
-#else
-        typedef typename F::result_type result_type;
-#endif
-    };
+    // kurtosis (m) of all elements, as kurtosis (v)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename E::value_type
+    kurtosis (const matrix_expression<E> &e) {
+        return matrix_higher_moment<E, kurtosis_tag>::apply (e);
+    }
 
+    // moment (m, k) of all elements, as moment (v, k)
     template<class E>
     BOOST_UBLAS_INLINE
-    typename matrix_vector_unary_traits<E, matrix_min_axis<E, typename E::value_type> >::result_type
-    min (const matrix_expression<E> &e, typename E::size_type axis) {
-        typedef typename matrix_vector_unary_traits<E, matrix_min_axis<E, typename E::value_type> >::expression_type expression_type;
-        return expression_type (e (), axis);
+    typename E::value_type
+    moment (const matrix_expression<E> &e, typename E::size_type k) {
+        return matrix_moment<E>::apply (e, k);
     }
 
     template<class E>
     BOOST_UBLAS_INLINE
-    typename matrix_vector_unary_traits<E, matrix_max_axis<E, typename E::value_type> >::result_type
-    max (const matrix_expression<E> &e, typename E::size_type axis) {
-        typedef typename matrix_vector_unary_traits<E, matrix_max_axis<E, typename E::value_type> >::expression_type expression_type;
-        return expression_type (e (), axis);
+    vector<typename E::value_type>
+    skewness (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_higher_moment_axis<E, typename E::value_type, skewness_tag>::apply (e, axis, r);
+        return r;
     }
 
     template<class E>
     BOOST_UBLAS_INLINE
-    typename matrix_vector_unary_traits<E, matrix_sum_axis<E, typename E::value_type> >::result_type
-    sum (const matrix_expression<E> &e, typename E::size_type axis) {
-        typedef typename matrix_vector_unary_traits<E, matrix_sum_axis<E, typename E::value_type> >::expression_type expression_type;
-        return expression_type (e (), axis);
+    vector<typename E::value_type>
+    kurtosis (const matrix_expression<E> &e, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_higher_moment_axis<E, typename E::value_type, kurtosis_tag>::apply (e, axis, r);
+        return r;
     }
 
     template<class E>
     BOOST_UBLAS_INLINE
-    typename matrix_vector_unary_traits<E, matrix_mean_axis<E, typename E::value_type> >::result_type
-    mean (const matrix_expression<E> &e, typename E::size_type axis) {
-        typedef typename matrix_vector_unary_traits<E, matrix_mean_axis<E, typename E::value_type> >::expression_type expression_type;
-        return expression_type (e (), axis);
+    vector<typename E::value_type>
+    moment (const matrix_expression<E> &e, typename E::size_type k, typename E::size_type axis) {
+        vector<typename E::value_type> r;
+        matrix_moment_axis<E>::apply (e, k, axis, r);
+        return r;
     }
 
+    // ewm_mean (v, alpha) of every column (axis 0) or row (axis 1)
     template<class E>
     BOOST_UBLAS_INLINE
-    typename matrix_vector_unary_traits<E, matrix_variance_axis<E, typename E::value_type> >::result_type
-    variance (const matrix_expression<E> &e, typename E::size_type axis) {
-        typedef typename matrix_vector_unary_traits<E, matrix_variance_axis<E, typename E::value_type> >::expression_type expression_type;
-        return expression_type (e (), axis);
+    matrix<typename E::value_type>
+    ewm_mean (const matrix_expression<E> &e, typename E::value_type alpha, typename E::size_type axis) {
+        matrix<typename E::value_type> r;
+        matrix_ewm_axis<E, ewm_mean_tag>::apply (e, alpha, axis, r);
+        return r;
     }
 
+    // ewm_var (v, alpha) of every column (axis 0) or row (axis 1)
     template<class E>
     BOOST_UBLAS_INLINE
-    typename matrix_vector_unary_traits<E, matrix_mode_axis<E, typename E::value_type> >::result_type
-    mode (const matrix_expression<E> &e, typename E::size_type axis) {
-        typedef typename matrix_vector_unary_traits<E, matrix_mode_axis<E, typename E::value_type> >::expression_type expression_type;
-        return expression_type (e (), axis);
+    matrix<typename E::value_type>
+    ewm_var (const matrix_expression<E> &e, typename E::value_type alpha, typename E::size_type axis) {
+        matrix<typename E::value_type> r;
+        matrix_ewm_axis<E, ewm_variance_tag>::apply (e, alpha, axis, r);
+        return r;
+    }
+
+    // group_reduce (m, index, op) (k, j) = op of the m (i, j) over the rows i in group k of index
+    template<class E, class K, class Tag>
+    BOOST_UBLAS_INLINE
+    matrix<typename E::value_type>
+    group_reduce (const matrix_expression<E> &e, const group_index<K> &index, Tag) {
+        matrix<typename E::value_type> r;
+        matrix_group_reduce<E, Tag>::apply (e, index, r);
+        return r;
+    }
+
+    // group_reduce (m, keys, op) (k, j) = op of the m (i, j) over the rows whose keys [i] is the k-th smallest distinct key
+    template<class E, class EK, class Tag>
+    BOOST_UBLAS_INLINE
+    matrix<typename E::value_type>
+    group_reduce (const matrix_expression<E> &e, const vector_expression<EK> &keys, Tag op) {
+        return group_reduce (e, group_index<typename EK::value_type> (keys), op);
     }
 
     template<class E>
     BOOST_UBLAS_INLINE
-    typename matrix_vector_unary_traits<E, matrix_median_axis<E, typename E::value_type> >::result_type
-    median (const matrix_expression<E> &e, typename E::size_type axis) {
-        typedef typename matrix_vector_unary_traits<E, matrix_median_axis<E, typename E::value_type> >::expression_type expression_type;
-        return expression_type (e (), axis);
+    typename matrix_describe_axis<E>::result_type
+    describe (const matrix_expression<E> &e, typename E::size_type axis) {
+        return matrix_describe_axis<E>::apply (e, axis);
     }
 
 
@@ -0,0 +1,273 @@
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_QUANTILE_SKETCH_
+#define _BOOST_UBLAS_QUANTILE_SKETCH_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+namespace boost { namespace numeric { namespace ublas {
+
+    // Bounded memory quantile estimates of a stream of floating point values
+    // (a merging t-digest). Values are buffered and periodically merged into
+    // at most about compression () weighted centroids, which stay small near
+    // the ends of the distribution. The estimate interpolates linearly within
+    // a centroid, so the rank error depends on the shape of the data as well:
+    // with the default compression of 100 and a million values it stays
+    // below 4e-4 for uniform data but reaches about 1e-3 for strongly skewed
+    // data, in the tails as well as around the median. Successive merges
+    // alternate in direction, so neither end of the distribution is favored.
+    // Values are ordered by value, so for non-negative data quantile (q)
+    // estimates quantile (v, q); as long as no centroids have been merged the
+    // estimate is exact. NaNs are skipped. Const access never modifies the
+    // sketch, so several threads may query one sketch at once: a const query
+    // with values still buffered merges them into a copy. Non-const queries
+    // and flush () merge the buffer in place.
+    template<class T>
+    class quantile_sketch {
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit quantile_sketch (value_type compression = value_type (100)):
+            compression_ (compression), count_ (0), min_ (0), max_ (0), descending_ (false) {
+            BOOST_UBLAS_CHECK (compression > value_type (0), bad_argument ());
+            buffer_.reserve (buffer_limit ());
+        }
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            if (x != x)
+                return;
+            if (count_ == 0 || x < min_)
+                min_ = x;
+            if (count_ == 0 || x > max_)
+                max_ = x;
+            ++ count_;
+            buffer_.push_back (centroid (x, size_type (1)));
+            if (buffer_.size () >= buffer_limit ())
+                compress ();
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            for (vector_size_type i = 0; i < size; ++ i)
+                push (e () (i));
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push (const matrix_expression<E> &e) {
+            typedef typename E::size_type matrix_size_type;
+            for (matrix_size_type i = 0; i < e ().size1 (); ++ i)
+                for (matrix_size_type j = 0; j < e ().size2 (); ++ j)
+                    push (e () (i, j));
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const quantile_sketch &s) {
+            if (s.count_ == 0)
+                return;
+            if (count_ == 0 || s.min_ < min_)
+                min_ = s.min_;
+            if (count_ == 0 || s.max_ > max_)
+                max_ = s.max_;
+            count_ += s.count_;
+            buffer_.insert (buffer_.end (), s.centroids_.begin (), s.centroids_.end ());
+            buffer_.insert (buffer_.end (), s.buffer_.begin (), s.buffer_.end ());
+            compress ();
+        }
+        BOOST_UBLAS_INLINE
+        void clear () {
+            count_ = 0;
+            centroids_.clear ();
+            buffer_.clear ();
+        }
+
+        BOOST_UBLAS_INLINE
+        value_type compression () const {
+            return compression_;
+        }
+        BOOST_UBLAS_INLINE
+        size_type count () const {
+            return count_;
+        }
+        // Number of centroids kept
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            if (! buffer_.empty ())
+                return flushed ().size ();
+            return centroids_.size ();
+        }
+        BOOST_UBLAS_INLINE
+        size_type size () {
+            flush ();
+            return centroids_.size ();
+        }
+
+        // Merge the buffered values into the centroids
+        BOOST_UBLAS_INLINE
+        void flush () {
+            compress ();
+        }
+
+        // Estimate of the q-quantile, linearly interpolated as quantile_linear
+        // between the centroid means placed at the middle of their ranks; 0
+        // for an empty sketch
+        BOOST_UBLAS_INLINE
+        value_type quantile (const value_type &q) const {
+            if (! buffer_.empty ())
+                return flushed ().estimate (q);
+            return estimate (q);
+        }
+        BOOST_UBLAS_INLINE
+        value_type quantile (const value_type &q) {
+            flush ();
+            return estimate (q);
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        vector<value_type> quantiles (const vector_expression<E> &q) const {
+            if (! buffer_.empty ())
+                return flushed ().estimates (q);
+            return estimates (q);
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        vector<value_type> quantiles (const vector_expression<E> &q) {
+            flush ();
+            return estimates (q);
+        }
+
+    private:
+        typedef std::pair<value_type, size_type> centroid;
+
+        // Copy with the buffer merged, for const queries
+        BOOST_UBLAS_INLINE
+        quantile_sketch flushed () const {
+            quantile_sketch s (*this);
+            s.compress ();
+            return s;
+        }
+
+        // quantile (q) and quantiles (q) of a sketch with an empty buffer
+        BOOST_UBLAS_INLINE
+        value_type estimate (const value_type &q) const {
+            BOOST_UBLAS_CHECK (q >= value_type (0) && q <= value_type (1), bad_argument ());
+            if (count_ == 0)
+                return value_type (0);
+            value_type index (q * value_type (count_ - 1) + value_type (0.5));
+            value_type left_rank (0.5);
+            value_type left (min_);
+            value_type rank (0);
+            for (size_type i = 0; i < centroids_.size (); ++ i) {
+                value_type weight (centroids_ [i].second);
+                value_type center (rank + weight / 2);
+                if (index <= center)
+                    return interpolate (left_rank, left, center, centroids_ [i].first, index);
+                left_rank = center;
+                left = centroids_ [i].first;
+                rank += weight;
+            }
+            return interpolate (left_rank, left, value_type (count_) - value_type (0.5), max_, index);
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        vector<value_type> estimates (const vector_expression<E> &q) const {
+            typedef typename E::size_type vector_size_type;
+            vector<value_type> r (q ().size ());
+            for (vector_size_type i = 0; i < q ().size (); ++ i)
+                r (i) = estimate (q () (i));
+            return r;
+        }
+
+        BOOST_UBLAS_INLINE
+        static bool mean_less (const centroid &a, const centroid &b) {
+            return a.first < b.first;
+        }
+        BOOST_UBLAS_INLINE
+        static bool mean_greater (const centroid &a, const centroid &b) {
+            return b.first < a.first;
+        }
+        BOOST_UBLAS_INLINE
+        static value_type interpolate (const value_type &r1, const value_type &x1,
+                                       const value_type &r2, const value_type &x2, const value_type &r) {
+            if (r2 <= r1)
+                return x2;
+            return x1 + (x2 - x1) * ((r - r1) / (r2 - r1));
+        }
+
+        BOOST_UBLAS_INLINE
+        size_type buffer_limit () const {
+            return size_type (5 * compression_) + 10;
+        }
+
+        // Scale function k (q) = compression / (2 pi) asin (2 q - 1) and its
+        // inverse: a centroid spans at most one unit of k
+        BOOST_UBLAS_INLINE
+        value_type rank_limit (const value_type &q) const {
+            const value_type pi (boost::math::constants::pi<value_type> ());
+            value_type k (compression_ / (2 * pi) * std::asin (2 * q - 1) + 1);
+            if (k >= compression_ / 4)
+                return value_type (1);
+            return (std::sin (k * 2 * pi / compression_) + 1) / 2;
+        }
+
+        // Merge the buffer and the centroids in one sorted pass. Successive
+        // passes alternate between ascending and descending order, so the
+        // greedy merging does not favor one end of the distribution.
+        BOOST_UBLAS_INLINE
+        void compress () {
+            if (buffer_.empty ())
+                return;
+            buffer_.insert (buffer_.end (), centroids_.begin (), centroids_.end ());
+            std::sort (buffer_.begin (), buffer_.end (), descending_ ? mean_greater : mean_less);
+            centroids_.clear ();
+            value_type total (count_);
+            centroid current (buffer_ [0]);
+            value_type before (0);
+            value_type limit (rank_limit (value_type (0)));
+            for (size_type i = 1; i < buffer_.size (); ++ i) {
+                size_type weight (current.second + buffer_ [i].second);
+                if ((before + value_type (weight)) / total <= limit) {
+                    current.first += (buffer_ [i].first - current.first) * value_type (buffer_ [i].second) / value_type (weight);
+                    current.second = weight;
+                }
+                else {
+                    centroids_.push_back (current);
+                    before += value_type (current.second);
+                    limit = rank_limit (before / total);
+                    current = buffer_ [i];
+                }
+            }
+            centroids_.push_back (current);
+            if (descending_)
+                std::reverse (centroids_.begin (), centroids_.end ());
+            descending_ = ! descending_;
+            buffer_.clear ();
+        }
+
+        value_type compression_;
+        size_type count_;
+        value_type min_;
+        value_type max_;
+        std::vector<centroid> centroids_;
+        std::vector<centroid> buffer_;
+        bool descending_;
+    };
+
+}}}
+
+#endif
@@ -0,0 +1,279 @@
+//
+//  Distributed under the Boost Software License, Version 1.0. (See
+//  accompanying file LICENSE_1_0.txt or copy at
+//  http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef _BOOST_UBLAS_RUNNING_STATS_
+#define _BOOST_UBLAS_RUNNING_STATS_
+
+#include <cstddef>
+#include <functional>
+
+#include <boost/numeric/ublas/covariance_matrix.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/symmetric.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+namespace boost { namespace numeric { namespace ublas {
+
+    // Count, mean, variance, min and max of a stream of values, updated one
+    // value or one expression at a time without keeping the values. min and
+    // max follow the magnitude ordering of min (v) and max (v). Two streams
+    // are combined with merge, so partial results of micro-batches or threads
+    // can be summed up. Every statistic is available in O(1).
+    template<class T>
+    class running_stats {
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+
+        BOOST_UBLAS_INLINE
+        running_stats () {}
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            moments_.push (x);
+            min_.push (x);
+            max_.push (x);
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push (const vector_expression<E> &e) {
+            merge (vector_reduce<running_stats> (e));
+        }
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push (const matrix_expression<E> &e) {
+            merge (matrix_reduce<running_stats> (e));
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const running_stats &s) {
+            moments_.merge (s.moments_);
+            min_.merge (s.min_);
+            max_.merge (s.max_);
+        }
+        template<class U>
+        BOOST_UBLAS_INLINE
+        void push_range (const U *first, const U *last) {
+            for (; first != last; ++ first)
+                push (*first);
+        }
+#ifdef BOOST_UBLAS_USE_SIMD
+        BOOST_UBLAS_INLINE
+        void push_range (const value_type *first, const value_type *last) {
+            moments_.push_range (first, last);
+            min_.push_range (first, last);
+            max_.push_range (first, last);
+        }
+#endif
+        BOOST_UBLAS_INLINE
+        void clear () {
+            *this = running_stats ();
+        }
+
+        BOOST_UBLAS_INLINE
+        size_type count () const {
+            return moments_.count;
+        }
+        BOOST_UBLAS_INLINE
+        value_type sum () const {
+            return moments_.mean * value_type (moments_.count);
+        }
+        BOOST_UBLAS_INLINE
+        value_type mean () const {
+            return moments_.mean;
+        }
+        // Sum of squared deviations divided by count () - ddof
+        BOOST_UBLAS_INLINE
+        value_type variance (size_type ddof = 0) const {
+            if (moments_.count <= ddof)
+                return value_type (0);
+            return moments_.m2 / value_type (moments_.count - ddof);
+        }
+        BOOST_UBLAS_INLINE
+        value_type min () const {
+            return min_.value;
+        }
+        BOOST_UBLAS_INLINE
+        value_type max () const {
+            return max_.value;
+        }
+
+    private:
+        moments_partial<value_type, size_type> moments_;
+        extremum_partial<value_type, std::greater<value_type> > min_;
+        extremum_partial<value_type, std::less<value_type> > max_;
+    };
+
+    // Exponentially weighted mean and variance of a live stream, as the
+    // last elements of ewm_mean (v, alpha) and ewm_var (v, alpha) over all
+    // values pushed so far. Each update is O(1) and allocation free.
+    template<class T>
+    class ewm_stats {
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+
+        BOOST_UBLAS_INLINE
+        explicit ewm_stats (value_type alpha):
+            moments_ (alpha), count_ (0) {
+            BOOST_UBLAS_CHECK (alpha > value_type (0) && alpha <= value_type (1), bad_argument ());
+        }
+
+        BOOST_UBLAS_INLINE
+        void push (const value_type &x) {
+            moments_.push (x);
+            ++ count_;
+        }
+        // Push the elements of e in order
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push (const vector_expression<E> &e) {
+            typedef typename E::size_type vector_size_type;
+            vector_size_type size (e ().size ());
+            for (vector_size_type i = 0; i < size; ++ i)
+                push (e () (i));
+        }
+        BOOST_UBLAS_INLINE
+        void clear () {
+            *this = ewm_stats (moments_.alpha);
+        }
+
+        BOOST_UBLAS_INLINE
+        value_type alpha () const {
+            return moments_.alpha;
+        }
+        BOOST_UBLAS_INLINE
+        size_type count () const {
+            return count_;
+        }
+        BOOST_UBLAS_INLINE
+        value_type mean () const {
+            return moments_.mean;
+        }
+        BOOST_UBLAS_INLINE
+        value_type variance () const {
+            return moments_.var;
+        }
+
+    private:
+        ewm_moments<value_type> moments_;
+        size_type count_;
+    };
+
+    // Count, means and covariance matrix of a stream of observations of
+    // size () variables. Single observations are added by an outer product
+    // Welford update, batches through the blocked scatter kernel of
+    // covariance_matrix, and streams are combined by Chan's pairwise update.
+    template<class T>
+    class running_covariance {
+    public:
+        typedef T value_type;
+        typedef std::size_t size_type;
+        typedef vector<value_type> vector_type;
+        typedef symmetric_matrix<value_type, lower> matrix_type;
+
+        // The number of variables is taken from the first observation when
+        // it is not given
+        BOOST_UBLAS_INLINE
+        explicit running_covariance (size_type nvars = 0):
+            count_ (0), mean_ (nvars), comoment_ (nvars) {
+            mean_.clear ();
+            comoment_.clear ();
+        }
+
+        // Add one observation
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push (const vector_expression<E> &e) {
+            adopt_size (e ().size ());
+            size_type nvars (mean_.size ());
+            ++ count_;
+            vector_type x (e);
+            vector_type del (x - mean_);
+            mean_ += del / value_type (count_);
+            for (size_type i = 0; i < nvars; ++ i) {
+                value_type di (x (i) - mean_ (i));
+                for (size_type j = 0; j <= i; ++ j)
+                    comoment_ (i, j) += di * del (j);
+            }
+        }
+        // Add a batch of observations, the columns of e (rowvar) or its rows
+        template<class E>
+        BOOST_UBLAS_INLINE
+        void push (const matrix_expression<E> &e, bool rowvar = true) {
+            running_covariance batch;
+            batch.count_ = detail::scatter_matrix (e (), rowvar, batch.comoment_, batch.mean_);
+            if (batch.count_ != 0)
+                merge (batch);
+        }
+        BOOST_UBLAS_INLINE
+        void merge (const running_covariance &c) {
+            if (c.count_ == 0)
+                return;
+            if (count_ == 0) {
+                *this = c;
+                return;
+            }
+            BOOST_UBLAS_CHECK (mean_.size () == c.mean_.size (), bad_size ());
+            size_type nvars (mean_.size ());
+            size_type n (count_ + c.count_);
+            value_type w (value_type (count_) * value_type (c.count_) / value_type (n));
+            vector_type del (c.mean_ - mean_);
+            for (size_type i = 0; i < nvars; ++ i)
+                for (size_type j = 0; j <= i; ++ j)
+                    comoment_ (i, j) += c.comoment_ (i, j) + del (i) * del (j) * w;
+            mean_ += del * (value_type (c.count_) / value_type (n));
+            count_ = n;
+        }
+        BOOST_UBLAS_INLINE
+        void clear () {
+            count_ = 0;
+            mean_.clear ();
+            comoment_.clear ();
+        }
+
+        BOOST_UBLAS_INLINE
+        size_type size () const {
+            return mean_.size ();
+        }
+        BOOST_UBLAS_INLINE
+        size_type count () const {
+            return count_;
+        }
+        BOOST_UBLAS_INLINE
+        const vector_type &mean () const {
+            return mean_;
+        }
+        // Sums of products of deviations divided by count () - ddof
+        BOOST_UBLAS_INLINE
+        matrix_type covariance (size_type ddof = 0) const {
+            matrix_type cov (comoment_);
+            if (count_ > ddof)
+                cov /= value_type (count_ - ddof);
+            else
+                cov.clear ();
+            return cov;
+        }
+
+    private:
+        BOOST_UBLAS_INLINE
+        void adopt_size (size_type nvars) {
+            if (count_ == 0 && mean_.size () != nvars) {
+                mean_.resize (nvars, false);
+                mean_.clear ();
+                comoment_.resize (nvars, false);
+                comoment_.clear ();
+            }
+            BOOST_UBLAS_CHECK (mean_.size () == nvars, bad_size ());
+        }
+
+        size_type count_;
+        vector_type mean_;
+        matrix_type comoment_;
+    };
+
+}}}
+
+#endif
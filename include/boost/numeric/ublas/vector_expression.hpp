@@ -1616,6 +1616,32 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e ());
     }
 
+    // sum (v, policy) = sum (v [i]) accumulated under a summation policy:
+    // naive_summation<A>, pairwise_summation<A> or compensated_summation<A>
+    template<class E, class P>
+    BOOST_UBLAS_INLINE
+    typename vector_summation<E, P>::result_type
+    sum (const vector_expression<E> &e, const summation_policy<P> &) {
+        return vector_summation<E, P>::apply (e);
+    }
+
+    // mean (v, policy) = sum (v, policy) / size
+    template<class E, class P>
+    BOOST_UBLAS_INLINE
+    typename vector_summation<E, P>::result_type
+    mean (const vector_expression<E> &e, const summation_policy<P> &) {
+        typedef typename vector_summation<E, P>::result_type result_type;
+        return vector_summation<E, P>::apply (e) / result_type (e ().size ());
+    }
+
+    // mean (v, w) = sum (w [i] v [i]) / sum (w [i]) in one traversal
+    template<class E, class W>
+    BOOST_UBLAS_INLINE
+    typename vector_weighted_mean<E>::result_type
+    mean (const vector_expression<E> &e, const vector_expression<W> &w) {
+        return vector_weighted_mean<E>::apply (e, w);
+    }
+
     // mean v - iterative mean
     template<class E>
     BOOST_UBLAS_INLINE
@@ -1634,6 +1660,14 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e ());
     }
 
+    // variance (v, w) = sum (w [i] (v [i] - mean (v, w))^2) / sum (w [i]) in one traversal
+    template<class E, class W>
+    BOOST_UBLAS_INLINE
+    typename vector_weighted_variance<E>::result_type
+    variance (const vector_expression<E> &e, const vector_expression<W> &w) {
+        return vector_weighted_variance<E>::apply (e, w);
+    }
+
     // variance v = variance (v [i])
     template<class E>
     BOOST_UBLAS_INLINE
@@ -1661,6 +1695,168 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e ());
     }
 
+    // median v by selection on a caller-owned container; reorders v
+    template<class C>
+    BOOST_UBLAS_INLINE
+    typename C::value_type
+    median_inplace (vector_container<C> &c) {
+        return select_median (c ().begin (), c ().end (), vector_median<C>::compareElement);
+    }
+
+    // quantile v = order statistic of v [i] at rank (size - 1) q, interpolated by method
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_quantile<E>::result_type
+    quantile (const vector_expression<E> &e, double q, quantile_interpolation method = quantile_linear) {
+        return vector_quantile<E>::apply (e, q, method);
+    }
+
+    // quantiles v = (quantile (v, q [k])) from a single selection pass
+    template<class E, class Q>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_quantile<E>::result_type>
+    quantiles (const vector_expression<E> &e, const vector_expression<Q> &q, quantile_interpolation method = quantile_linear) {
+        vector<typename vector_quantile<E>::result_type> r;
+        vector_quantile<E>::apply (e, q, method, r);
+        return r;
+    }
+
+    // quantile (v, w, q) = first v [i] in magnitude order whose cumulative weight reaches q sum (w [i])
+    template<class E, class W>
+    BOOST_UBLAS_INLINE
+    typename vector_weighted_quantile<E>::result_type
+    quantile (const vector_expression<E> &e, const vector_expression<W> &w, double q) {
+        return vector_weighted_quantile<E>::apply (e, w, q);
+    }
+
+    // mad v = median (|v [i] - median (v)|) under the ordering by value, unscaled
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_robust<E>::result_type
+    mad (const vector_expression<E> &e) {
+        return vector_robust<E>::apply (e, mad_statistic ());
+    }
+
+    // iqr v = linear 0.75 quantile - linear 0.25 quantile under the ordering by value
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_robust<E>::result_type
+    iqr (const vector_expression<E> &e) {
+        return vector_robust<E>::apply (e, iqr_statistic ());
+    }
+
+    // trimmed_mean (v, frac) = mean of v without its floor (frac size) smallest and largest elements
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_robust<E>::result_type
+    trimmed_mean (const vector_expression<E> &e, double frac) {
+        return vector_robust<E>::apply (e, trimmed_mean_statistic (frac));
+    }
+
+    // winsorize (v, lo, hi) = v with its floor (lo size) smallest and floor (hi size) largest
+    // elements replaced by the nearest remaining ones
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_winsorize<E>::result_type>
+    winsorize (const vector_expression<E> &e, double lo, double hi) {
+        vector<typename vector_winsorize<E>::result_type> r;
+        vector_winsorize<E>::apply (e, lo, hi, r);
+        return r;
+    }
+
+    // nanmean v = mean of the v [i] that are not NaN, NaN if there are none
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_nan_moment<E, nan_mean_tag>::result_type
+    nanmean (const vector_expression<E> &e) {
+        return vector_nan_moment<E, nan_mean_tag>::apply (e);
+    }
+
+    // nanvar v = variance of the v [i] that are not NaN, NaN if there are none
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_nan_moment<E, nan_variance_tag>::result_type
+    nanvar (const vector_expression<E> &e) {
+        return vector_nan_moment<E, nan_variance_tag>::apply (e);
+    }
+
+    // nanmin v = min of the v [i] that are not NaN, NaN if there are none
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_nan_extremum<E, std::greater<typename type_traits<typename E::value_type>::real_type> >::result_type
+    nanmin (const vector_expression<E> &e) {
+        return vector_nan_extremum<E, std::greater<typename type_traits<typename E::value_type>::real_type> >::apply (e);
+    }
+
+    // nanmax v = max of the v [i] that are not NaN, NaN if there are none
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_nan_extremum<E, std::less<typename type_traits<typename E::value_type>::real_type> >::result_type
+    nanmax (const vector_expression<E> &e) {
+        return vector_nan_extremum<E, std::less<typename type_traits<typename E::value_type>::real_type> >::apply (e);
+    }
+
+    // nanmedian v = median of the v [i] that are not NaN, NaN if there are none
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_nanmedian<E>::result_type
+    nanmedian (const vector_expression<E> &e) {
+        return vector_nanmedian<E>::apply (e);
+    }
+
+    // describe v = (count, mean, variance, min, max, median, mode) of v [i] in one pass
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename vector_describe<E>::result_type
+    describe (const vector_expression<E> &e) {
+        typedef typename vector_scalar_unary_traits<E, vector_describe<E> >::expression_type expression_type;
+        return expression_type (e ());
+    }
+
+    // skewness v = m3 / m2^(3/2), mk = sum ((v [i] - mean)^k) / size
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename E::value_type
+    skewness (const vector_expression<E> &e) {
+        return vector_higher_moment<E, skewness_tag>::apply (e);
+    }
+
+    // kurtosis v = m4 / m2^2 - 3 (excess kurtosis)
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename E::value_type
+    kurtosis (const vector_expression<E> &e) {
+        return vector_higher_moment<E, kurtosis_tag>::apply (e);
+    }
+
+    // moment (v, k) = sum ((v [i] - mean)^k) / size
+    template<class E>
+    BOOST_UBLAS_INLINE
+    typename E::value_type
+    moment (const vector_expression<E> &e, typename E::size_type k) {
+        return vector_moment<E>::apply (e, k);
+    }
+
+    // ewm_mean (v, alpha) [i] = (1 - alpha) ewm_mean (v, alpha) [i - 1] + alpha v [i]
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    ewm_mean (const vector_expression<E> &e, typename E::value_type alpha) {
+        vector<typename E::value_type> r;
+        vector_ewm<E, ewm_mean_tag>::apply (e, alpha, r);
+        return r;
+    }
+
+    // ewm_var (v, alpha) [i] = exponentially weighted variance of v [0], ..., v [i]
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    ewm_var (const vector_expression<E> &e, typename E::value_type alpha) {
+        vector<typename E::value_type> r;
+        vector_ewm<E, ewm_variance_tag>::apply (e, alpha, r);
+        return r;
+    }
+
     // real: norm_1 v = sum (abs (v [i]))
     // complex: norm_1 v = sum (abs (real (v [i])) + abs (imag (v [i])))
     template<class E>
@@ -1710,6 +1906,62 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e ());
     }
 
+    // Statistics of the sliding windows of width w of a vector: element i
+    // covers e (i), ..., e (i + w - 1), so there are size () - w + 1 of
+    // them, all computed in one sliding pass of the functor.
+
+    // rolling_mean (v, w) [i] = mean (v [i], ..., v [i + w - 1]), skipping NaNs
+    // and infinities
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_rolling_mean<E>::result_type>
+    rolling_mean (const vector_expression<E> &e, typename E::size_type w) {
+        vector<typename vector_rolling_mean<E>::result_type> r;
+        vector_rolling_mean<E>::apply (e, w, r);
+        return r;
+    }
+
+    // rolling_variance (v, w) [i] = variance (v [i], ..., v [i + w - 1]), skipping
+    // NaNs and infinities
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_rolling_variance<E>::result_type>
+    rolling_variance (const vector_expression<E> &e, typename E::size_type w) {
+        vector<typename vector_rolling_variance<E>::result_type> r;
+        vector_rolling_variance<E>::apply (e, w, r);
+        return r;
+    }
+
+    // rolling_min (v, w) [i] = min (v [i], ..., v [i + w - 1])
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_rolling_extremum<E, std::greater<typename type_traits<typename E::value_type>::real_type> >::result_type>
+    rolling_min (const vector_expression<E> &e, typename E::size_type w) {
+        vector<typename vector_rolling_extremum<E, std::greater<typename type_traits<typename E::value_type>::real_type> >::result_type> r;
+        vector_rolling_extremum<E, std::greater<typename type_traits<typename E::value_type>::real_type> >::apply (e, w, r);
+        return r;
+    }
+
+    // rolling_max (v, w) [i] = max (v [i], ..., v [i + w - 1])
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_rolling_extremum<E, std::less<typename type_traits<typename E::value_type>::real_type> >::result_type>
+    rolling_max (const vector_expression<E> &e, typename E::size_type w) {
+        vector<typename vector_rolling_extremum<E, std::less<typename type_traits<typename E::value_type>::real_type> >::result_type> r;
+        vector_rolling_extremum<E, std::less<typename type_traits<typename E::value_type>::real_type> >::apply (e, w, r);
+        return r;
+    }
+
+    // rolling_median (v, w) [i] = median (v [i], ..., v [i + w - 1])
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_rolling_median<E>::result_type>
+    rolling_median (const vector_expression<E> &e, typename E::size_type w) {
+        vector<typename vector_rolling_median<E>::result_type> r;
+        vector_rolling_median<E>::apply (e, w, r);
+        return r;
+    }
+
     template<class E1, class E2, class F>
     class vector_scalar_binary:
         public scalar_expression<vector_scalar_binary<E1, E2, F> > {
@@ -1829,6 +2081,26 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e1 (), e2 ());
     }
 
+    // group_reduce (v, index, op) [k] = op of the v [i] in group k of index, for the
+    // operations group_sum_tag, group_mean_tag, group_variance_tag, group_min_tag,
+    // group_max_tag and group_count_tag; groups follow index.keys ()
+    template<class E, class K, class Tag>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    group_reduce (const vector_expression<E> &e, const group_index<K> &index, Tag) {
+        vector<typename E::value_type> r;
+        vector_group_reduce<E, Tag>::apply (e, index, r);
+        return r;
+    }
+
+    // group_reduce (v, keys, op) [k] = op of the v [i] whose keys [i] is the k-th smallest distinct key
+    template<class E, class EK, class Tag>
+    BOOST_UBLAS_INLINE
+    vector<typename E::value_type>
+    group_reduce (const vector_expression<E> &e, const vector_expression<EK> &keys, Tag op) {
+        return group_reduce (e, group_index<typename EK::value_type> (keys), op);
+    }
+
     // covariance (v1, v2)
     template<class E1, class E2>
     BOOST_UBLAS_INLINE
@@ -1838,6 +2110,73 @@ namespace boost { namespace numeric { namespace ublas {
         return expression_type (e1 (), e2 ());
     }
 
+    // covariance (v1, v2, ddof) = covariance (v1, v2) * size / (size - ddof)
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    typename vector_scalar_binary_traits<E1, E2, vector_covariance<E1, E2, typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type> >::result_type
+    covariance (const vector_expression<E1> &e1, const vector_expression<E2> &e2, typename E1::size_type ddof) {
+        typedef typename vector_scalar_binary_traits<E1, E2, vector_covariance<E1, E2, typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type> >::result_type result_type;
+        result_type size (e1 ().size ());
+        return covariance (e1, e2) * size / (size - result_type (ddof));
+    }
+
+    // covariance (v1, v2, w) = sum (w [i] (v1 [i] - mean (v1, w)) (v2 [i] - mean (v2, w))) / sum (w [i])
+    template<class E1, class E2, class W>
+    BOOST_UBLAS_INLINE
+    typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type
+    covariance (const vector_expression<E1> &e1, const vector_expression<E2> &e2, const vector_expression<W> &w) {
+        return vector_weighted_covariance<E1, E2, typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type>::apply (e1, e2, w);
+    }
+
+    // correlation (v1, v2) = covariance (v1, v2) / sqrt (variance (v1) * variance (v2))
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type
+    correlation (const vector_expression<E1> &e1, const vector_expression<E2> &e2) {
+        return vector_correlation<E1, E2, typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type>::apply (e1, e2);
+    }
+
+
+    // argsort v = indices i_0, ..., i_n-1 with v [i_0] <= ... <= v [i_n-1]; ties keep index order
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename E::size_type>
+    argsort (const vector_expression<E> &e) {
+        vector<typename E::size_type> r;
+        vector_argsort<E>::apply (e, r);
+        return r;
+    }
+
+    // rank v [i] = 1-based rank of v [i] by value, ties sharing their average rank
+    template<class E>
+    BOOST_UBLAS_INLINE
+    vector<typename vector_rank<E>::result_type>
+    rank (const vector_expression<E> &e) {
+        vector<typename vector_rank<E>::result_type> r;
+        vector_rank<E>::apply (e, r);
+        return r;
+    }
+
+    // spearman (v1, v2) = correlation (rank (v1), rank (v2))
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    typename rank_traits<typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type>::value_type
+    spearman (const vector_expression<E1> &e1, const vector_expression<E2> &e2) {
+        typedef typename rank_traits<typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type>::value_type result_type;
+        vector<result_type> r1, r2;
+        vector_rank<E1>::apply (e1, r1);
+        vector_rank<E2>::apply (e2, r2);
+        return vector_correlation<vector<result_type>, vector<result_type>, result_type>::apply (r1, r2);
+    }
+
+    // kendall (v1, v2) = Kendall's tau-b of the pairs (v1 [i], v2 [i])
+    template<class E1, class E2>
+    BOOST_UBLAS_INLINE
+    typename vector_kendall<E1, E2, typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type>::result_type
+    kendall (const vector_expression<E1> &e1, const vector_expression<E2> &e2) {
+        return vector_kendall<E1, E2, typename promote_traits<typename E1::value_type, typename E2::value_type>::promote_type>::apply (e1, e2);
+    }
+
 }}}
 
 #endif
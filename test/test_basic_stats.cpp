@@ -1,8 +1,16 @@
+#include <stdexcept>
 #include <string>
 
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/symmetric.hpp>
+#include <boost/numeric/ublas/triangular.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
 #include <boost/numeric/ublas/covariance_matrix.hpp>
+#include <boost/numeric/ublas/quantile_sketch.hpp>
+#include <boost/numeric/ublas/running_stats.hpp>
 #include <boost/numeric/ublas/io.hpp>
 
 #include "utils.hpp"
@@ -432,6 +440,90 @@ BOOST_UBLAS_TEST_DEF (test_median) {
     }
 }
 
+BOOST_UBLAS_TEST_DEF (test_median_selection) {
+    BOOST_UBLAS_DEBUG_TRACE("Median By Selection");
+
+    // Compare the selection based median with a full sort for odd and even sizes.
+    for (unsigned int size = 1; size < 40; ++ size) {
+        vector<double> v (size);
+        for (unsigned int i = 0; i < size; ++ i)
+            v (i) = double ((i * 7919) % 23) - 5.25;
+        vector<double> sorted (v);
+        std::sort (sorted.begin (), sorted.end (), vector_median<vector<double> >::compareElement);
+        double gt = (size % 2) ? sorted (size / 2) : (sorted (size / 2) + sorted (size / 2 - 1)) / 2;
+        BOOST_UBLAS_TEST_CHECK (median (v) == gt);
+
+        // The in-place variant reorders its argument but keeps its elements.
+        vector<double> w (v);
+        BOOST_UBLAS_TEST_CHECK (median_inplace (w) == gt);
+        std::sort (w.begin (), w.end (), vector_median<vector<double> >::compareElement);
+        BOOST_UBLAS_TEST_CHECK (std::equal (w.begin (), w.end (), sorted.begin ()));
+    }
+}
+
+BOOST_UBLAS_TEST_DEF (test_quantile) {
+    BOOST_UBLAS_DEBUG_TRACE("Vector Quantile");
+
+    // Compare every interpolation method with a reference on a sorted copy.
+    double qs [] = {0, 0.1, 0.25, 0.5, 0.75, 0.9, 1};
+    vector<double> q (7);
+    std::copy (qs, qs + 7, q.begin ());
+    for (unsigned int size = 1; size < 30; ++ size) {
+        vector<double> v (size);
+        for (unsigned int i = 0; i < size; ++ i)
+            v (i) = double ((i * 7919) % 23) - 5.25;
+        vector<double> sorted (v);
+        std::sort (sorted.begin (), sorted.end (), vector_median<vector<double> >::compareElement);
+        BOOST_UBLAS_TEST_CHECK (quantile (v, 0.5) == median (v));
+
+        int _fail = 0;
+        for (int method = quantile_linear; method <= quantile_midpoint; ++ method) {
+            vector<double> r = quantiles (v, q, quantile_interpolation (method));
+            for (unsigned int k = 0; k < q.size (); ++ k) {
+                double h = (size - 1) * q (k);
+                unsigned int lo = (unsigned int) h, hi = std::min (lo + 1, size - 1);
+                double frac = h - lo, gt = sorted (lo);
+                if (method == quantile_linear)
+                    gt = (1 - frac) * sorted (lo) + frac * sorted (hi);
+                else if (method == quantile_higher && frac > 0)
+                    gt = sorted (hi);
+                else if (method == quantile_nearest && (frac > 0.5 || (frac == 0.5 && lo % 2)))
+                    gt = sorted (hi);
+                else if (method == quantile_midpoint && frac > 0)
+                    gt = (sorted (lo) + sorted (hi)) / 2;
+                if (std::abs (r (k) - gt) > TOL || std::abs (quantile (v, q (k), quantile_interpolation (method)) - gt) > TOL)
+                    _fail = 1;
+            }
+        }
+        BOOST_UBLAS_TEST_CHECK (_fail == 0);
+    }
+
+    BOOST_UBLAS_DEBUG_TRACE("Matrix Quantile");
+
+    for (int i = 0; i < matrix_input_set_size; ++ i) {
+        matrix<double> m;
+        std::istringstream is(MATRIX_INPUT_SET [i]);
+        is >> m;
+        BOOST_UBLAS_TEST_CHECK (std::abs (quantile (m, 0.5) - median (m)) <= TOL);
+        vector<double> r = quantiles (m, q);
+        BOOST_UBLAS_TEST_CHECK (r (0) == min (m) && r (6) == max (m));
+
+        for (unsigned int axis = 0; axis < 2; ++ axis) {
+            int _fail = 0;
+            vector<double> gtmed = median (m, axis), gtmin = min (m, axis), gtmax = max (m, axis);
+            vector<double> rmed = quantile (m, 0.5, axis);
+            matrix<double> rq = quantiles (m, q, axis);
+            for (unsigned int j = 0; j < gtmed.size (); ++ j)
+                if (std::abs (rmed (j) - gtmed (j)) > TOL || std::abs (rq (3, j) - gtmed (j)) > TOL ||
+                    rq (0, j) != gtmin (j) || rq (6, j) != gtmax (j)) {
+                    _fail = 1;
+                    break;
+                }
+            BOOST_UBLAS_TEST_CHECK (_fail == 0);
+        }
+    }
+}
+
 BOOST_UBLAS_TEST_DEF (test_variance) {
     BOOST_UBLAS_DEBUG_TRACE("Vector Variance");
 
@@ -499,6 +591,215 @@ BOOST_UBLAS_TEST_DEF (test_variance) {
     }
 }
 
+BOOST_UBLAS_TEST_DEF (test_axis_storage_orders) {
+    BOOST_UBLAS_DEBUG_TRACE("Matrix Axis Reductions Across Storage Orders");
+
+    for (int i = 0; i < matrix_input_set_size; ++ i) {
+        matrix<double> m;
+        std::istringstream is(MATRIX_INPUT_SET [i]);
+        is >> m;
+        matrix<double, column_major> mc (m);
+        compressed_matrix<double> cm (m);
+
+        for (unsigned int axis = 0; axis < 2; ++ axis) {
+            int _fail = 0;
+            vector<double> gtmin = min (m, axis), gtmax = max (m, axis), gtsum = sum (m, axis);
+            vector<double> gtmean = mean (m, axis), gtvar = variance (m, axis);
+            vector<double> rmin = min (mc, axis), rmax = max (mc, axis), rsum = sum (mc, axis);
+            vector<double> rmean = mean (mc, axis), rvar = variance (mc, axis);
+            vector<double> smin = min (cm, axis), smax = max (cm, axis), ssum = sum (cm, axis);
+            vector<double> smean = mean (cm, axis), svar = variance (cm, axis);
+            for (unsigned int j = 0; j < gtmin.size (); ++ j)
+                if (rmin (j) != gtmin (j) || rmax (j) != gtmax (j) ||
+                    smin (j) != gtmin (j) || smax (j) != gtmax (j) ||
+                    std::abs (rsum (j) - gtsum (j)) > TOL || std::abs (ssum (j) - gtsum (j)) > TOL ||
+                    std::abs (rmean (j) - gtmean (j)) > TOL || std::abs (smean (j) - gtmean (j)) > TOL ||
+                    std::abs (rvar (j) - gtvar (j)) > TOL || std::abs (svar (j) - gtvar (j)) > TOL) {
+                    _fail = 1;
+                    break;
+                }
+            BOOST_UBLAS_TEST_CHECK (_fail == 0);
+        }
+    }
+}
+
+// Sum partial that throws on negative elements
+struct throwing_sum_partial {
+    typedef double value_type;
+
+    throwing_sum_partial ():
+        sum (0) {}
+
+    void push (double x) {
+        if (x < 0)
+            throw std::domain_error ("negative element");
+        sum += x;
+    }
+    void merge (const throwing_sum_partial &p) {
+        sum += p.sum;
+    }
+    template<class U>
+    void push_range (const U *first, const U *last) {
+        for (; first != last; ++ first)
+            push (*first);
+    }
+
+    double sum;
+};
+
+BOOST_UBLAS_TEST_DEF (test_chunked_reductions) {
+    BOOST_UBLAS_DEBUG_TRACE("Chunked Reductions of Expressions");
+
+    const unsigned int size1 = 50, size2 = 400;
+    matrix<double> m (size1, size2);
+    double total = 0;
+    for (unsigned int j = 0; j < size2; ++ j) {
+        double column_sum = 0;
+        for (unsigned int i = 0; i < size1; ++ i)
+            column_sum += m (i, j) = double ((i * 7 + j * 3) % 17) / 8.;
+        total += column_sum / size1;
+    }
+    BOOST_UBLAS_TEST_CHECK (std::abs (sum (mean (m, 0)) - total) < TOL);
+    vector<double> a (row (m, 3)), b (row (m, 4));
+    BOOST_UBLAS_TEST_CHECK (std::abs (sum (a + b) - (sum (a) + sum (b))) < TOL);
+
+    vector<double> v (1000, 1.);
+    BOOST_UBLAS_TEST_CHECK (vector_reduce<throwing_sum_partial> (v).sum == 1000.);
+    v (997) = -1.;
+    bool thrown = false;
+    try {
+        vector_reduce<throwing_sum_partial> (v);
+    }
+    catch (const std::domain_error &) {
+        thrown = true;
+    }
+    BOOST_UBLAS_TEST_CHECK (thrown);
+
+    // NaNs give the same min, max and norms with and without the SIMD
+    // kernels: a leading NaN is kept by min and max, later ones are skipped
+    const double nan = std::numeric_limits<double>::quiet_NaN ();
+    vector<double> g (37);
+    for (unsigned int i = 0; i < g.size (); ++ i)
+        g (i) = double ((i * 7919) % 61) - 29.5;
+    g (9) = g (17) = g (26) = g (31) = g (36) = nan;
+    double lo = g (0), hi = g (0), ninf = 0;
+    for (unsigned int i = 0; i < g.size (); ++ i) {
+        if (std::abs (g (i)) < std::abs (lo))
+            lo = g (i);
+        if (std::abs (g (i)) > std::abs (hi))
+            hi = g (i);
+        if (std::abs (g (i)) > ninf)
+            ninf = std::abs (g (i));
+    }
+    BOOST_UBLAS_TEST_CHECK (min (g) == lo && max (g) == hi && norm_inf (g) == ninf);
+    BOOST_UBLAS_TEST_CHECK (norm_1 (g) != norm_1 (g));
+    g (0) = nan;
+    ninf = 0;
+    for (unsigned int i = 1; i < g.size (); ++ i)
+        if (std::abs (g (i)) > ninf)
+            ninf = std::abs (g (i));
+    BOOST_UBLAS_TEST_CHECK (min (g) != min (g) && max (g) != max (g) && norm_inf (g) == ninf);
+}
+
+BOOST_UBLAS_TEST_DEF (test_sparse_stats) {
+    BOOST_UBLAS_DEBUG_TRACE("Matrix Stats Over Stored Elements");
+
+    // Sparse containers only visit their stored elements; compare with the
+    // dense results with few, many and no implicit zeros.
+    for (unsigned int fill = 1; fill <= 5; ++ fill) {
+        matrix<double> m (7, 5, 0);
+        for (unsigned int k = 0; k < 7 * 5; ++ k)
+            if ((k * 13) % 5 < fill)
+                m (k / 5, k % 5) = double ((k * 7919) % 11) - 4.25;
+        compressed_matrix<double> cm (m);
+        coordinate_matrix<double> km (m);
+
+        double gtmin = min (m), gtmax = max (m), gtsum = sum (m), gtmean = mean (m);
+        double gtvar = variance (m), gtmedian = median (m), gtmode = mode (m), gtq = quantile (m, 0.3);
+        BOOST_UBLAS_TEST_CHECK (min (cm) == gtmin && min (km) == gtmin);
+        BOOST_UBLAS_TEST_CHECK (max (cm) == gtmax && max (km) == gtmax);
+        BOOST_UBLAS_TEST_CHECK (std::abs (sum (cm) - gtsum) <= TOL && std::abs (sum (km) - gtsum) <= TOL);
+        BOOST_UBLAS_TEST_CHECK (std::abs (mean (cm) - gtmean) <= TOL && std::abs (mean (km) - gtmean) <= TOL);
+        BOOST_UBLAS_TEST_CHECK (std::abs (variance (cm) - gtvar) <= TOL && std::abs (variance (km) - gtvar) <= TOL);
+        BOOST_UBLAS_TEST_CHECK (median (cm) == gtmedian && median (km) == gtmedian);
+        BOOST_UBLAS_TEST_CHECK (mode (cm) == gtmode && mode (km) == gtmode);
+        BOOST_UBLAS_TEST_CHECK (quantile (cm, 0.3) == gtq && quantile (km, 0.3) == gtq);
+    }
+
+    // Explicitly stored zeros count like implicit ones
+    compressed_matrix<double> z (3, 3);
+    z (0, 0) = 0;
+    z (1, 2) = -2;
+    BOOST_UBLAS_TEST_CHECK (min (z) == 0 && max (z) == -2 && median (z) == 0 && mode (z) == 0);
+    BOOST_UBLAS_TEST_CHECK (std::abs (variance (z) - (4. / 9 - 4. / 81)) <= TOL);
+}
+
+BOOST_UBLAS_TEST_DEF (test_describe) {
+    BOOST_UBLAS_DEBUG_TRACE("Vector Describe");
+
+    for (int i = 0; i < vector_input_set_size; ++ i) {
+        vector<double> v;
+        std::istringstream is(VECTOR_INPUT_SET [i]);
+        is >> v;
+        stats_summary<double, std::size_t> s = describe (v);
+        BOOST_UBLAS_TEST_CHECK (s.count == v.size ());
+        BOOST_UBLAS_TEST_CHECK (std::abs (s.mean - mean (v)) <= TOL);
+        BOOST_UBLAS_TEST_CHECK (std::abs (s.variance - variance (v)) <= TOL);
+        BOOST_UBLAS_TEST_CHECK (s.min == min (v));
+        BOOST_UBLAS_TEST_CHECK (s.max == max (v));
+        BOOST_UBLAS_TEST_CHECK (s.median == median (v));
+        BOOST_UBLAS_TEST_CHECK (s.mode == mode (v));
+    }
+
+    BOOST_UBLAS_DEBUG_TRACE("Matrix Describe");
+
+    for (int i = 0; i < matrix_input_set_size; ++ i) {
+        matrix<double> m;
+        std::istringstream is(MATRIX_INPUT_SET [i]);
+        is >> m;
+        stats_summary<double, std::size_t> s = describe (m);
+        BOOST_UBLAS_TEST_CHECK (s.count == m.size1 () * m.size2 ());
+        BOOST_UBLAS_TEST_CHECK (std::abs (s.mean - mean (m)) <= TOL);
+        BOOST_UBLAS_TEST_CHECK (std::abs (s.variance - variance (m)) <= TOL);
+        BOOST_UBLAS_TEST_CHECK (s.min == min (m));
+        BOOST_UBLAS_TEST_CHECK (s.max == max (m));
+        BOOST_UBLAS_TEST_CHECK (s.median == median (m));
+        BOOST_UBLAS_TEST_CHECK (s.mode == mode (m));
+    }
+
+    BOOST_UBLAS_DEBUG_TRACE("Matrix Describe Axis");
+
+    for (int i = 0; i < matrix_input_set_size; ++ i) {
+        matrix<double> m;
+        std::istringstream is(MATRIX_INPUT_SET [i]);
+        is >> m;
+        matrix<double, column_major> mc (m);
+        for (unsigned int axis = 0; axis < 2; ++ axis) {
+            int _fail = 0;
+            stats_summary<vector<double>, std::size_t> s = describe (m, axis);
+            stats_summary<vector<double>, std::size_t> sc = describe (mc, axis);
+            vector<double> resmean = mean (m, axis);
+            vector<double> resvar = variance (m, axis);
+            vector<double> resmin = min (m, axis);
+            vector<double> resmax = max (m, axis);
+            vector<double> resmedian = median (m, axis);
+            vector<double> resmode = mode (m, axis);
+            BOOST_UBLAS_TEST_CHECK (s.count == (axis == 0 ? m.size1 () : m.size2 ()));
+            BOOST_UBLAS_TEST_CHECK (s.mean.size () == resmean.size ());
+            for (unsigned int j = 0; j < resmean.size (); ++ j)
+                if (std::abs (s.mean (j) - resmean (j)) > TOL ||
+                    std::abs (s.variance (j) - resvar (j)) > TOL ||
+                    s.min (j) != resmin (j) || s.max (j) != resmax (j) ||
+                    s.median (j) != resmedian (j) || s.mode (j) != resmode (j) ||
+                    std::abs (sc.mean (j) - resmean (j)) > TOL || sc.median (j) != resmedian (j)) {
+                    _fail = 1;
+                    break;
+                }
+            BOOST_UBLAS_TEST_CHECK (_fail == 0);
+        }
+    }
+}
+
 /*
 std::string VECTOR_INPUT_SET [] = {"[3](1,4,1)\0", "[3](1.023, 2.349, 7.839)\0"};
 int vector_input_set_size = 2;
@@ -579,6 +880,899 @@ BOOST_UBLAS_TEST_DEF (test_covariance_matrix) {
         }
 }
 
+BOOST_UBLAS_TEST_DEF (test_covariance_matrix_blocked) {
+    BOOST_UBLAS_DEBUG_TRACE("Blocked Covariance Matrix");
+
+    // Spans several variable blocks and observation depths, with partial
+    // tiles at both ends
+    matrix<double> m (70, 301);
+    for (unsigned int i = 0; i < m.size1 (); ++ i)
+        for (unsigned int k = 0; k < m.size2 (); ++ k)
+            m (i, k) = 100.0 * i + ((i * 31 + k * 7919) % 97) * 0.25;
+
+    symmetric_matrix<double, lower> cov = covariance_matrix (m);
+    symmetric_matrix<double, lower> cov_t = covariance_matrix (matrix<double, column_major> (trans (m)), false);
+    BOOST_UBLAS_TEST_CHECK (cov.size1 () == m.size1 ());
+    int _fail = 0;
+    for (unsigned int i = 0; i < m.size1 (); ++ i)
+        for (unsigned int j = 0; j <= i; ++ j) {
+            double gt = covariance (row (m, i), row (m, j));
+            if (std::abs (cov (i, j) - gt) > TOL || std::abs (cov_t (i, j) - gt) > TOL)
+                _fail = 1;
+        }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // No observations give an all zero covariance
+    matrix<double> empty (3, 0);
+    symmetric_matrix<double, lower> cov0 = covariance_matrix (empty);
+    BOOST_UBLAS_TEST_CHECK (cov0.size1 () == 3 && cov0 (2, 1) == 0);
+}
+
+BOOST_UBLAS_TEST_DEF (test_correlation) {
+    BOOST_UBLAS_DEBUG_TRACE("Correlation");
+
+    matrix<double> m (5, 40);
+    for (unsigned int i = 0; i < m.size1 (); ++ i)
+        for (unsigned int k = 0; k < m.size2 (); ++ k)
+            m (i, k) = (i + 1.0) * k + ((i * 31 + k * 7919) % 13) * (i % 2 ? -1.5 : 2.0);
+
+    symmetric_matrix<double, lower> cov = covariance_matrix (m);
+    symmetric_matrix<double, lower> cov1 = covariance_matrix (m, true, 1);
+    symmetric_matrix<double, lower> corr = correlation_matrix (m);
+    symmetric_matrix<double, lower> corr_t = correlation_matrix (matrix<double> (trans (m)), false);
+    double n = m.size2 ();
+    int _fail = 0;
+    for (unsigned int i = 0; i < m.size1 (); ++ i)
+        for (unsigned int j = 0; j <= i; ++ j) {
+            double gt = cov (i, j) / std::sqrt (cov (i, i) * cov (j, j));
+            if (std::abs (corr (i, j) - gt) > TOL || std::abs (corr_t (i, j) - gt) > TOL)
+                _fail = 1;
+            if (std::abs (correlation (row (m, i), row (m, j)) - gt) > TOL)
+                _fail = 1;
+            if (std::abs (cov1 (i, j) - cov (i, j) * n / (n - 1)) > TOL)
+                _fail = 1;
+            if (std::abs (covariance (row (m, i), row (m, j), 1) - cov1 (i, j)) > TOL)
+                _fail = 1;
+        }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+    BOOST_UBLAS_TEST_CHECK (std::abs (corr (3, 3) - 1) <= TOL);
+
+    // Perfectly (anti) correlated and constant variables
+    vector<double> v1 (4), v2 (4), v3 (4);
+    for (unsigned int i = 0; i < 4; ++ i) {
+        v1 (i) = i;
+        v2 (i) = 10.0 - 3.0 * i;
+        v3 (i) = 2.5;
+    }
+    BOOST_UBLAS_TEST_CHECK (std::abs (correlation (v1, v2) + 1) <= TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (correlation (v1, v1) - 1) <= TOL);
+    BOOST_UBLAS_TEST_CHECK (correlation (v1, v3) != correlation (v1, v3));
+}
+
+BOOST_UBLAS_TEST_DEF (test_running_stats) {
+    BOOST_UBLAS_DEBUG_TRACE("Running Stats");
+
+    vector<double> v (103);
+    for (unsigned int i = 0; i < v.size (); ++ i)
+        v (i) = ((i * 7919) % 29) - 13.25;
+
+    // Micro-batches of single values, vector ranges and a matrix, and a
+    // separately accumulated stream merged in
+    running_stats<double> s, t;
+    BOOST_UBLAS_TEST_CHECK (s.count () == 0 && s.mean () == 0 && s.variance () == 0);
+    s.push (v (0));
+    s.push (subrange (v, 1, 40));
+    matrix<double> m (3, 7);
+    for (unsigned int i = 0; i < 3; ++ i)
+        for (unsigned int j = 0; j < 7; ++ j)
+            m (i, j) = v (40 + i * 7 + j);
+    s.push (m);
+    t.push (subrange (v, 61, 103));
+    s.merge (t);
+
+    BOOST_UBLAS_TEST_CHECK (s.count () == v.size ());
+    BOOST_UBLAS_TEST_CHECK (std::abs (s.sum () - sum (v)) <= TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (s.mean () - mean (v)) <= TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (s.variance () - variance (v)) <= TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (s.variance (1) - variance (v) * v.size () / (v.size () - 1)) <= TOL);
+    BOOST_UBLAS_TEST_CHECK (s.min () == min (v));
+    BOOST_UBLAS_TEST_CHECK (s.max () == max (v));
+
+    // Observations in the columns: single pushes, a batch and a merge
+    matrix<double> obs (4, 50);
+    for (unsigned int i = 0; i < obs.size1 (); ++ i)
+        for (unsigned int k = 0; k < obs.size2 (); ++ k)
+            obs (i, k) = (i + 1.0) * k + ((i * 31 + k * 7919) % 13) * (i % 2 ? -1.5 : 2.0);
+    running_covariance<double> c, d (4);
+    for (unsigned int k = 0; k < 10; ++ k)
+        c.push (column (obs, k));
+    c.push (subrange (obs, 0, 4, 10, 30));
+    d.push (trans (subrange (obs, 0, 4, 30, 50)), false);
+    c.merge (d);
+
+    symmetric_matrix<double, lower> cov = covariance_matrix (obs);
+    symmetric_matrix<double, lower> rcov = c.covariance ();
+    symmetric_matrix<double, lower> rcov1 = c.covariance (1);
+    BOOST_UBLAS_TEST_CHECK (c.count () == obs.size2 () && c.size () == obs.size1 ());
+    int _fail = 0;
+    for (unsigned int i = 0; i < obs.size1 (); ++ i) {
+        if (std::abs (c.mean () (i) - mean (row (obs, i))) > TOL)
+            _fail = 1;
+        for (unsigned int j = 0; j <= i; ++ j)
+            if (std::abs (rcov (i, j) - cov (i, j)) > TOL || std::abs (rcov1 (i, j) - cov (i, j) * 50 / 49) > TOL)
+                _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+BOOST_UBLAS_TEST_DEF (test_quantile_sketch) {
+    BOOST_UBLAS_DEBUG_TRACE("Quantile Sketch");
+
+    // Exact while nothing has been merged
+    vector<double> v (20);
+    for (unsigned int i = 0; i < v.size (); ++ i)
+        v (i) = ((i * 7919) % 23) + 0.25;
+    quantile_sketch<double> small;
+    small.push (v);
+    vector<double> q (5);
+    q (0) = 0.0;
+    q (1) = 0.1;
+    q (2) = 0.5;
+    q (3) = 0.93;
+    q (4) = 1.0;
+    vector<double> r = small.quantiles (q);
+    int _fail = 0;
+    for (unsigned int i = 0; i < q.size (); ++ i)
+        if (std::abs (r (i) - quantile (v, q (i))) > TOL)
+            _fail = 1;
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // Const queries of buffered values agree with flushed ones
+    quantile_sketch<double> buffered;
+    buffered.push (v);
+    const quantile_sketch<double> &view (buffered);
+    BOOST_UBLAS_TEST_CHECK (std::abs (view.quantile (0.5) - small.quantile (0.5)) < TOL);
+    BOOST_UBLAS_TEST_CHECK (view.size () == small.size ());
+    BOOST_UBLAS_TEST_CHECK (quantile_sketch<double> ().quantile (0.5) == 0);
+
+    // Bounded memory and small rank error over a long stream fed in batches
+    // to two sketches that are then merged
+    const unsigned int n = 200000;
+    quantile_sketch<double> a (100), b (100);
+    vector<double> batch (1000);
+    for (unsigned int k = 0; k < n / 1000; ++ k) {
+        for (unsigned int i = 0; i < 1000; ++ i)
+            batch (i) = double ((k * 1000 + i) * 7919u % n);
+        if (k % 2)
+            a.push (batch);
+        else
+            b.push (batch);
+    }
+    a.merge (b);
+    BOOST_UBLAS_TEST_CHECK (a.count () == n);
+    BOOST_UBLAS_TEST_CHECK (a.size () <= 200);
+    BOOST_UBLAS_TEST_CHECK (a.quantile (0) == 0 && a.quantile (1) == n - 1);
+    _fail = 0;
+    for (unsigned int i = 0; i <= 100; ++ i) {
+        double p = i / 100.0;
+        // The values are a permutation of 0 .. n - 1, so the rank is the value
+        double rank_error = std::abs (a.quantile (p) - p * (n - 1)) / n;
+        if (rank_error > 0.01 || (std::min (p, 1 - p) < 0.02 && rank_error > 0.001))
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // Skewed data and its mirror image see the same error at opposite ends
+    std::vector<double> cube (n), mirror (n);
+    quantile_sketch<double> sc, sm;
+    for (unsigned int i = 0; i < n; ++ i) {
+        double x = double (i * 7919u % n) / n;
+        sc.push (cube [i] = x * x * x);
+        sm.push (mirror [i] = 1 - x * x * x);
+    }
+    std::sort (cube.begin (), cube.end ());
+    std::sort (mirror.begin (), mirror.end ());
+    _fail = 0;
+    const double ps [] = {0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999};
+    for (unsigned int i = 0; i < 7; ++ i) {
+        double rc = double (std::lower_bound (cube.begin (), cube.end (), sc.quantile (ps [i])) - cube.begin ()) / n;
+        double rm = double (std::lower_bound (mirror.begin (), mirror.end (), sm.quantile (1 - ps [i])) - mirror.begin ()) / n;
+        if (std::abs (rc - ps [i]) > 0.002 || std::abs (rm - (1 - ps [i])) > 0.002)
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+// Quadratic reference mode with the same tie-break as mode (v)
+template<class T>
+T brute_force_mode (const std::vector<T> &v) {
+    T best = T (0);
+    std::size_t best_count = 0;
+    for (std::size_t i = 0; i < v.size (); ++ i) {
+        std::size_t c = 0;
+        for (std::size_t j = 0; j < v.size (); ++ j)
+            if (v [j] == v [i])
+                ++ c;
+        if (c > best_count || (c == best_count && (std::abs (v [i]) < std::abs (best) ||
+                                                   (std::abs (v [i]) == std::abs (best) && v [i] < best)))) {
+            best = v [i];
+            best_count = c;
+        }
+    }
+    return best;
+}
+
+BOOST_UBLAS_TEST_DEF (test_mode_engines) {
+    BOOST_UBLAS_DEBUG_TRACE("Mode Engines");
+
+    // Small range integers are counted in an array
+    vector<int> small (500);
+    for (unsigned int i = 0; i < small.size (); ++ i)
+        small (i) = int ((i * 37) % 11) - 5 + int (i % 3 == 0);
+    BOOST_UBLAS_TEST_CHECK (mode (small) == brute_force_mode (std::vector<int> (small.begin (), small.end ())));
+
+    // Wide range integers and doubles are radix sorted
+    vector<int> wide (300);
+    for (unsigned int i = 0; i < wide.size (); ++ i)
+        wide (i) = i % 7 == 0 ? -123456789 : int ((i * 7919u) % 100003u) * 1000 - 50000000;
+    BOOST_UBLAS_TEST_CHECK (mode (wide) == -123456789);
+    vector<double> real (1000);
+    for (unsigned int i = 0; i < real.size (); ++ i)
+        real (i) = ((i * 7919u) % 97u) * 0.5 - 20.1;
+    BOOST_UBLAS_TEST_CHECK (mode (real) == brute_force_mode (std::vector<double> (real.begin (), real.end ())));
+    vector<double> zeros (4);
+    zeros (0) = 1.5;
+    zeros (1) = -0.0;
+    zeros (2) = 1.5;
+    zeros (3) = 0.0;
+    BOOST_UBLAS_TEST_CHECK (mode (zeros) == 0);
+
+    // Ties of equal magnitude go to the smaller value whichever engine counts
+    vector<int> int_ties (40), wide_ties (40);
+    vector<double> few_ties (40), many_ties (400);
+    for (unsigned int i = 0; i < 40; ++ i) {
+        int_ties (i) = i < 10 ? 3 : (i < 20 ? -3 : int (i % 5) + 10);
+        wide_ties (i) = i < 10 ? 123456789 : (i < 20 ? -123456789 : int (i * 7919u));
+        few_ties (i) = i < 10 ? 3.5 : (i < 20 ? -3.5 : 10.0 + i % 5);
+    }
+    for (unsigned int i = 0; i < 400; ++ i)
+        many_ties (i) = i < 10 ? 3.5 : (i < 20 ? -3.5 : 0.001 * i + 7.0);
+    BOOST_UBLAS_TEST_CHECK (mode (int_ties) == -3 && mode (wide_ties) == -123456789);
+    BOOST_UBLAS_TEST_CHECK (mode (few_ties) == -3.5 && mode (many_ties) == -3.5);
+
+    // One engine per axis, for both storage orders and sparse storage
+    matrix<int> m (40, 30);
+    matrix<int, column_major> cm (40, 30);
+    for (unsigned int i = 0; i < m.size1 (); ++ i)
+        for (unsigned int j = 0; j < m.size2 (); ++ j)
+            cm (i, j) = m (i, j) = int ((i * 31 + j * 17) % (j + 3));
+    int _fail = 0;
+    for (unsigned int axis = 0; axis < 2; ++ axis) {
+        vector<int> r = mode (m, axis);
+        vector<int> cr = mode (cm, axis);
+        for (unsigned int k = 0; k < r.size (); ++ k) {
+            std::vector<int> slice;
+            for (unsigned int l = 0; l < (axis == 0 ? m.size1 () : m.size2 ()); ++ l)
+                slice.push_back (axis == 0 ? m (l, k) : m (k, l));
+            if (r (k) != brute_force_mode (slice) || cr (k) != r (k))
+                _fail = 1;
+        }
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    compressed_matrix<double> s (5, 4);
+    for (unsigned int i = 0; i < 5; ++ i)
+        s (i, 2) = i < 3 ? 2.5 : -1.0;
+    s (1, 0) = 4.0;
+    s (2, 0) = 4.0;
+    s (3, 0) = 4.0;
+    s (0, 3) = 7.0;
+    vector<double> sr = mode (s, 0);
+    BOOST_UBLAS_TEST_CHECK (sr (0) == 4.0 && sr (1) == 0 && sr (2) == 2.5 && sr (3) == 0);
+}
+
+BOOST_UBLAS_TEST_DEF (test_rolling_stats) {
+    BOOST_UBLAS_DEBUG_TRACE("Rolling Window Statistics");
+
+    vector<double> v (200);
+    for (unsigned int i = 0; i < v.size (); ++ i)
+        v (i) = double ((i * 7919) % 101) - 50.3;
+
+    int _fail = 0;
+    unsigned int windows [] = {1, 2, 7, 30, 200};
+    for (unsigned int k = 0; k < 5; ++ k) {
+        unsigned int w = windows [k];
+        vector<double> rmean = rolling_mean (v, w);
+        vector<double> rvar = rolling_variance (v, w);
+        vector<double> rmin = rolling_min (v, w);
+        vector<double> rmax = rolling_max (v, w);
+        vector<double> rmedian = rolling_median (v, w);
+        if (rmean.size () != v.size () - w + 1 || rmedian.size () != rmean.size ())
+            _fail = 1;
+        for (unsigned int i = 0; i < rmean.size (); ++ i) {
+            vector<double> window = subrange (v, i, i + w);
+            if (std::abs (rmean (i) - mean (window)) > TOL ||
+                std::abs (rvar (i) - variance (window)) > 1e-6 ||
+                rmin (i) != min (window) || rmax (i) != max (window) ||
+                rmedian (i) != median (window))
+                _fail = 1;
+        }
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // Windows wider than the vector are empty; results do not follow later
+    // changes of the vector
+    BOOST_UBLAS_TEST_CHECK (rolling_mean (v, 201).size () == 0);
+    vector<double> rmax (rolling_max (v, 3));
+    BOOST_UBLAS_TEST_CHECK (rmax (5) == max (subrange (v, 5, 8)));
+    double before (rmax (5));
+    v (6) = 1e6;
+    BOOST_UBLAS_TEST_CHECK (rmax (5) == before && rolling_max (v, 3) (5) == 1e6);
+
+    // NaNs are skipped by the rolling median
+    vector<double> gaps (subrange (v, 0, 40));
+    const double nan = std::numeric_limits<double>::quiet_NaN ();
+    gaps (7) = nan;
+    gaps (20) = gaps (21) = gaps (22) = gaps (23) = nan;
+    vector<double> rgaps (rolling_median (gaps, 4));
+    _fail = 0;
+    for (unsigned int i = 0; i < rgaps.size (); ++ i) {
+        vector<double> window = subrange (gaps, i, i + 4);
+        if (i == 20 ? rgaps (i) == rgaps (i) : rgaps (i) != nanmedian (window))
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // Rolling moments skip NaNs and infinities as well, and a spike leaves
+    // no error behind once it is out of the window
+    gaps (30) = std::numeric_limits<double>::infinity ();
+    vector<double> gmean (rolling_mean (gaps, 4)), gvar (rolling_variance (gaps, 4));
+    _fail = 0;
+    for (unsigned int i = 0; i < gmean.size (); ++ i) {
+        std::vector<double> finite;
+        for (unsigned int j = i; j < i + 4; ++ j)
+            if (std::abs (gaps (j)) <= std::numeric_limits<double>::max ())
+                finite.push_back (gaps (j));
+        if (finite.empty ()) {
+            if (gmean (i) == gmean (i) || gvar (i) == gvar (i))
+                _fail = 1;
+            continue;
+        }
+        vector<double> window (finite.size ());
+        std::copy (finite.begin (), finite.end (), window.begin ());
+        // gaps (6) is the 1e6 set above
+        if (std::abs (gmean (i) - mean (window)) > TOL || std::abs (gvar (i) - variance (window)) > TOL * (1 + variance (window)))
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    const double spikes [] = {1e7, 1e17};
+    for (unsigned int k = 0; k < 2; ++ k) {
+        vector<double> s (40);
+        for (unsigned int i = 0; i < s.size (); ++ i)
+            s (i) = double (i) + 0.25 * double (i % 3);
+        s (1) = spikes [k];
+        for (unsigned int w = 2; w <= 9; w += 7) {
+            vector<double> smean (rolling_mean (s, w)), svar (rolling_variance (s, w));
+            _fail = 0;
+            for (unsigned int i = 2; i < smean.size (); ++ i) {
+                vector<double> window (subrange (s, i, i + w));
+                if (std::abs (smean (i) - mean (window)) > TOL || std::abs (svar (i) - variance (window)) > TOL)
+                    _fail = 1;
+            }
+            BOOST_UBLAS_TEST_CHECK (_fail == 0);
+        }
+    }
+
+    // Values of equal magnitude are ordered by value in every median, so
+    // windows with +x and -x agree with the median of the window
+    vector<double> ties (120);
+    for (unsigned int i = 0; i < ties.size (); ++ i)
+        ties (i) = double (int ((i * 7919) % 21) - 10);
+    _fail = 0;
+    for (unsigned int w = 1; w <= 8; ++ w) {
+        vector<double> rties (rolling_median (ties, w));
+        for (unsigned int i = 0; i < rties.size (); ++ i)
+            if (rties (i) != median (vector<double> (subrange (ties, i, i + w))))
+                _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+    vector<double> pair (2);
+    pair (0) = 3; pair (1) = -3;
+    BOOST_UBLAS_TEST_CHECK (median (pair) == rolling_median (pair, 2) (0));
+}
+
+BOOST_UBLAS_TEST_DEF (test_ewm) {
+    BOOST_UBLAS_DEBUG_TRACE("Exponentially Weighted Moments");
+
+    const double alpha = 0.3;
+    vector<double> v (50);
+    for (unsigned int i = 0; i < v.size (); ++ i)
+        v (i) = double ((i * 7919) % 31) - 12.5;
+
+    // Weights (1 - alpha)^t for v (0) and alpha (1 - alpha)^(t - i) for v (i)
+    vector<double> em = ewm_mean (v, alpha);
+    vector<double> ev = ewm_var (v, alpha);
+    ewm_stats<double> live (alpha);
+    int _fail = 0;
+    for (unsigned int t = 0; t < v.size (); ++ t) {
+        double m = 0, sq = 0;
+        for (unsigned int i = 0; i <= t; ++ i) {
+            double wi = (i == 0 ? 1.0 : alpha) * std::pow (1 - alpha, double (t - i));
+            m += wi * v (i);
+            sq += wi * v (i) * v (i);
+        }
+        live.push (v (t));
+        if (std::abs (em (t) - m) > TOL || std::abs (ev (t) - (sq - m * m)) > 1e-6 ||
+            live.mean () != em (t) || live.variance () != ev (t))
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0 && live.count () == v.size ());
+
+    // Every column (axis 0) or row (axis 1) is a series, in both storage orders
+    matrix<double> s (50, 3);
+    matrix<double, column_major> cs (3, 50);
+    for (unsigned int i = 0; i < 50; ++ i)
+        for (unsigned int j = 0; j < 3; ++ j)
+            cs (j, i) = s (i, j) = v ((i + 17 * j) % 50);
+    matrix<double> sm = ewm_mean (s, alpha, 0);
+    matrix<double> sv = ewm_var (cs, alpha, 1);
+    _fail = 0;
+    for (unsigned int j = 0; j < 3; ++ j) {
+        vector<double> m = ewm_mean (column (s, j), alpha);
+        vector<double> var = ewm_var (column (s, j), alpha);
+        for (unsigned int i = 0; i < 50; ++ i)
+            if (sm (i, j) != m (i) || sv (j, i) != var (i))
+                _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+// Two pass reference: sum ((v [i] - mean)^k) / size
+template<class V>
+double reference_moment (const V &v, unsigned int k) {
+    double m = 0, s = 0;
+    for (unsigned int i = 0; i < v.size (); ++ i)
+        m += v (i);
+    m /= v.size ();
+    for (unsigned int i = 0; i < v.size (); ++ i)
+        s += std::pow (v (i) - m, double (k));
+    return s / v.size ();
+}
+
+BOOST_UBLAS_TEST_DEF (test_higher_moments) {
+    BOOST_UBLAS_DEBUG_TRACE("Higher Moments");
+
+    // Skewed data far from zero
+    vector<double> v (1000);
+    for (unsigned int i = 0; i < v.size (); ++ i) {
+        double u = ((i * 7919) % 1000) / 1000.0;
+        v (i) = 1e4 + u * u * u;
+    }
+    int _fail = 0;
+    for (unsigned int k = 0; k <= 7; ++ k) {
+        double gt = reference_moment (v, k);
+        if (std::abs (moment (v, k) - gt) > 1e-9 * std::max (1.0, std::abs (gt)))
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+    double m2 = reference_moment (v, 2), m3 = reference_moment (v, 3), m4 = reference_moment (v, 4);
+    BOOST_UBLAS_TEST_CHECK (std::abs (skewness (v) - m3 / std::pow (m2, 1.5)) < 1e-9);
+    BOOST_UBLAS_TEST_CHECK (std::abs (kurtosis (v) - (m4 / (m2 * m2) - 3)) < 1e-9);
+
+    // Whole matrix and axis variants, dense in both orders and sparse
+    matrix<double> m (40, 25);
+    matrix<double, column_major> cm (40, 25);
+    compressed_matrix<double> sm (40, 25);
+    for (unsigned int i = 0; i < m.size1 (); ++ i)
+        for (unsigned int j = 0; j < m.size2 (); ++ j) {
+            cm (i, j) = m (i, j) = v ((i * 25 + j) % v.size ()) - 1e4;
+            if ((i + j) % 3 == 0)
+                sm (i, j) = m (i, j);
+            else
+                cm (i, j) = m (i, j) = 0;
+        }
+    vector<double> all (m.size1 () * m.size2 ());
+    for (unsigned int i = 0; i < m.size1 (); ++ i)
+        for (unsigned int j = 0; j < m.size2 (); ++ j)
+            all (i * m.size2 () + j) = m (i, j);
+    BOOST_UBLAS_TEST_CHECK (std::abs (skewness (m) - skewness (all)) < 1e-9 && std::abs (kurtosis (sm) - kurtosis (all)) < 1e-9);
+    BOOST_UBLAS_TEST_CHECK (std::abs (moment (cm, 5) - moment (all, 5)) < 1e-12);
+    _fail = 0;
+    for (unsigned int axis = 0; axis < 2; ++ axis) {
+        vector<double> rs = skewness (m, axis);
+        vector<double> rk = kurtosis (sm, axis);
+        vector<double> r5 = moment (cm, 5, axis);
+        vector<double> r3 = moment (sm, 3, axis);
+        for (unsigned int k = 0; k < rs.size (); ++ k) {
+            vector<double> slice = axis == 0 ? vector<double> (column (m, k)) : vector<double> (row (m, k));
+            if (std::abs (rs (k) - skewness (slice)) > 1e-9 || std::abs (rk (k) - kurtosis (slice)) > 1e-9 ||
+                std::abs (r5 (k) - reference_moment (slice, 5)) > 1e-12 || std::abs (r3 (k) - reference_moment (slice, 3)) > 1e-12)
+                _fail = 1;
+        }
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+BOOST_UBLAS_TEST_DEF (test_summation_policies) {
+    BOOST_UBLAS_DEBUG_TRACE("Summation Policies");
+
+    // 0.1f is not representable; a plain float sum of 10^6 copies drifts by
+    // about one percent from the exact sum of the stored value
+    const unsigned int n = 1000000;
+    vector<float> v (n, 0.1f);
+    double exact = double (0.1f) * n;
+    float pairwise = sum (v, pairwise_summation<> ());
+    float compensated = sum (v, compensated_summation<> ());
+    double widened = sum (v, naive_summation<double> ());
+    BOOST_UBLAS_TEST_CHECK (std::abs (pairwise - exact) < 1e-5 * exact);
+    BOOST_UBLAS_TEST_CHECK (std::abs (compensated - exact) < 1e-7 * exact);
+    BOOST_UBLAS_TEST_CHECK (std::abs (widened - exact) < 1e-9 * exact);
+    BOOST_UBLAS_TEST_CHECK (std::abs (mean (v, pairwise_summation<double> ()) - double (0.1f)) < 1e-12);
+
+    // Cancellation defeats the plain sum but not the compensated one
+    vector<double> c (3);
+    c (0) = 1.0;
+    c (1) = 1e100;
+    c (2) = -1e100;
+    BOOST_UBLAS_TEST_CHECK (sum (c) == 0 && sum (c, compensated_summation<> ()) == 1.0);
+
+    matrix<float> m (1000, 1000, 0.1f);
+    matrix<float, column_major> cm (1000, 1000, 0.1f);
+    BOOST_UBLAS_TEST_CHECK (std::abs (sum (m, pairwise_summation<> ()) - exact) < 1e-5 * exact);
+    BOOST_UBLAS_TEST_CHECK (std::abs (mean (cm, compensated_summation<double> ()) - double (0.1f)) < 1e-12);
+}
+
+BOOST_UBLAS_TEST_DEF (test_weighted_stats) {
+    BOOST_UBLAS_DEBUG_TRACE("Weighted Stats");
+
+    // Integral weights act as repetition counts of the elements
+    const unsigned int n = 200, nvars = 3;
+    vector<double> v1 (n), v2 (n), w (n);
+    matrix<double> m (nvars, n);
+    std::vector<double> r1, r2;
+    for (unsigned int i = 0; i < n; ++ i) {
+        v1 (i) = double ((i * 37) % 101) / 7.;
+        v2 (i) = double ((i * 53) % 89) / 3. - 10.;
+        w (i) = double ((i * 11) % 5);
+        for (unsigned int j = 0; j < nvars; ++ j)
+            m (j, i) = double ((i * (j + 3) * 7) % 23) - double (j);
+        for (unsigned int k = 0; k < w (i); ++ k) {
+            r1.push_back (v1 (i));
+            r2.push_back (v2 (i));
+        }
+    }
+    unsigned int size = r1.size ();
+    vector<double> e1 (size), e2 (size);
+    matrix<double> em (nvars, size);
+    for (unsigned int i = 0, k = 0; i < n; ++ i)
+        for (unsigned int c = 0; c < w (i); ++ c, ++ k) {
+            e1 (k) = v1 (i);
+            e2 (k) = v2 (i);
+            column (em, k) = column (m, i);
+        }
+    BOOST_UBLAS_TEST_CHECK (std::abs (mean (v1, w) - mean (e1)) < TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (variance (v1, w) - variance (e1)) < TOL);
+    double cov = inner_prod (e1 - scalar_vector<double> (size, mean (e1)), e2 - scalar_vector<double> (size, mean (e2))) / size;
+    BOOST_UBLAS_TEST_CHECK (std::abs (covariance (v1, v2, w) - cov) < TOL);
+
+    std::sort (r1.begin (), r1.end ());
+    double qs [] = {0., 0.1, 0.25, 0.5, 0.9, 1.};
+    for (unsigned int k = 0; k < 6; ++ k) {
+        unsigned int rank (std::ceil (qs [k] * size));
+        BOOST_UBLAS_TEST_CHECK (quantile (v1, w, qs [k]) == r1 [rank > 0 ? rank - 1 : 0]);
+    }
+
+    symmetric_matrix<double, lower> c (covariance_matrix (m, w));
+    symmetric_matrix<double, lower> ce (covariance_matrix (em));
+    matrix<double> mt (trans (m));
+    symmetric_matrix<double, lower> ct (covariance_matrix (mt, w, false));
+    int _fail = 0;
+    for (unsigned int i = 0; i < nvars; ++ i)
+        for (unsigned int j = 0; j <= i; ++ j)
+            if (std::abs (c (i, j) - ce (i, j)) > TOL || std::abs (ct (i, j) - ce (i, j)) > TOL)
+                _fail = 1;
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+BOOST_UBLAS_TEST_DEF (test_group_reduce) {
+    BOOST_UBLAS_DEBUG_TRACE("Group Reduce");
+
+    // Small range integral keys, keys spread over a large range and
+    // floating point keys take the three numbering paths
+    const unsigned int n = 500, size2 = 4;
+    vector<double> v (n);
+    vector<int> small (n), spread (n);
+    vector<double> real (n);
+    matrix<double> m (n, size2);
+    matrix<double, column_major> cm (n, size2);
+    for (unsigned int i = 0; i < n; ++ i) {
+        v (i) = double ((i * 37) % 101) / 7. - 5.;
+        small (i) = int ((i * 13) % 7) - 3;
+        spread (i) = int ((i * 13) % 7) * 1000003;
+        real (i) = double ((i * 13) % 7) / 4.;
+        for (unsigned int j = 0; j < size2; ++ j)
+            cm (i, j) = m (i, j) = double ((i * (j + 3) * 7) % 23) - double (j);
+    }
+
+    group_index<int> g (small);
+    BOOST_UBLAS_TEST_CHECK (g.groups () == 7 && g.keys () [0] == -3 && g.keys () [6] == 3);
+    vector<double> s (group_reduce (v, small, group_sum_tag ()));
+    vector<double> mu (group_reduce (v, g, group_mean_tag ()));
+    vector<double> var (group_reduce (v, g, group_variance_tag ()));
+    vector<double> lo (group_reduce (v, g, group_min_tag ()));
+    vector<double> hi (group_reduce (v, g, group_max_tag ()));
+    vector<double> c (group_reduce (v, g, group_count_tag ()));
+    int _fail = 0;
+    for (unsigned int k = 0; k < g.groups (); ++ k) {
+        std::vector<double> x;
+        for (unsigned int i = 0; i < n; ++ i)
+            if (small (i) == g.keys () [k])
+                x.push_back (v (i));
+        vector<double> xv (x.size ());
+        std::copy (x.begin (), x.end (), xv.begin ());
+        if (std::abs (s (k) - sum (xv)) > TOL || std::abs (mu (k) - mean (xv)) > TOL ||
+            std::abs (var (k) - variance (xv)) > TOL || lo (k) != min (xv) || hi (k) != max (xv) || c (k) != x.size ())
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+    BOOST_UBLAS_TEST_CHECK (norm_inf (group_reduce (v, spread, group_mean_tag ()) - mu) < TOL);
+    BOOST_UBLAS_TEST_CHECK (norm_inf (group_reduce (v, real, group_mean_tag ()) - mu) < TOL);
+
+    matrix<double> mm (group_reduce (m, small, group_mean_tag ()));
+    matrix<double> cmm (group_reduce (cm, g, group_mean_tag ()));
+    BOOST_UBLAS_TEST_CHECK (mm.size1 () == 7 && mm.size2 () == size2);
+    for (unsigned int j = 0; j < size2; ++ j) {
+        vector<double> col (column (m, j));
+        if (norm_inf (column (mm, j) - group_reduce (col, g, group_mean_tag ())) > TOL ||
+            norm_inf (column (cmm, j) - column (mm, j)) > TOL)
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+// Kendall's tau-b over all pairs
+template<class V>
+double brute_force_kendall (const V &x, const V &y) {
+    double concordance = 0, x_pairs = 0, y_pairs = 0;
+    for (unsigned int i = 0; i < x.size (); ++ i)
+        for (unsigned int j = i + 1; j < x.size (); ++ j) {
+            double dx = x (i) < x (j) ? 1 : (x (j) < x (i) ? -1 : 0);
+            double dy = y (i) < y (j) ? 1 : (y (j) < y (i) ? -1 : 0);
+            concordance += dx * dy;
+            x_pairs += dx * dx;
+            y_pairs += dy * dy;
+        }
+    return concordance / std::sqrt (x_pairs * y_pairs);
+}
+
+BOOST_UBLAS_TEST_DEF (test_rank_stats) {
+    BOOST_UBLAS_DEBUG_TRACE("Rank Statistics");
+
+    vector<int> v (6);
+    v (0) = 3; v (1) = -1; v (2) = 3; v (3) = 7; v (4) = -5; v (5) = 3;
+    vector<std::size_t> order (argsort (v));
+    BOOST_UBLAS_TEST_CHECK (order (0) == 4 && order (1) == 1 && order (2) == 0 && order (3) == 2 && order (4) == 5 && order (5) == 3);
+    vector<double> r (rank (v));
+    BOOST_UBLAS_TEST_CHECK (r (0) == 4 && r (1) == 2 && r (2) == 4 && r (3) == 6 && r (4) == 1 && r (5) == 4);
+
+    // Ties in both variables
+    const unsigned int n = 300, nvars = 4;
+    matrix<double> m (n, nvars);
+    for (unsigned int i = 0; i < n; ++ i)
+        for (unsigned int j = 0; j < nvars; ++ j)
+            m (i, j) = double ((i * (j + 3) * 7 + j * i * i) % (17 + 13 * j)) - double (5 * j);
+    vector<double> x (column (m, 0)), y (column (m, 2));
+    BOOST_UBLAS_TEST_CHECK (std::abs (spearman (x, y) - correlation (rank (x), rank (y))) < TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (kendall (x, y) - brute_force_kendall (x, y)) < TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (kendall (x, x) - 1.) < TOL && std::abs (spearman (x, -x) + 1.) < TOL);
+
+    symmetric_matrix<double, lower> s (spearman_matrix (m, false));
+    matrix<double> mt (trans (m));
+    symmetric_matrix<double, lower> st (spearman_matrix (mt));
+    int _fail = 0;
+    for (unsigned int i = 0; i < nvars; ++ i)
+        for (unsigned int j = 0; j <= i; ++ j) {
+            double expected = spearman (column (m, i), column (m, j));
+            if (std::abs (s (i, j) - expected) > TOL || std::abs (st (i, j) - expected) > TOL)
+                _fail = 1;
+        }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+// Median of a sorted copy, by value
+double sorted_median (std::vector<double> x) {
+    std::sort (x.begin (), x.end ());
+    unsigned int n = x.size ();
+    return n % 2 ? x [n / 2] : (x [n / 2 - 1] + x [n / 2]) / 2;
+}
+
+BOOST_UBLAS_TEST_DEF (test_robust_stats) {
+    BOOST_UBLAS_DEBUG_TRACE("Robust Statistics");
+
+    const unsigned int n = 101, size2 = 5;
+    vector<double> v (n);
+    matrix<double> m (n, size2);
+    matrix<double, column_major> cm (n, size2);
+    for (unsigned int i = 0; i < n; ++ i) {
+        v (i) = double ((i * 37) % 53) - 20.;
+        for (unsigned int j = 0; j < size2; ++ j)
+            cm (i, j) = m (i, j) = double ((i * (j + 3) * 7) % (23 + j)) - double (4 * j);
+    }
+    v (3) = 1e6;
+    v (7) = -1e6;
+
+    std::vector<double> x (v.begin (), v.end ());
+    std::vector<double> s (x);
+    std::sort (s.begin (), s.end ());
+    double center = sorted_median (x);
+    std::vector<double> dev (n);
+    for (unsigned int i = 0; i < n; ++ i)
+        dev [i] = std::abs (x [i] - center);
+    BOOST_UBLAS_TEST_CHECK (mad (v) == sorted_median (dev));
+    // Ranks 25 and 75 of 101 are exact quartiles
+    BOOST_UBLAS_TEST_CHECK (iqr (v) == s [75] - s [25]);
+    double trimmed = 0;
+    for (unsigned int i = 10; i < n - 10; ++ i)
+        trimmed += s [i];
+    BOOST_UBLAS_TEST_CHECK (std::abs (trimmed_mean (v, 0.1) - trimmed / (n - 20)) < TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (trimmed_mean (v, 0.) - mean (v)) < TOL);
+    vector<double> w (winsorize (v, 0.05, 0.1));
+    int _fail = 0;
+    for (unsigned int i = 0; i < n; ++ i)
+        if (w (i) != std::min (std::max (v (i), s [5]), s [n - 1 - 10]))
+            _fail = 1;
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    vector<double> mads (mad (m, 0)), iqrs (iqr (cm, 0)), trims (trimmed_mean (m, 0.2, 0));
+    matrix<double> wm (winsorize (cm, 0.1, 0.1, 0));
+    for (unsigned int j = 0; j < size2; ++ j) {
+        vector<double> col (column (m, j));
+        if (mads (j) != mad (col) || iqrs (j) != iqr (col) || trims (j) != trimmed_mean (col, 0.2) ||
+            norm_inf (column (wm, j) - winsorize (col, 0.1, 0.1)) != 0)
+            _fail = 1;
+    }
+    vector<double> row_mads (mad (m, 1));
+    matrix<double> wr (winsorize (m, 0.2, 0., 1));
+    for (unsigned int i = 0; i < n; ++ i) {
+        vector<double> r (row (m, i));
+        if (row_mads (i) != mad (r) || norm_inf (row (wr, i) - winsorize (r, 0.2, 0.)) != 0)
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+// Copy of the elements of v that are not NaN
+vector<double> drop_nans (const vector<double> &v) {
+    std::vector<double> x;
+    for (unsigned int i = 0; i < v.size (); ++ i)
+        if (v (i) == v (i))
+            x.push_back (v (i));
+    vector<double> r (x.size ());
+    std::copy (x.begin (), x.end (), r.begin ());
+    return r;
+}
+
+BOOST_UBLAS_TEST_DEF (test_nan_stats) {
+    BOOST_UBLAS_DEBUG_TRACE("NaN Skipping Statistics");
+
+    const double nan = std::numeric_limits<double>::quiet_NaN ();
+    const unsigned int n = 203, size2 = 9;
+    vector<double> v (n);
+    matrix<double> m (n, size2);
+    matrix<double, column_major> cm (n, size2);
+    for (unsigned int i = 0; i < n; ++ i) {
+        v (i) = i % 5 == 2 ? nan : double ((i * 37) % 53) - 20.5;
+        for (unsigned int j = 0; j < size2; ++ j)
+            cm (i, j) = m (i, j) = (i * (j + 1)) % 7 == 3 || j == 4 ? nan : double ((i * (j + 3) * 7) % (23 + j)) - double (4 * j);
+    }
+
+    vector<double> c (drop_nans (v));
+    BOOST_UBLAS_TEST_CHECK (std::abs (nanmean (v) - mean (c)) < TOL);
+    BOOST_UBLAS_TEST_CHECK (std::abs (nanvar (v) - variance (c)) < TOL);
+    BOOST_UBLAS_TEST_CHECK (nanmin (v) == min (c) && nanmax (v) == max (c));
+    BOOST_UBLAS_TEST_CHECK (nanmedian (v) == median (c));
+    vector<double> all_nan (17, nan);
+    BOOST_UBLAS_TEST_CHECK (nanmean (all_nan) != nanmean (all_nan) && nanvar (all_nan) != nanvar (all_nan));
+    BOOST_UBLAS_TEST_CHECK (nanmin (all_nan) != nanmin (all_nan) && nanmedian (all_nan) != nanmedian (all_nan));
+    vector<float> f (n);
+    for (unsigned int i = 0; i < n; ++ i)
+        f (i) = i % 3 ? float (i % 11) : std::numeric_limits<float>::quiet_NaN ();
+    BOOST_UBLAS_TEST_CHECK (std::abs (nanmean (f) - 5.f) < 0.1f);
+
+    int _fail = 0;
+    for (unsigned int axis = 0; axis < 2; ++ axis) {
+        unsigned int size = axis == 0 ? size2 : n;
+        vector<double> means (nanmean (m, axis)), vars (nanvar (cm, axis)), mins (nanmin (m, axis)),
+                       maxs (nanmax (cm, axis)), medians (nanmedian (m, axis)), cmeans (nanmean (cm, axis)),
+                       mvars (nanvar (m, axis));
+        if (means.size () != size || vars.size () != size)
+            _fail = 1;
+        for (unsigned int k = 0; k < size; ++ k) {
+            vector<double> s (axis == 0 ? vector<double> (column (m, k)) : vector<double> (row (m, k)));
+            vector<double> x (drop_nans (s));
+            if (x.size () == 0) {
+                if (means (k) == means (k) || vars (k) == vars (k) || mins (k) == mins (k) || medians (k) == medians (k))
+                    _fail = 1;
+                continue;
+            }
+            if (std::abs (means (k) - mean (x)) > TOL || std::abs (cmeans (k) - mean (x)) > TOL ||
+                std::abs (vars (k) - variance (x)) > TOL || std::abs (mvars (k) - variance (x)) > TOL ||
+                mins (k) != min (x) || maxs (k) != max (x) || medians (k) != median (x))
+                _fail = 1;
+        }
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+}
+
+BOOST_UBLAS_TEST_DEF (test_axis_transforms) {
+    BOOST_UBLAS_DEBUG_TRACE("Axis Transforms");
+
+    const unsigned int size1 = 37, size2 = 6;
+    matrix<double> m (size1, size2);
+    mapped_matrix<double> sm (size1, size2);
+    for (unsigned int i = 0; i < size1; ++ i)
+        for (unsigned int j = 0; j < size2; ++ j) {
+            m (i, j) = j == 2 ? 3.5 : double ((i * (j + 3) * 7) % (23 + j)) - double (4 * j);
+            if ((i + j) % 3 == 0)
+                sm (i, j) = m (i, j);
+        }
+
+    int _fail = 0;
+    for (unsigned int axis = 0; axis < 2; ++ axis) {
+        unsigned int size (axis == 0 ? size2 : size1);
+        matrix<double> c (m), z (m), s (m);
+        matrix<double, column_major> cz (m);
+        center (c, axis);
+        zscore (z, axis);
+        zscore (cz, axis);
+        min_max_scale (s, axis);
+        for (unsigned int k = 0; k < size; ++ k) {
+            vector<double> v (axis == 0 ? vector<double> (column (m, k)) : vector<double> (row (m, k)));
+            vector<double> cv (axis == 0 ? vector<double> (column (c, k)) : vector<double> (row (c, k)));
+            vector<double> zv (axis == 0 ? vector<double> (column (z, k)) : vector<double> (row (z, k)));
+            vector<double> czv (axis == 0 ? vector<double> (column (cz, k)) : vector<double> (row (cz, k)));
+            vector<double> sv (axis == 0 ? vector<double> (column (s, k)) : vector<double> (row (s, k)));
+            double mu (mean (v)), sd (std::sqrt (variance (v)));
+            double lo (*std::min_element (v.begin (), v.end ())), hi (*std::max_element (v.begin (), v.end ()));
+            for (unsigned int i = 0; i < v.size (); ++ i)
+                if (std::abs (cv (i) - (v (i) - mu)) > TOL ||
+                    std::abs (zv (i) - (sd > 0 ? (v (i) - mu) / sd : 0.)) > TOL || std::abs (czv (i) - zv (i)) > TOL ||
+                    std::abs (sv (i) - (hi > lo ? (v (i) - lo) / (hi - lo) : 0.)) > TOL)
+                    _fail = 1;
+        }
+
+        matrix<double> d (sm);
+        mapped_matrix<double> st (sm);
+        min_max_scale (d, axis);
+        min_max_scale (st, axis);
+        if (norm_inf (matrix<double> (st) - d) > TOL)
+            _fail = 1;
+
+        // Ranges of dense and sparse matrices are transformed in place
+        matrix<double> r (m), rz (subrange (m, 3, 20, 1, 5));
+        mapped_matrix<double> sr (sm);
+        matrix<double> srz (subrange (sm, 3, 20, 1, 5));
+        matrix_range<matrix<double> > rr (r, range (3, 20), range (1, 5));
+        matrix_range<mapped_matrix<double> > srr (sr, range (3, 20), range (1, 5));
+        zscore (rr, axis);
+        zscore (rz, axis);
+        zscore (srr, axis);
+        zscore (srz, axis);
+        if (norm_inf (matrix<double> (rr) - rz) > TOL || norm_inf (matrix<double> (srr) - srz) > TOL ||
+            r (0, 0) != m (0, 0) || sr (2, 2) != sm (2, 2))
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // Packed storage is rejected; transform a dense copy instead
+    BOOST_UBLAS_TEST_CHECK ((axis_transform_storage<matrix<double>::storage_category>::value));
+    BOOST_UBLAS_TEST_CHECK ((axis_transform_storage<matrix_range<mapped_matrix<double> >::storage_category>::value));
+    BOOST_UBLAS_TEST_CHECK ((! axis_transform_storage<symmetric_matrix<double>::storage_category>::value));
+    BOOST_UBLAS_TEST_CHECK ((! axis_transform_storage<triangular_matrix<double>::storage_category>::value));
+    BOOST_UBLAS_TEST_CHECK ((! axis_transform_storage<symmetric_adaptor<matrix<double> >::storage_category>::value));
+}
+
 int main() {
     
     BOOST_UBLAS_TEST_SUITE("Basic Stats Test Suite");
@@ -590,9 +1784,30 @@ int main() {
         BOOST_UBLAS_TEST_DO( test_mean );
         BOOST_UBLAS_TEST_DO( test_mode );
         BOOST_UBLAS_TEST_DO( test_median );
+        BOOST_UBLAS_TEST_DO( test_median_selection );
+        BOOST_UBLAS_TEST_DO( test_quantile );
         BOOST_UBLAS_TEST_DO( test_variance );
+        BOOST_UBLAS_TEST_DO( test_axis_storage_orders );
+        BOOST_UBLAS_TEST_DO( test_chunked_reductions );
+        BOOST_UBLAS_TEST_DO( test_sparse_stats );
+        BOOST_UBLAS_TEST_DO( test_describe );
         BOOST_UBLAS_TEST_DO( test_vector_covariance );
         BOOST_UBLAS_TEST_DO( test_covariance_matrix );
+        BOOST_UBLAS_TEST_DO( test_covariance_matrix_blocked );
+        BOOST_UBLAS_TEST_DO( test_correlation );
+        BOOST_UBLAS_TEST_DO( test_running_stats );
+        BOOST_UBLAS_TEST_DO( test_quantile_sketch );
+        BOOST_UBLAS_TEST_DO( test_mode_engines );
+        BOOST_UBLAS_TEST_DO( test_rolling_stats );
+        BOOST_UBLAS_TEST_DO( test_ewm );
+        BOOST_UBLAS_TEST_DO( test_higher_moments );
+        BOOST_UBLAS_TEST_DO( test_summation_policies );
+        BOOST_UBLAS_TEST_DO( test_weighted_stats );
+        BOOST_UBLAS_TEST_DO( test_group_reduce );
+        BOOST_UBLAS_TEST_DO( test_rank_stats );
+        BOOST_UBLAS_TEST_DO( test_robust_stats );
+        BOOST_UBLAS_TEST_DO( test_nan_stats );
+        BOOST_UBLAS_TEST_DO( test_axis_transforms );
     BOOST_UBLAS_TEST_END();
 
     return 0;
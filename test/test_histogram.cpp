@@ -1,7 +1,10 @@
+#include <limits>
 #include <string>
 
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
 #include <boost/numeric/ublas/histogram.hpp>
 #include <boost/numeric/ublas/io.hpp>
 
@@ -112,6 +115,214 @@ BOOST_UBLAS_TEST_DEF (test_histogram_custom_binedges) {
     BOOST_UBLAS_TEST_CHECK (_fail == 0);
 }
 
+BOOST_UBLAS_TEST_DEF (test_histogram_edge_search) {
+    BOOST_UBLAS_DEBUG_TRACE("Histogram by edge search on proxies");
+
+    // Uniform edges take the direct index path, the perturbed ones the
+    // binary search; both must agree with a linear scan over the edges.
+    vector<double> uniform (9), perturbed (9);
+    for (unsigned int i = 0; i < 9; ++ i) {
+        uniform (i) = -2.0 + 0.5 * i;
+        perturbed (i) = uniform (i) + (i == 4 ? 0.3 : 0.0);
+    }
+    matrix<double> m (3, 60);
+    for (unsigned int i = 0; i < 3; ++ i)
+        for (unsigned int j = 0; j < 60; ++ j)
+            m (i, j) = ((i * 60 + j) * 7919 % 53) * 0.1 - 2.6;
+    m (1, 7) = -2.0;
+    m (1, 8) = 2.0;
+    m (1, 9) = -0.5;
+
+    int _fail = 0;
+    for (unsigned int e = 0; e < 2; ++ e) {
+        const vector<double> &edges = e == 0 ? uniform : perturbed;
+        for (unsigned int i = 0; i < 3; ++ i) {
+            vector<int> hist = histogram (row (m, i), edges);
+            vector<int> gt (8);
+            gt.clear ();
+            for (unsigned int j = 0; j < 60; ++ j) {
+                double x = m (i, j);
+                for (unsigned int b = 0; b < 8; ++ b)
+                    if (edges (b) <= x && (x < edges (b + 1) || (b == 7 && x <= edges (8)))) {
+                        gt (b) += 1;
+                        break;
+                    }
+            }
+            for (unsigned int b = 0; b < 8; ++ b)
+                if (hist (b) != gt (b))
+                    _fail = 1;
+        }
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // Values below the first edge are not counted in the first bin
+    vector<double> below (3);
+    below (0) = -3.0;
+    below (1) = -2.0;
+    below (2) = -1.9;
+    vector<int> hist = histogram (below, uniform);
+    BOOST_UBLAS_TEST_CHECK (hist (0) == 2);
+}
+
+BOOST_UBLAS_TEST_DEF (test_histogram_uniform_bins) {
+    BOOST_UBLAS_DEBUG_TRACE("Histogram with uniform bins over the value range");
+
+    // Negative values, a contiguous vector and a strided column, double and
+    // float, against a direct count
+    matrix<double> m (97, 2);
+    vector<float> f (97);
+    for (unsigned int i = 0; i < 97; ++ i) {
+        m (i, 0) = ((i * 7919) % 41) * 0.5 - 12.0;
+        m (i, 1) = 0;
+        f (i) = float (m (i, 0));
+    }
+    vector<double> v (column (m, 0));
+
+    vector<boost::uint64_t> hist = histogram (v, 7);
+    vector<boost::uint64_t> hist_column = histogram (column (m, 0), 7);
+    vector<boost::uint64_t> hist_float = histogram (f, 7);
+    BOOST_UBLAS_TEST_CHECK (hist.size () == 7);
+    int _fail = 0;
+    boost::uint64_t total = 0;
+    for (unsigned int b = 0; b < 7; ++ b) {
+        boost::uint64_t gt = 0;
+        for (unsigned int i = 0; i < 97; ++ i) {
+            unsigned int k = (unsigned int) ((v (i) + 12.0) / (20.0 / 7) + TOLER);
+            gt += (k < 7 ? k : 6) == b;
+        }
+        if (hist (b) != gt || hist_column (b) != gt || hist_float (b) != gt)
+            _fail = 1;
+        total += hist (b);
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+    BOOST_UBLAS_TEST_CHECK (total == 97);
+
+    // NaNs are not counted by any form, and constant data lands in the
+    // middle bin as in the axis form
+    const double nan = std::numeric_limits<double>::quiet_NaN ();
+    vector<double> gaps (5);
+    for (unsigned int i = 0; i < 5; ++ i)
+        gaps (i) = i;
+    gaps (2) = nan;
+    vector<boost::uint64_t> hg = histogram (gaps, 2);
+    BOOST_UBLAS_TEST_CHECK (hg (0) == 2 && hg (1) == 2);
+    vector<double> long_gaps (v);
+    for (unsigned int i = 0; i < 97; i += 5)
+        long_gaps (i) = nan;
+    vector<boost::uint64_t> hl = histogram (long_gaps, 7);
+    matrix<boost::uint64_t> hm = histogram (matrix<double> (outer_prod (long_gaps, scalar_vector<double> (1, 1.0))), 7, 0);
+    matrix<boost::uint64_t> hj = histogram2d (long_gaps, v, 7, 1);
+    _fail = 0;
+    total = 0;
+    for (unsigned int b = 0; b < 7; ++ b) {
+        total += hl (b);
+        if (hm (b, 0) != hl (b) || hj (b, 0) != hl (b))
+            _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0 && total == 97 - 20);
+    vector<boost::uint64_t> hc = histogram (vector<double> (6, 2.0), 4);
+    BOOST_UBLAS_TEST_CHECK (hc (2) == 6 && hc (0) + hc (1) + hc (3) == 0);
+}
+
+BOOST_UBLAS_TEST_DEF (test_histogram_axis_and_joint) {
+    BOOST_UBLAS_DEBUG_TRACE("Per-axis and joint histograms");
+
+    matrix<double> m (40, 3);
+    for (unsigned int i = 0; i < 40; ++ i)
+        for (unsigned int j = 0; j < 3; ++ j)
+            m (i, j) = ((i * 7919 + j * 31) % 17) * (j + 1.0) - 5.0 * j;
+
+    // Every column and row against the vector histogram of its copy
+    int _fail = 0;
+    matrix<boost::uint64_t> h0 = histogram (m, 4, 0);
+    matrix<boost::uint64_t> h1 = histogram (matrix<double, column_major> (m), 4, 1);
+    BOOST_UBLAS_TEST_CHECK (h0.size1 () == 4 && h0.size2 () == 3 && h1.size2 () == 40);
+    for (unsigned int j = 0; j < 3; ++ j) {
+        vector<boost::uint64_t> gt = histogram (vector<double> (column (m, j)), 4);
+        for (unsigned int b = 0; b < 4; ++ b)
+            if (h0 (b, j) != gt (b))
+                _fail = 1;
+    }
+    for (unsigned int i = 0; i < 40; ++ i) {
+        vector<boost::uint64_t> gt = histogram (vector<double> (row (m, i)), 4);
+        for (unsigned int b = 0; b < 4; ++ b)
+            if (h1 (b, i) != gt (b))
+                _fail = 1;
+    }
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // Implicit zeros of a sparse matrix are counted
+    compressed_matrix<double> s (6, 2);
+    s (1, 0) = 4.0;
+    s (4, 0) = -4.0;
+    s (2, 1) = 3.0;
+    matrix<boost::uint64_t> hs = histogram (s, 2, 0);
+    BOOST_UBLAS_TEST_CHECK (hs (0, 0) == 1 && hs (1, 0) == 5);
+    BOOST_UBLAS_TEST_CHECK (hs (0, 1) == 5 && hs (1, 1) == 1);
+
+    // Joint histograms against direct counts
+    vector<double> x (column (m, 0)), y (column (m, 2));
+    matrix<boost::uint64_t> h2 = histogram2d (x, y, 3, 5);
+    vector<boost::uint64_t> hd = histogramdd (m, 3);
+    vector<double> x_edges (3), y_edges (3);
+    x_edges (0) = 0.0;
+    x_edges (1) = 8.0;
+    x_edges (2) = 16.0;
+    y_edges (0) = -10.0;
+    y_edges (1) = 0.0;
+    y_edges (2) = 20.0;
+    matrix<boost::uint64_t> he = histogram2d (x, y, x_edges, y_edges);
+    BOOST_UBLAS_TEST_CHECK (h2.size1 () == 3 && h2.size2 () == 5 && hd.size () == 27);
+    double lo [3] = {0.0, -5.0, -10.0};
+    double width [3] = {16.0 / 3, 32.0 / 3, 48.0 / 3};
+    matrix<boost::uint64_t> gt2 (3, 5), gte (2, 2);
+    vector<boost::uint64_t> gtd (27);
+    gt2.clear ();
+    gte.clear ();
+    gtd.clear ();
+    for (unsigned int i = 0; i < 40; ++ i) {
+        unsigned int b [3];
+        for (unsigned int j = 0; j < 3; ++ j) {
+            b [j] = (unsigned int) ((m (i, j) - lo [j]) / width [j] + TOLER);
+            b [j] = b [j] < 3 ? b [j] : 2;
+        }
+        unsigned int by = (unsigned int) ((y (i) + 10.0) / (48.0 / 5) + TOLER);
+        gt2 (b [0], by < 5 ? by : 4) += 1;
+        gtd (b [0] * 9 + b [1] * 3 + b [2]) += 1;
+        if (y (i) <= 20.0)
+            gte (x (i) < 8.0 ? 0 : 1, y (i) < 0.0 ? 0 : 1) += 1;
+    }
+    _fail = 0;
+    for (unsigned int i = 0; i < 3; ++ i)
+        for (unsigned int j = 0; j < 5; ++ j)
+            if (h2 (i, j) != gt2 (i, j))
+                _fail = 1;
+    for (unsigned int k = 0; k < 27; ++ k)
+        if (hd (k) != gtd (k))
+            _fail = 1;
+    for (unsigned int i = 0; i < 2; ++ i)
+        for (unsigned int j = 0; j < 2; ++ j)
+            if (he (i, j) != gte (i, j))
+                _fail = 1;
+    BOOST_UBLAS_TEST_CHECK (_fail == 0);
+
+    // A constant column is widened to [c - 0.5, c + 0.5] and falls in the middle bin
+    matrix<double> c (m);
+    column (c, 1) = scalar_vector<double> (40, 2.0);
+    matrix<boost::uint64_t> hc = histogram (c, 4, 0);
+    BOOST_UBLAS_TEST_CHECK (hc (2, 1) == 40 && hc (0, 1) + hc (1, 1) + hc (3, 1) == 0);
+
+    // Joint histograms of more than BOOST_UBLAS_HISTOGRAM_MAX_BINS counts are refused
+    bool refused = false;
+    try {
+        histogramdd (matrix<double> (4, 10, 1.0), 1000);
+    }
+    catch (const bad_size &) {
+        refused = true;
+    }
+    BOOST_UBLAS_TEST_CHECK (refused);
+}
+
 int main() {
     
     BOOST_UBLAS_TEST_SUITE("Histogram Test Suite");
@@ -119,6 +330,9 @@ int main() {
     BOOST_UBLAS_TEST_BEGIN();
         BOOST_UBLAS_TEST_DO( test_histogram_fixed_nbins );
         BOOST_UBLAS_TEST_DO( test_histogram_custom_binedges );
+        BOOST_UBLAS_TEST_DO( test_histogram_edge_search );
+        BOOST_UBLAS_TEST_DO( test_histogram_uniform_bins );
+        BOOST_UBLAS_TEST_DO( test_histogram_axis_and_joint );
     BOOST_UBLAS_TEST_END();
 
     return 0;